@@ -53,6 +53,7 @@ gridtools_functions = ((
 gridtools_macros = ((
 	'GT_FUNCTION',
     'GT_DECLARE_TMP',
+    'GT_DECLARE_TMP_WITH_POLICY',
     'GT_DECLARE_EXPANDABLE_TMP',
 ))
 
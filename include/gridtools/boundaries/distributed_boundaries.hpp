@@ -18,6 +18,7 @@
 #include <utility>
 
 #include "../common/halo_descriptor.hpp"
+#include "../common/profiling.hpp"
 #include "../common/timer/timer.hpp"
 #include "../gcl/halo_exchange.hpp"
 #include "bound_bc.hpp"
@@ -141,6 +142,7 @@ namespace gridtools {
             template <typename... Jobs>
             void boundary_only(Jobs const &... jobs) {
                 using execute_in_order = int[];
+                GT_PROFILING_REGION("boundary conditions");
                 m_meter_bc.start();
                 (void)execute_in_order{(apply_boundary(jobs), 0)...};
                 m_meter_bc.pause();
@@ -166,16 +168,27 @@ namespace gridtools {
                     throw std::runtime_error(err);
                 }
 
-                m_meter_pack.start();
-                call_pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
-                m_meter_pack.pause();
-                m_meter_exchange.start();
-                m_he->exchange();
-                m_meter_exchange.pause();
-                m_meter_pack.start();
-                call_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
-                m_meter_pack.pause();
-
+                {
+                    GT_PROFILING_REGION("halo exchange");
+                    {
+                        GT_PROFILING_REGION("pack");
+                        m_meter_pack.start();
+                        call_pack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+                        m_meter_pack.pause();
+                    }
+                    {
+                        GT_PROFILING_REGION("exchange");
+                        m_meter_exchange.start();
+                        m_he->exchange();
+                        m_meter_exchange.pause();
+                    }
+                    {
+                        GT_PROFILING_REGION("unpack");
+                        m_meter_pack.start();
+                        call_unpack(all_stores_for_exc, std::make_integer_sequence<uint_t, sizeof...(jobs)>{});
+                        m_meter_pack.pause();
+                    }
+                }
                 boundary_only(jobs...);
             }
 
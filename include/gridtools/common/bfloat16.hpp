@@ -0,0 +1,55 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "host_device.hpp"
+
+namespace gridtools {
+    /**
+     *  The storage only floating point type: the upper 16 bits of the IEEE single precision float (8 bits of exponent,
+     *  7 bits of mantissa). It is converted from `float` with rounding to nearest even and to `float` exactly.
+     *  No arithmetic is defined, the values are meant to be converted to the compute type on load (see
+     *  `sid/convert.hpp`).
+     */
+    class bfloat16 {
+        std::uint16_t m_bits;
+
+        static GT_FUNCTION std::uint32_t to_bits(float value) {
+            std::uint32_t res;
+            std::memcpy(&res, &value, sizeof(res));
+            return res;
+        }
+
+        static GT_FUNCTION float from_bits(std::uint32_t bits) {
+            float res;
+            std::memcpy(&res, &bits, sizeof(res));
+            return res;
+        }
+
+      public:
+        bfloat16() = default;
+
+        GT_FUNCTION bfloat16(float value) {
+            std::uint32_t bits = to_bits(value);
+            // NaN stays NaN: the truncation could clear all mantissa bits
+            if ((bits & 0x7fffffffu) > 0x7f800000u)
+                m_bits = std::uint16_t(bits >> 16 | 0x40);
+            else
+                m_bits = std::uint16_t((bits + 0x7fffu + (bits >> 16 & 1)) >> 16);
+        }
+
+        GT_FUNCTION operator float() const { return from_bits(std::uint32_t(m_bits) << 16); }
+
+        GT_FUNCTION std::uint16_t bits() const { return m_bits; }
+    };
+} // namespace gridtools
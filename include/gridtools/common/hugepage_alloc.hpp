@@ -10,6 +10,29 @@
 
 #pragma once
 
+/*
+ * Huge page allocator.
+ *
+ * `hugepage_alloc` allocates page aligned memory according to a `hugepage_policy`:
+ *   - `mode`: no huge pages, transparent huge pages (`madvise`) or explicitly reserved huge pages (`MAP_HUGETLB`);
+ *   - `page_size`: the size of the explicit huge pages (`hugepage_size_2m`, `hugepage_size_1g`), zero selects the
+ *     default huge page size of the system;
+ *   - `prefault`: whether the pages are faulted in at allocation instead of during the first sweep. `populate` lets
+ *     the kernel do it (`MAP_POPULATE`/`MADV_POPULATE_WRITE`), `first_touch` touches the pages in parallel to place
+ *     them on the NUMA nodes of the threads that will use them (with OpenMP or the given thread pool);
+ *   - `fallback`: whether the explicit allocation that can't be satisfied falls back to the default huge page size,
+ *     then to the transparent huge pages. Otherwise `std::bad_alloc` is thrown.
+ *
+ * Without the policy argument the default policy is used. It is read once from the environment:
+ *   GT_HUGEPAGE_MODE=disable|transparent|explicit
+ *   GT_HUGEPAGE_SIZE=2M|1G
+ *   GT_HUGEPAGE_PREFAULT=none|populate|first_touch
+ *
+ * `hugepage_usage` reports how much of an allocation is resident and how much of it is backed by the huge pages
+ * (parsed from `/proc/self/smaps`).
+ */
+
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdio>
@@ -19,8 +42,12 @@
 #include <stdexcept>
 #include <tuple>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef __linux__
-#include <cstdio>
+#include <cstdint>
 
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -29,6 +56,8 @@
 #include <unistd.h>
 #endif
 
+#include "../thread_pool/concept.hpp"
+
 namespace gridtools {
     namespace hugepage_alloc_impl_ {
         inline std::size_t ilog2(std::size_t i) {
@@ -38,8 +67,47 @@ namespace gridtools {
             return log;
         }
 
+        inline std::size_t round_up(std::size_t size, std::size_t align) { return (size + align - 1) / align * align; }
+
         enum class hugepage_mode { disabled, transparent, explicit_allocation };
 
+        enum class hugepage_prefault { none, populate, first_touch };
+
+        constexpr std::size_t hugepage_size_2m = std::size_t(1) << 21;
+        constexpr std::size_t hugepage_size_1g = std::size_t(1) << 30;
+
+        struct hugepage_policy {
+            hugepage_mode mode = hugepage_mode::transparent;
+            std::size_t page_size = 0;
+            hugepage_prefault prefault = hugepage_prefault::none;
+            bool fallback = true;
+        };
+
+        /**
+         * @brief Statistics of the allocation: the allocated, the resident and the huge page backed bytes.
+         */
+        struct hugepage_usage_info {
+            std::size_t bytes;
+            std::size_t resident_bytes;
+            std::size_t huge_bytes;
+            hugepage_mode mode;
+            std::size_t page_size;
+        };
+
+        struct ptr_metadata {
+            std::size_t offset, full_size;
+            hugepage_mode mode;
+            std::size_t page_size;
+        };
+
+        // the result of the low level allocation: the mode and the page size are the ones that were actually used
+        struct allocation {
+            void *ptr;
+            std::size_t size;
+            hugepage_mode mode;
+            std::size_t page_size;
+        };
+
 #ifdef __linux__
         inline std::size_t get_sysinfo(const char *info, std::size_t default_value) {
             int fd = open(info, O_RDONLY);
@@ -90,39 +158,87 @@ namespace gridtools {
             return value;
         }
 
-        inline std::pair<void *, std::size_t> allocate(std::size_t size, hugepage_mode mode) {
+        // the transparent huge pages are PMD sized, the mapping is aligned to them to make the whole range eligible
+        inline void *map_aligned(std::size_t size, std::size_t align) {
+            void *ptr = mmap(nullptr,
+                size + align,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                -1,
+                0);
+            if (ptr == MAP_FAILED)
+                return nullptr;
+            auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+            auto head = round_up(addr, align) - addr;
+            if (head)
+                munmap(ptr, head);
+            if (align - head)
+                munmap(reinterpret_cast<char *>(addr + head + size), align - head);
+            return reinterpret_cast<char *>(addr + head);
+        }
+
+        inline void *map_hugetlb(std::size_t size, std::size_t hugepage, bool populate) {
+            // the flags encode log2 of the page size; without them the default huge page size is used
+            int size_flags = hugepage == hugepage_size() ? 0 : int(ilog2(hugepage)) << 26; // MAP_HUGE_SHIFT
+            // no MAP_NORESERVE: if there are not enough huge pages, mmap fails here instead of a bus error on access
+            void *ptr = mmap(nullptr,
+                size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | size_flags | (populate ? MAP_POPULATE : 0),
+                -1,
+                0);
+            return ptr == MAP_FAILED ? nullptr : ptr;
+        }
+
+        inline void touch_pages(void *ptr, std::size_t size) {
+            for (std::size_t i = 0; i < size; i += page_size())
+                static_cast<char volatile *>(ptr)[i] = 0;
+        }
+
+        inline void populate(void *ptr, std::size_t size) {
+#ifdef MADV_POPULATE_WRITE
+            if (!madvise(ptr, size, MADV_POPULATE_WRITE))
+                return;
+#endif
+            // older kernels: fault the pages in one by one
+            touch_pages(ptr, size);
+        }
+
+        inline allocation allocate(std::size_t size, hugepage_policy const &policy) {
             void *ptr;
-            switch (mode) {
-            case hugepage_mode::disabled:
+            if (policy.mode == hugepage_mode::disabled) {
                 // here we just align to small/normal page size
-                size = ((size + page_size() - 1) / page_size()) * page_size();
-                if (posix_memalign(&ptr, page_size(), size))
+                std::size_t full_size = round_up(size, page_size());
+                if (posix_memalign(&ptr, page_size(), full_size))
                     throw std::bad_alloc();
                 // explicitly forbid usage of huge pages
-                madvise(ptr, size, MADV_NOHUGEPAGE);
-                break;
-            case hugepage_mode::transparent:
-                // here we try to get transparent huge pages
-                size = ((size + hugepage_size() - 1) / hugepage_size()) * hugepage_size();
-                ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
-                if (ptr == MAP_FAILED)
-                    throw std::bad_alloc();
-                madvise(ptr, size, MADV_HUGEPAGE);
-                break;
-            case hugepage_mode::explicit_allocation:
-                // here we force huge page allocation (fails with a bus error if none are available)
-                size = ((size + hugepage_size() - 1) / hugepage_size()) * hugepage_size();
-                ptr = mmap(nullptr,
-                    size,
-                    PROT_READ | PROT_WRITE,
-                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_NORESERVE,
-                    -1,
-                    0);
-                if (ptr == MAP_FAILED)
+                madvise(ptr, full_size, MADV_NOHUGEPAGE);
+                if (policy.prefault == hugepage_prefault::populate)
+                    touch_pages(ptr, full_size);
+                return {ptr, full_size, hugepage_mode::disabled, page_size()};
+            }
+            if (policy.mode == hugepage_mode::explicit_allocation) {
+                // here we force huge page allocation of the requested size, then of the default size
+                bool populate = policy.prefault == hugepage_prefault::populate;
+                std::size_t hugepage = policy.page_size ? policy.page_size : hugepage_size();
+                std::size_t full_size = round_up(size, hugepage);
+                if ((ptr = map_hugetlb(full_size, hugepage, populate)))
+                    return {ptr, full_size, hugepage_mode::explicit_allocation, hugepage};
+                if (!policy.fallback)
                     throw std::bad_alloc();
-                break;
+                full_size = round_up(size, hugepage_size());
+                if (hugepage != hugepage_size() && (ptr = map_hugetlb(full_size, hugepage_size(), populate)))
+                    return {ptr, full_size, hugepage_mode::explicit_allocation, hugepage_size()};
             }
-            return {ptr, size};
+            // here we try to get transparent huge pages
+            std::size_t full_size = round_up(size, hugepage_size());
+            ptr = map_aligned(full_size, hugepage_size());
+            if (!ptr)
+                throw std::bad_alloc();
+            madvise(ptr, full_size, MADV_HUGEPAGE);
+            if (policy.prefault == hugepage_prefault::populate)
+                populate(ptr, full_size);
+            return {ptr, full_size, hugepage_mode::transparent, hugepage_size()};
         }
 
         inline void deallocate(void *ptr, std::size_t size, hugepage_mode mode) {
@@ -136,6 +252,49 @@ namespace gridtools {
                 break;
             }
         }
+
+        /**
+         * @brief Sums the resident and the huge page backed sizes of the mappings in `/proc/self/smaps` over the
+         * given address range. The mappings that only partially overlap the range are counted up to the overlap.
+         */
+        inline void smaps_usage(void const *ptr, std::size_t size, std::size_t &resident, std::size_t &huge) {
+            resident = huge = 0;
+            auto *fp = std::fopen("/proc/self/smaps", "r");
+            if (!fp)
+                return;
+            auto first = reinterpret_cast<std::uintptr_t>(ptr);
+            auto last = first + size;
+            std::size_t overlap = 0, rss = 0, hugepages = 0;
+            auto flush = [&] {
+                resident += std::min(rss, overlap);
+                huge += std::min(hugepages, overlap);
+                overlap = rss = hugepages = 0;
+            };
+            char *line = nullptr;
+            size_t line_length;
+            while (getline(&line, &line_length, fp) != -1) {
+                unsigned long start, end, kb;
+                char key[64];
+                if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+                    flush();
+                    if (start < last && end > first)
+                        overlap = std::min<std::uintptr_t>(end, last) - std::max<std::uintptr_t>(start, first);
+                } else if (overlap && sscanf(line, "%63[^:]: %lu kB", key, &kb) == 2) {
+                    if (!std::strcmp(key, "Rss"))
+                        rss += kb * 1024;
+                    else if (!std::strcmp(key, "AnonHugePages") || !std::strcmp(key, "Private_Hugetlb") ||
+                             !std::strcmp(key, "Shared_Hugetlb")) {
+                        hugepages += kb * 1024;
+                        // the hugetlb pages are not accounted in Rss
+                        if (key[0] != 'A')
+                            rss += kb * 1024;
+                    }
+                }
+            }
+            flush();
+            free(line);
+            std::fclose(fp);
+        }
 #else
         inline std::size_t cache_line_size() {
             return 64; // default value for x86-64 archs
@@ -153,16 +312,28 @@ namespace gridtools {
             return 4 * 1024; // 4kB is the default on most systems
         }
 
-        inline std::tuple<void *, std::size_t> allocate(std::size_t size, hugepage_mode) {
+        inline void touch_pages(void *ptr, std::size_t size) {
+            for (std::size_t i = 0; i < size; i += page_size())
+                static_cast<char volatile *>(ptr)[i] = 0;
+        }
+
+        inline allocation allocate(std::size_t size, hugepage_policy const &policy) {
             // here we hope that aligning to hugepage_size will return transparent huge pages
             void *ptr;
-            size = ((size + hugepage_size() - 1) / hugepage_size()) * hugepage_size();
+            size = round_up(size, hugepage_size());
             if (posix_memalign(&ptr, hugepage_size(), size))
                 throw std::bad_alloc();
-            return {ptr, size};
+            if (policy.prefault == hugepage_prefault::populate)
+                touch_pages(ptr, size);
+            return {ptr, size, hugepage_mode::disabled, page_size()};
         }
 
         inline void deallocate(void *ptr, std::size_t, hugepage_mode) { free(ptr); }
+
+        inline void smaps_usage(void const *, std::size_t size, std::size_t &resident, std::size_t &huge) {
+            resident = size;
+            huge = 0;
+        }
 #endif
 
         inline std::size_t allocation_offset() {
@@ -182,35 +353,98 @@ namespace gridtools {
             return hugepage_mode::transparent;
         }
 
-        struct ptr_metadata {
-            std::size_t offset, full_size;
-            hugepage_mode mode;
-        };
+        inline hugepage_policy hugepage_policy_from_env() {
+            hugepage_policy res;
+            res.mode = hugepage_mode_from_env();
+            if (const char *env_value = std::getenv("GT_HUGEPAGE_SIZE")) {
+                if (std::strcmp(env_value, "2M") == 0)
+                    res.page_size = hugepage_size_2m;
+                else if (std::strcmp(env_value, "1G") == 0)
+                    res.page_size = hugepage_size_1g;
+                else
+                    std::fprintf(
+                        stderr, "warning: env variable GT_HUGEPAGE_SIZE set to invalid value '%s'\n", env_value);
+            }
+            if (const char *env_value = std::getenv("GT_HUGEPAGE_PREFAULT")) {
+                if (std::strcmp(env_value, "populate") == 0)
+                    res.prefault = hugepage_prefault::populate;
+                else if (std::strcmp(env_value, "first_touch") == 0)
+                    res.prefault = hugepage_prefault::first_touch;
+                else if (std::strcmp(env_value, "none") != 0)
+                    std::fprintf(
+                        stderr, "warning: env variable GT_HUGEPAGE_PREFAULT set to invalid value '%s'\n", env_value);
+            }
+            return res;
+        }
 
+        /**
+         * @brief The policy of `hugepage_alloc` without the policy argument. It is read from the environment once.
+         */
+        inline hugepage_policy const &default_hugepage_policy() {
+            static const hugepage_policy value = hugepage_policy_from_env();
+            return value;
+        }
+
+        inline ptr_metadata &metadata(void *ptr) { return static_cast<ptr_metadata *>(ptr)[-1]; }
+
+        template <class FirstTouch>
+        void *allocate_with_offset(std::size_t size, hugepage_policy const &policy, FirstTouch &&first_touch) {
+            // get allocation offset to reduce L1 cache conflicts
+            std::size_t offset = allocation_offset();
+            assert(offset >= sizeof(ptr_metadata));
+
+            // allocate memory with additional space for offsetting
+            auto res = allocate(size + offset, policy);
+            if (policy.prefault == hugepage_prefault::first_touch)
+                first_touch(static_cast<char *>(res.ptr), res.size / page_size());
+
+            // offset pointer and write pointer metadata required for deallocation
+            void *ptr = static_cast<char *>(res.ptr) + offset;
+            metadata(ptr) = {offset, res.size, res.mode, res.page_size};
+            return ptr;
+        }
     } // namespace hugepage_alloc_impl_
 
+    using hugepage_alloc_impl_::default_hugepage_policy;
+    using hugepage_alloc_impl_::hugepage_mode;
+    using hugepage_alloc_impl_::hugepage_policy;
+    using hugepage_alloc_impl_::hugepage_prefault;
+    using hugepage_alloc_impl_::hugepage_size_1g;
+    using hugepage_alloc_impl_::hugepage_size_2m;
+    using hugepage_alloc_impl_::hugepage_usage_info;
+
     /**
-     * @brief Allocates huge page memory (if GT_NO_HUGETLB is not defined) and shifts allocations by some bytes to
-     * reduce cache set conflicts.
+     * @brief Allocates memory according to the policy and shifts allocations by some bytes to reduce cache set
+     * conflicts. The `first_touch` prefaulting is done by the OpenMP threads (if compiled with OpenMP).
      */
-    inline void *hugepage_alloc(std::size_t size) {
-        // get allocation offset to reduce L1 cache conflicts
-        std::size_t offset = hugepage_alloc_impl_::allocation_offset();
-        assert(offset >= sizeof(hugepage_alloc_impl_::ptr_metadata));
-
-        // get allocation mode from environment
-        auto mode = hugepage_alloc_impl_::hugepage_mode_from_env();
-
-        // allocate memory with additional space for offsetting
-        void *ptr;
-        std::tie(ptr, size) = hugepage_alloc_impl_::allocate(size + offset, mode);
-
-        // offset pointer and write pointer metadata required for deallocation
-        ptr = static_cast<char *>(ptr) + offset;
-        static_cast<hugepage_alloc_impl_::ptr_metadata *>(ptr)[-1] = {offset, size, mode};
-        return ptr;
+    inline void *hugepage_alloc(std::size_t size, hugepage_policy const &policy) {
+        return hugepage_alloc_impl_::allocate_with_offset(size, policy, [](char *base, std::size_t pages) {
+            std::size_t page = hugepage_alloc_impl_::page_size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (std::size_t i = 0; i < pages; ++i)
+                static_cast<char volatile *>(base)[i * page] = 0;
+        });
     }
 
+    /**
+     * @brief Same as above, but the `first_touch` prefaulting is done by the given thread pool.
+     */
+    template <class ThreadPool>
+    void *hugepage_alloc(std::size_t size, hugepage_policy const &policy, ThreadPool const &pool) {
+        return hugepage_alloc_impl_::allocate_with_offset(size, policy, [&](char *base, std::size_t pages) {
+            std::size_t page = hugepage_alloc_impl_::page_size();
+            thread_pool::parallel_for_loop(
+                pool, [=](std::size_t i) { static_cast<char volatile *>(base)[i * page] = 0; }, pages);
+        });
+    }
+
+    /**
+     * @brief Allocates memory according to the default policy (see `default_hugepage_policy`).
+     */
+    inline void *hugepage_alloc(std::size_t size) { return hugepage_alloc(size, default_hugepage_policy()); }
+
     /**
      * @brief Frees memory allocated by hugepage_alloc.
      */
@@ -218,9 +452,21 @@ namespace gridtools {
         if (!ptr)
             return;
         // read pointer metadata and compute originally allocated ptr value
-        auto &metadata = static_cast<hugepage_alloc_impl_::ptr_metadata *>(ptr)[-1];
+        auto &metadata = hugepage_alloc_impl_::metadata(ptr);
         // free originally allocated pointer
         hugepage_alloc_impl_::deallocate(static_cast<char *>(ptr) - metadata.offset, metadata.full_size, metadata.mode);
     }
 
+    /**
+     * @brief Reports how the memory allocated by hugepage_alloc is backed: the mode and the page size that were
+     * actually used (after the fallbacks) and the resident and huge page backed bytes of the allocation. The latter
+     * are approximate if the allocation shares the mapping with other memory (that is the case for the disabled mode).
+     */
+    inline hugepage_usage_info hugepage_usage(void *ptr) {
+        auto &metadata = hugepage_alloc_impl_::metadata(ptr);
+        hugepage_usage_info res = {metadata.full_size, 0, 0, metadata.mode, metadata.page_size};
+        hugepage_alloc_impl_::smaps_usage(
+            static_cast<char *>(ptr) - metadata.offset, metadata.full_size, res.resident_bytes, res.huge_bytes);
+        return res;
+    }
 } // namespace gridtools
@@ -0,0 +1,377 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+/*
+ * Hierarchical profiling regions.
+ *
+ * A region measures the time between its construction and destruction. The regions that are opened while another
+ * region is alive on the same thread are nested into it. The statistics is aggregated per thread into the call tree
+ * keyed by the region names:
+ *
+ *   {
+ *       GT_PROFILING_REGION("timestep");
+ *       run(dynamics, ...);    // the stencil runs and their stages are instrumented by the library
+ *       bc.exchange(...);      // as well as the halo exchanges and the boundary conditions
+ *   }
+ *   ...
+ *   profiling::report(std::cout);        // call tree as text
+ *   profiling::report_json(file);        // call tree as JSON
+ *
+ * The profiling is enabled by defining `GT_PROFILING`. Otherwise `GT_PROFILING_REGION` expands to nothing and the
+ * region names are not even evaluated. The time is taken from `std::chrono::steady_clock` or, if
+ * `GT_PROFILING_RDTSC` is defined, from the time stamp counter of x86 CPUs (converted to seconds using the frequency
+ * measured on the first report).
+ *
+ * The `char const *` names are expected to have static storage duration: the children of a region are looked up by
+ * the pointer. The `std::string` names are compared by value.
+ *
+ * The trees of all threads are merged by the paths of the regions in the report. The bodies of the parallel loops
+ * wrapped into `profiling::nested` (the backends do that for the loops over the blocks) open their regions on the
+ * thread pool threads under the path of the current region of the calling thread. So the stages of the stencils
+ * appear under the enclosing `run`; their time is summed over the threads. `report` and `reset` should not be
+ * called while the regions are open on other threads.
+ */
+
+#include <ostream>
+#include <string>
+
+#ifdef GT_PROFILING
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef GT_PROFILING_RDTSC
+#include <x86intrin.h>
+#endif
+
+namespace gridtools {
+    namespace profiling {
+        namespace profiling_impl_ {
+#ifdef GT_PROFILING_RDTSC
+            inline std::int64_t now() { return __rdtsc(); }
+
+            inline double seconds_per_tick() {
+                static double res = [] {
+                    using clock_t = std::chrono::steady_clock;
+                    auto start = clock_t::now();
+                    auto ticks = now();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    double elapsed = std::chrono::duration<double>(clock_t::now() - start).count();
+                    return elapsed / double(now() - ticks);
+                }();
+                return res;
+            }
+#else
+            inline std::int64_t now() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+            }
+
+            inline double seconds_per_tick() { return 1e-9; }
+#endif
+
+            struct node {
+                // the static name the node was created with, `nullptr` for the dynamic ones
+                char const *key;
+                std::string name;
+                node *parent;
+                std::vector<std::unique_ptr<node>> children;
+                std::int64_t ticks;
+                size_t count;
+
+                node *add_child(char const *key, std::string name) {
+                    children.emplace_back(new node{key, std::move(name), this, {}, 0, 0});
+                    return children.back().get();
+                }
+
+                node *child(char const *key) {
+                    for (auto &&c : children)
+                        if (c->key == key)
+                            return c.get();
+                    return add_child(key, key);
+                }
+
+                node *child(std::string const &name) {
+                    for (auto &&c : children)
+                        if (!c->key && c->name == name)
+                            return c.get();
+                    return add_child(nullptr, name);
+                }
+
+                bool entered() const {
+                    return count || std::any_of(children.begin(), children.end(), [](auto &&c) {
+                        return c->entered();
+                    });
+                }
+
+                void reset() {
+                    ticks = 0;
+                    count = 0;
+                    for (auto &&c : children)
+                        c->reset();
+                }
+            };
+
+            struct thread_tree {
+                node root = {nullptr, "", nullptr, {}, 0, 0};
+                node *current = &root;
+                // the last node of another tree that was mirrored into this one and its mirror
+                node const *mirrored = nullptr;
+                node *mirror_res = nullptr;
+
+                node *mirror_impl(node const *src) {
+                    if (!src->parent)
+                        return &root;
+                    node *parent = mirror_impl(src->parent);
+                    return src->key ? parent->child(src->key) : parent->child(src->name);
+                }
+
+                // the node of this tree that has the same path as `src` of the (possibly) other tree
+                node *mirror(node const *src) {
+                    if (src == current)
+                        return current;
+                    if (src != mirrored) {
+                        mirror_res = mirror_impl(src);
+                        mirrored = src;
+                    }
+                    return mirror_res;
+                }
+            };
+
+            // the aggregated node of the report
+            struct summary {
+                std::string name;
+                double seconds = 0;
+                size_t count = 0;
+                size_t threads = 0;
+                std::vector<summary> children;
+
+                void merge(node const &src) {
+                    seconds += src.ticks * seconds_per_tick();
+                    count += src.count;
+                    // the mirrors of the regions of the other threads are not entered by this thread
+                    if (src.count)
+                        ++threads;
+                    merge_children(src);
+                }
+
+                void merge_children(node const &src) {
+                    for (auto &&c : src.children) {
+                        // the regions that were not entered since the last reset
+                        if (!c->entered())
+                            continue;
+                        auto it = std::find_if(children.begin(), children.end(), [&](summary const &s) {
+                            return s.name == c->name;
+                        });
+                        if (it == children.end()) {
+                            children.push_back({c->name, 0, 0, 0, {}});
+                            it = children.end() - 1;
+                        }
+                        it->merge(*c);
+                    }
+                }
+            };
+
+            inline void print_text(std::ostream &strm, summary const &s, double parent_seconds, int depth) {
+                strm << std::string(2 * depth, ' ') << std::left << std::setw(std::max(48 - 2 * depth, 1)) << s.name
+                     << std::right << std::setw(14) << s.seconds << std::setw(10) << s.count << std::setw(8)
+                     << s.threads;
+                if (parent_seconds > 0)
+                    strm << std::setw(9) << std::setprecision(1) << s.seconds / parent_seconds * 100 << "%"
+                         << std::setprecision(6);
+                strm << "\n";
+                for (auto &&c : s.children)
+                    print_text(strm, c, s.seconds, depth + 1);
+            }
+
+            inline void print_json_string(std::ostream &strm, std::string const &str) {
+                strm << '"';
+                for (char c : str) {
+                    if (c == '"' || c == '\\')
+                        strm << '\\';
+                    strm << c;
+                }
+                strm << '"';
+            }
+
+            inline void print_json(std::ostream &strm, summary const &s) {
+                strm << "{\"name\":";
+                print_json_string(strm, s.name);
+                strm << ",\"seconds\":" << s.seconds << ",\"calls\":" << s.count << ",\"threads\":" << s.threads
+                     << ",\"children\":[";
+                for (size_t i = 0; i != s.children.size(); ++i) {
+                    if (i)
+                        strm << ",";
+                    print_json(strm, s.children[i]);
+                }
+                strm << "]}";
+            }
+
+            class registry {
+                std::mutex m_mutex;
+                std::vector<std::unique_ptr<thread_tree>> m_trees;
+
+              public:
+                static registry &get() {
+                    static registry res;
+                    return res;
+                }
+
+                thread_tree &add_tree() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_trees.emplace_back(new thread_tree());
+                    return *m_trees.back();
+                }
+
+                summary collect() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    summary res = {"total", 0, 0, 0, {}};
+                    for (auto &&tree : m_trees)
+                        res.merge_children(tree->root);
+                    for (auto &&c : res.children)
+                        res.seconds += c.seconds;
+                    return res;
+                }
+
+                void reset() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (auto &&tree : m_trees)
+                        tree->root.reset();
+                }
+            };
+
+            inline thread_tree &local_tree() {
+                static thread_local thread_tree &res = registry::get().add_tree();
+                return res;
+            }
+
+            class region {
+                thread_tree &m_tree;
+                node *m_node;
+                std::int64_t m_start;
+
+                void enter(node *n) {
+                    m_node = m_tree.current = n;
+                    m_start = now();
+                }
+
+              public:
+                explicit region(char const *name) : m_tree(local_tree()) { enter(m_tree.current->child(name)); }
+                explicit region(std::string const &name) : m_tree(local_tree()) { enter(m_tree.current->child(name)); }
+
+                region(region const &) = delete;
+                region &operator=(region const &) = delete;
+
+                ~region() {
+                    m_node->ticks += now() - m_start;
+                    ++m_node->count;
+                    m_tree.current = m_node->parent;
+                }
+            };
+
+            template <class F>
+            struct nested_f {
+                node const *m_parent;
+                F m_f;
+
+                template <class... Args>
+                void operator()(Args &&... args) const {
+                    struct guard {
+                        thread_tree &tree;
+                        node *prev;
+                        ~guard() { tree.current = prev; }
+                    };
+                    thread_tree &tree = local_tree();
+                    guard g = {tree, tree.current};
+                    tree.current = tree.mirror(m_parent);
+                    m_f(std::forward<Args>(args)...);
+                }
+            };
+
+            /**
+             *  Wraps the body of a parallel loop: the regions opened by the body on the thread pool threads are nested
+             *  under the path of the current region of the calling thread.
+             */
+            template <class F>
+            nested_f<F> nested(F f) {
+                return {local_tree().current, std::move(f)};
+            }
+
+            /**
+             *  Writes the merged call tree: the inclusive time in seconds, the number of calls, the number of threads
+             *  and the fraction of the parent time.
+             */
+            inline void report(std::ostream &strm) {
+                auto flags = strm.flags();
+                auto precision = strm.precision(6);
+                strm << std::fixed << std::left << std::setw(48) << "region" << std::right << std::setw(14)
+                     << "seconds" << std::setw(10) << "calls" << std::setw(8) << "threads" << std::setw(10) << "parent"
+                     << "\n";
+                auto total = registry::get().collect();
+                for (auto &&c : total.children)
+                    print_text(strm, c, 0, 0);
+                strm.flags(flags);
+                strm.precision(precision);
+            }
+
+            inline void report_json(std::ostream &strm) {
+                auto precision = strm.precision(9);
+                print_json(strm, registry::get().collect());
+                strm << "\n";
+                strm.precision(precision);
+            }
+
+            inline void reset() { registry::get().reset(); }
+        } // namespace profiling_impl_
+        using profiling_impl_::nested;
+        using profiling_impl_::region;
+        using profiling_impl_::report;
+        using profiling_impl_::report_json;
+        using profiling_impl_::reset;
+    } // namespace profiling
+} // namespace gridtools
+
+#define GT_PROFILING_CONCAT_IMPL(x, y) x##y
+#define GT_PROFILING_CONCAT(x, y) GT_PROFILING_CONCAT_IMPL(x, y)
+#define GT_PROFILING_REGION(name) \
+    ::gridtools::profiling::region GT_PROFILING_CONCAT(gt_profiling_region_, __LINE__)(name)
+
+#else
+
+namespace gridtools {
+    namespace profiling {
+        struct region {
+            explicit region(char const *) {}
+            explicit region(std::string const &) {}
+        };
+
+        template <class F>
+        F nested(F f) {
+            return f;
+        }
+
+        inline void report(std::ostream &) {}
+        inline void report_json(std::ostream &) {}
+        inline void reset() {}
+    } // namespace profiling
+} // namespace gridtools
+
+#define GT_PROFILING_REGION(name)
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+/*
+ * Stride padding against cache set and 4K aliasing.
+ *
+ * If a stride is (close to) a multiple of the critical stride (the number of the L1 cache sets times the cache line
+ * size, but at least the page size), the neighboring rows or planes map to the same cache sets and the same
+ * addresses modulo 4K. With power-of-two horizontal sizes that is the case for the j and k strides.
+ *
+ * `stride_padding` is the padding policy: `aliases(stride_bytes)` tells whether the stride needs padding,
+ * `pad_length(length, stride_bytes, step)` increases the length of a dimension (in steps of `step` elements) until
+ * the stride of the next dimension doesn't alias. `storage::builder<...>.padding()` applies it to the strides of a
+ * data store, the CPU backends apply it to their temporaries. The cache geometry is taken from sysfs (see
+ * `hugepage_alloc.hpp`). The padding can be switched off at runtime with GT_STRIDE_PADDING=disable.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include "hugepage_alloc.hpp"
+
+namespace gridtools {
+    namespace stride_padding_impl_ {
+        inline std::size_t critical_stride() {
+            static const std::size_t value = std::max(
+                hugepage_alloc_impl_::cache_sets() * hugepage_alloc_impl_::cache_line_size(),
+                hugepage_alloc_impl_::page_size());
+            return value;
+        }
+
+        inline bool enabled_from_env() {
+            const char *env_value = std::getenv("GT_STRIDE_PADDING");
+            return !env_value || std::strcmp(env_value, "disable") != 0;
+        }
+
+        /**
+         * @brief Pads `length` so that the stride of the next dimension `length * stride_bytes` doesn't alias for the
+         * `Padding` policy. `stride_bytes` is the stride of this dimension. It is assumed not to alias itself, so the
+         * loop terminates after at most `critical_stride() / cache_line_size()` steps.
+         */
+        template <class Padding, class Int>
+        Int pad_length(Int length, std::size_t stride_bytes, Int step) {
+            if (length <= 1)
+                return length;
+            std::size_t max_steps = critical_stride() / hugepage_alloc_impl_::cache_line_size();
+            for (std::size_t i = 0; i != max_steps && Padding::aliases(std::size_t(length) * stride_bytes); ++i)
+                length += step;
+            return length;
+        }
+
+        struct stride_padding {
+            static bool enabled() {
+                static const bool value = enabled_from_env();
+                return value;
+            }
+
+            /**
+             * @brief The strides that are shorter than the critical stride are fine, the longer ones alias if they
+             * are within a cache line of a multiple of it.
+             */
+            static bool aliases(std::size_t stride_bytes) {
+                std::size_t critical = critical_stride();
+                std::size_t line = hugepage_alloc_impl_::cache_line_size();
+                std::size_t rem = stride_bytes % critical;
+                return enabled() && stride_bytes >= critical && (rem < line || critical - rem < line);
+            }
+
+            template <class Int>
+            static Int pad_length(Int length, std::size_t stride_bytes, Int step = 1) {
+                return stride_padding_impl_::pad_length<stride_padding>(length, stride_bytes, step);
+            }
+        };
+    } // namespace stride_padding_impl_
+
+    using stride_padding_impl_::stride_padding;
+} // namespace gridtools
@@ -16,20 +16,39 @@
 #include "../meta/macros.hpp"
 #include "../meta/type_traits.hpp"
 #include "concept.hpp"
+#include "convert.hpp"
 #include "delegate.hpp"
 #include "simple_ptr_holder.hpp"
 
 namespace gridtools {
     namespace sid {
         namespace as_const_impl_ {
+            template <class Ptr>
+            struct is_mutable_ptr : std::false_type {};
+
+            template <class T>
+            struct is_mutable_ptr<T *> : bool_constant<!std::is_const<T>::value> {};
+
+            template <class Storage, class Compute>
+            struct is_mutable_ptr<converting_ptr<Storage, Compute>> : bool_constant<!std::is_const<Storage>::value> {};
+
+            template <class T>
+            GT_CONSTEXPR GT_FUNCTION T const *make_const(T *ptr) {
+                return ptr;
+            }
+
+            template <class Storage, class Compute>
+            GT_CONSTEXPR GT_FUNCTION converting_ptr<Storage const, Compute> make_const(
+                converting_ptr<Storage, Compute> const &ptr) {
+                return {ptr.m_ptr};
+            }
+
             template <class Sid>
             struct const_adapter : delegate<Sid> {
                 struct const_ptr_holder {
-                    ptr_holder_type<Sid> m_impl;
+                    decltype(sid::get_const_origin(std::declval<Sid &>())) m_impl;
 
-                    GT_CONSTEXPR GT_FUNCTION std::add_const_t<sid::element_type<Sid>> *operator()() const {
-                        return m_impl();
-                    }
+                    GT_CONSTEXPR GT_FUNCTION auto operator()() const { return as_const_impl_::make_const(m_impl()); }
 
                     friend GT_CONSTEXPR GT_FUNCTION const_ptr_holder operator+(
                         const_ptr_holder const &obj, ptr_diff_type<Sid> offset) {
@@ -38,14 +57,14 @@ namespace gridtools {
                 };
 
                 friend const_ptr_holder sid_get_origin(const_adapter const &obj) {
-                    return {get_origin(const_cast<Sid &>(obj.m_impl))};
+                    return {sid::get_const_origin(const_cast<Sid &>(obj.m_impl))};
                 }
                 using delegate<Sid>::delegate;
             };
         } // namespace as_const_impl_
 
         /**
-         *   Returns a `SID`, which ptr_type is a pointer to const.
+         *   Returns a `SID`, which ptr_type is a pointer to const or a converting pointer to const (see `convert.hpp`).
          *   If the original ptr_type is not a non const pointer `as_const` returns the argument.
          *
          *   TODO(anstaf): at a moment the generated ptr holder always has `host_device` `operator()`
@@ -53,14 +72,14 @@ namespace gridtools {
          */
         template <class Src,
             class Ptr = sid::ptr_type<std::decay_t<Src>>,
-            std::enable_if_t<std::is_pointer<Ptr>::value && !std::is_const<std::remove_pointer_t<Ptr>>::value, int> = 0>
+            std::enable_if_t<as_const_impl_::is_mutable_ptr<Ptr>::value, int> = 0>
         as_const_impl_::const_adapter<Src> as_const(Src &&src) {
             return {std::forward<Src>(src)};
         }
 
         template <class Src,
             class Ptr = sid::ptr_type<std::decay_t<Src>>,
-            std::enable_if_t<!std::is_pointer<Ptr>::value || std::is_const<std::remove_pointer_t<Ptr>>::value, int> = 0>
+            std::enable_if_t<!as_const_impl_::is_mutable_ptr<Ptr>::value, int> = 0>
         decltype(auto) as_const(Src &&src) {
             return std::forward<Src>(src);
         }
@@ -72,7 +91,7 @@ namespace gridtools {
 
         template <class Src>
         decltype(auto) add_const(std::true_type, Src &&src) {
-            return as_const(std::forward<Src>(src));
+            return sid::as_const(std::forward<Src>(src));
         }
     } // namespace sid
 } // namespace gridtools
@@ -44,6 +44,12 @@
  *     `PtrDiff sid_get_ptr_diff(T const&)`
  *     `StridesKind sid_get_strides_kind(T const&);`
  *
+ *   The following function is optional:
+ *     `PtrHolder sid_get_const_origin(T&);` -- the origin for the read only access (see `as_const.hpp`). It is
+ *     provided by the `SID`s that do something on the mutable access which the readers don't need (like the data
+ *     stores that save their snapshots). The pointers of the returned holder should be convertible to the pointers
+ *     to const of the `PtrHolder` returned by `sid_get_origin`.
+ *
  *   The deducible from `T` types `PtrHolder`, `PtrDiff` and `Strides` in their turn should satisfy the constraints:
  *     - `PtrHolder` and `Strides` are trivially copyable
  *     - `PrtHolder` is callable with no args.
@@ -138,6 +144,7 @@
  *  Wrappers for concept functions:
  *
  *  - Ptr sid::get_origin(Sid&);
+ *  - Ptr sid::get_const_origin(Sid&);
  *  - Strides sid::get_strides(Sid const&);
  *  - void sid::shift(PtrOrPtrDiff&, Stride, Offset);
  *  - LowerBounds sid::get_lower_bounds(Sid const&);
@@ -201,6 +208,7 @@ namespace gridtools {
             not_provided sid_get_strides_kind(...);
             not_provided sid_get_lower_bounds(...);
             not_provided sid_get_upper_bounds(...);
+            not_provided sid_get_const_origin(...);
 
             // BEGIN `get_origin` PART
 
@@ -226,6 +234,19 @@ namespace gridtools {
             template <class Sid>
             using ptr_holder_type = decltype(::gridtools::sid::concept_impl_::get_origin(std::declval<Sid &>()));
 
+            /**
+             *  `get_const_origin` delegates to `sid_get_const_origin` if it is provided and to `get_origin` otherwise
+             */
+            template <class Sid, class Res = decltype(sid_get_const_origin(std::declval<Sid &>()))>
+            std::enable_if_t<!std::is_same<Res, not_provided>::value, Res> get_const_origin(Sid &obj) {
+                return sid_get_const_origin(obj);
+            }
+
+            template <class Sid, class Res = decltype(sid_get_const_origin(std::declval<Sid &>()))>
+            std::enable_if_t<std::is_same<Res, not_provided>::value, ptr_holder_type<Sid>> get_const_origin(Sid &obj) {
+                return get_origin(obj);
+            }
+
             /**
              *  `Ptr` type is deduced from `get_origin`
              */
@@ -652,6 +673,7 @@ namespace gridtools {
         using concept_impl_::default_ptr_diff;
 
         // Runtime functions
+        using concept_impl_::get_const_origin;
         using concept_impl_::get_lower_bounds;
         using concept_impl_::get_origin;
         using concept_impl_::get_strides;
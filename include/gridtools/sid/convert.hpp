@@ -0,0 +1,178 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "../common/host_device.hpp"
+#include "../meta/macros.hpp"
+#include "concept.hpp"
+#include "delegate.hpp"
+
+/**
+ *   The mixed precision SIDs: the elements are stored as `Storage` (like `float` or `bfloat16`), but are loaded and
+ *   stored as `Compute` (like `double`).
+ *
+ *   The pointer of such a SID is `converting_ptr<Storage, Compute>`. Its `operator*` returns a `converting_ref` that
+ *   converts to `Compute` on read and from `Compute` on write. For the const `Storage` it returns the `Compute` value.
+ *   All conversions are inlined, so the loops over the converting pointers are vectorized as the plain ones.
+ */
+namespace gridtools {
+    namespace sid {
+        namespace convert_impl_ {
+            template <class Storage, class Compute>
+            class converting_ref {
+                Storage *m_ptr;
+
+              public:
+                GT_FUNCTION explicit converting_ref(Storage *ptr) : m_ptr(ptr) {}
+                converting_ref(converting_ref const &) = default;
+
+                GT_FUNCTION operator Compute() const { return static_cast<Compute>(*m_ptr); }
+
+                GT_FUNCTION converting_ref const &operator=(Compute value) const {
+                    *m_ptr = static_cast<Storage>(value);
+                    return *this;
+                }
+
+                // assigns the value, not the reference
+                GT_FUNCTION converting_ref const &operator=(converting_ref const &other) const {
+                    return *this = static_cast<Compute>(other);
+                }
+
+                GT_FUNCTION converting_ref const &operator+=(Compute value) const {
+                    return *this = static_cast<Compute>(*this) + value;
+                }
+                GT_FUNCTION converting_ref const &operator-=(Compute value) const {
+                    return *this = static_cast<Compute>(*this) - value;
+                }
+                GT_FUNCTION converting_ref const &operator*=(Compute value) const {
+                    return *this = static_cast<Compute>(*this) * value;
+                }
+                GT_FUNCTION converting_ref const &operator/=(Compute value) const {
+                    return *this = static_cast<Compute>(*this) / value;
+                }
+            };
+
+            template <class Storage, class Compute>
+            struct converting_ptr {
+                Storage *m_ptr;
+
+                GT_FUNCTION Compute deref(std::true_type) const { return static_cast<Compute>(*m_ptr); }
+                GT_FUNCTION converting_ref<Storage, Compute> deref(std::false_type) const {
+                    return converting_ref<Storage, Compute>(m_ptr);
+                }
+
+                GT_FUNCTION decltype(auto) operator*() const { return deref(std::is_const<Storage>()); }
+
+                template <class Diff>
+                GT_FUNCTION converting_ptr &operator+=(Diff diff) {
+                    m_ptr += diff;
+                    return *this;
+                }
+
+                GT_FUNCTION converting_ptr &operator++() {
+                    ++m_ptr;
+                    return *this;
+                }
+
+                GT_FUNCTION converting_ptr &operator--() {
+                    --m_ptr;
+                    return *this;
+                }
+
+                template <class Diff>
+                friend GT_FUNCTION converting_ptr operator+(converting_ptr obj, Diff diff) {
+                    return {obj.m_ptr + diff};
+                }
+            };
+
+            /**
+             *  The holder of the converting pointers made of the holder `Holder` of the plain `Storage` pointers.
+             */
+            template <class Holder, class Compute>
+            struct converting_ptr_holder {
+                using storage_t = std::remove_pointer_t<std::decay_t<decltype(std::declval<Holder const &>()())>>;
+
+                Holder m_impl;
+
+                GT_CONSTEXPR GT_FUNCTION converting_ptr<storage_t, Compute> operator()() const {
+                    return {m_impl()};
+                }
+
+                template <class Diff>
+                friend converting_ptr_holder operator+(converting_ptr_holder const &obj, Diff diff) {
+                    return {obj.m_impl + diff};
+                }
+            };
+
+            template <class T>
+            struct compute_type_f {
+                using type = T;
+            };
+
+            template <class Storage, class Compute>
+            struct compute_type_f<converting_ref<Storage, Compute>> {
+                using type = Compute;
+            };
+
+            template <class Sid, class Ptr = ptr_type<Sid>>
+            struct storage_element_type_f {
+                using type = element_type<Sid>;
+            };
+
+            template <class Sid, class Storage, class Compute>
+            struct storage_element_type_f<Sid, converting_ptr<Storage, Compute>> {
+                using type = Storage;
+            };
+
+            template <class Compute, class Sid>
+            struct converting_adapter : delegate<Sid> {
+                friend converting_ptr_holder<ptr_holder_type<Sid>, Compute> sid_get_origin(converting_adapter &obj) {
+                    return {get_origin(obj.m_impl)};
+                }
+                friend converting_ptr_holder<decltype(get_const_origin(std::declval<Sid &>())), Compute>
+                sid_get_const_origin(converting_adapter &obj) {
+                    return {get_const_origin(obj.m_impl)};
+                }
+                using delegate<Sid>::delegate;
+            };
+        } // namespace convert_impl_
+        using convert_impl_::converting_ptr;
+        using convert_impl_::converting_ptr_holder;
+        using convert_impl_::converting_ref;
+
+        /**
+         *  The type the stencils compute in for the elements of the `Sid`: the element type for the plain SIDs and
+         *  `Compute` for the converting ones.
+         */
+        template <class Sid>
+        using compute_type = typename convert_impl_::compute_type_f<element_type<Sid>>::type;
+
+        /**
+         *  The type of the elements in memory: the element type for the plain SIDs and `Storage` for the converting
+         *  ones.
+         */
+        template <class Sid>
+        using storage_element_type = typename convert_impl_::storage_element_type_f<Sid>::type;
+
+        /**
+         *   Returns a `SID` that converts the elements of the `src` to `Compute` on access.
+         *   The pointer type of the `src` should be a raw pointer.
+         */
+        template <class Compute, class Src>
+        convert_impl_::converting_adapter<Compute, Src> convert(Src &&src) {
+            static_assert(std::is_pointer<sid::ptr_type<std::decay_t<Src>>>::value,
+                "gridtools::sid::convert: the pointer type of the SID should be a raw pointer");
+            return {std::forward<Src>(src)};
+        }
+    } // namespace sid
+} // namespace gridtools
@@ -73,6 +73,11 @@ namespace gridtools {
             return sid_get_origin(obj.m_impl);
         }
 
+        template <class Sid>
+        decltype(sid_get_const_origin(std::declval<Sid &>())) sid_get_const_origin(delegate<Sid> &obj) {
+            return sid_get_const_origin(obj.m_impl);
+        }
+
         template <class Sid>
         decltype(sid_get_ptr_diff(std::declval<Sid const &>())) sid_get_ptr_diff(delegate<Sid> const &);
 
@@ -0,0 +1,124 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../common/defs.hpp"
+#include "../common/for_each.hpp"
+#include "../common/hymap.hpp"
+#include "../common/integral_constant.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "concept.hpp"
+#include "delegate.hpp"
+#include "unknown_kind.hpp"
+
+namespace gridtools {
+    namespace sid {
+        namespace narrow_strides_impl_ {
+            template <class Int>
+            struct narrow_f {
+                template <class T, T V>
+                integral_constant<T, V> operator()(integral_constant<T, V> val) const {
+                    return val;
+                }
+
+                template <class T, std::enable_if_t<std::is_integral<T>::value, int> = 0>
+                Int operator()(T val) const {
+                    return static_cast<Int>(val);
+                }
+            };
+
+            struct no_bound {};
+
+            inline long long max_abs_index(long long lower, long long upper) {
+                return std::max(std::llabs(lower), std::llabs(upper));
+            }
+            template <class Bound>
+            long long max_abs_index(no_bound, Bound) {
+                return 0;
+            }
+            template <class Bound>
+            long long max_abs_index(Bound, no_bound) {
+                return 0;
+            }
+            inline long long max_abs_index(no_bound, no_bound) { return 0; }
+
+            /**
+             *  Throws if the strides or the offsets of the elements within the bounds from the origin do not fit into
+             *  `Int`. Only the strides are checked along the unbounded dimensions.
+             */
+            template <class Int, class Sid>
+            void check_range(Sid const &sid) {
+                auto &&strides = get_strides(sid);
+                auto &&lower_bounds = get_lower_bounds(sid);
+                auto &&upper_bounds = get_upper_bounds(sid);
+                constexpr long long max = std::numeric_limits<Int>::max();
+                long long span = 0;
+                using keys_t = meta::transform<meta::lazy::id, get_keys<std::decay_t<decltype(strides)>>>;
+                for_each<keys_t>([&](auto key) {
+                    using key_t = typename decltype(key)::type;
+                    long long stride = std::llabs(get_stride<key_t>(strides));
+                    if (stride > max)
+                        throw std::out_of_range("sid::narrow_strides: the stride does not fit into the index type");
+                    span += stride * max_abs_index(at_key_with_default<key_t, no_bound>(lower_bounds),
+                                         at_key_with_default<key_t, no_bound>(upper_bounds));
+                    if (span > max)
+                        throw std::out_of_range("sid::narrow_strides: the offsets do not fit into the index type");
+                });
+            }
+
+            template <class Sid, class Int>
+            struct narrowed_sid : delegate<Sid> {
+                template <class SidT>
+                narrowed_sid(SidT &&impl) : delegate<Sid>(std::forward<SidT>(impl)) {
+                    check_range<Int>(this->m_impl);
+                }
+
+                friend auto sid_get_strides(narrowed_sid const &obj) {
+                    return tuple_util::transform(narrow_f<Int>(), get_strides(obj.m_impl));
+                }
+
+                friend Int sid_get_ptr_diff(narrowed_sid const &) { return {}; }
+            };
+
+            template <class...>
+            struct kind;
+
+            template <class Sid, class Int, class Kind = strides_kind<Sid>>
+            meta::if_<std::is_same<Kind, unknown_kind>, unknown_kind, kind<Kind, Int>> sid_get_strides_kind(
+                narrowed_sid<Sid, Int> const &);
+        } // namespace narrow_strides_impl_
+
+        /**
+         *   Returns a `SID` with the run time strides and the `ptr_diff` of the type `Int` (32 bit by default).
+         *
+         *   The SIDs that come from the outside of the library (like the python or fortran arrays) have the 64 bit
+         *   strides. With many fields in a stencil they occupy twice as many registers as needed in the innermost
+         *   loop. The range of the offsets is checked at run time: `std::out_of_range` is thrown if the strides or the
+         *   offsets of the elements within the bounds do not fit into `Int`.
+         *
+         *   The strides kind is preserved: the narrowed SIDs of the same kind share a single set of strides within
+         *   `sid::composite`.
+         */
+        template <class Int = int_t, class Sid>
+        narrow_strides_impl_::narrowed_sid<Sid, Int> narrow_strides(Sid &&sid) {
+            static_assert(std::is_integral<Int>::value && std::is_signed<Int>::value,
+                "the index type should be the signed integral");
+            return {std::forward<Sid>(sid)};
+        }
+    } // namespace sid
+} // namespace gridtools
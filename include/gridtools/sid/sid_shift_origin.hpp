@@ -39,13 +39,20 @@ namespace gridtools {
                 return hymap::transform(add_offset_f<Offsets>{offsets}, std::forward<Bounds>(bounds));
             }
 
+            // the origin is taken from the original `SID` on access, not in the ctor: the read only users take it with
+            // `get_const_origin` (see `as_const.hpp`)
             template <class Sid, class LowerBounds, class UpperBounds>
             class shifted_sid : public delegate<Sid> {
-                ptr_holder_type<Sid> m_origin;
+                ptr_diff_type<Sid> m_offset;
                 LowerBounds m_lower_bounds;
                 UpperBounds m_upper_bounds;
 
-                friend ptr_holder_type<Sid> sid_get_origin(shifted_sid &obj) { return obj.m_origin; }
+                friend ptr_holder_type<Sid> sid_get_origin(shifted_sid &obj) {
+                    return get_origin(obj.m_impl) + obj.m_offset;
+                }
+                friend decltype(get_const_origin(std::declval<Sid &>())) sid_get_const_origin(shifted_sid &obj) {
+                    return get_const_origin(obj.m_impl) + obj.m_offset;
+                }
                 friend LowerBounds const &sid_get_lower_bounds(shifted_sid const &obj) { return obj.m_lower_bounds; }
                 friend UpperBounds const &sid_get_upper_bounds(shifted_sid const &obj) { return obj.m_upper_bounds; }
 
@@ -53,8 +60,7 @@ namespace gridtools {
                 template <class Arg, class Offsets>
                 shifted_sid(Arg &&original_sid, Offsets &&offsets) noexcept
                     : delegate<Sid>(std::forward<Arg>(original_sid)),
-                      m_origin(get_origin(this->m_impl) +
-                               multi_shifted(ptr_diff_type<Sid>(), get_strides(this->m_impl), offsets)),
+                      m_offset(multi_shifted(ptr_diff_type<Sid>(), get_strides(this->m_impl), offsets)),
                       m_lower_bounds(add_offsets(get_lower_bounds(this->m_impl), offsets)),
                       m_upper_bounds(add_offsets(get_upper_bounds(this->m_impl), offsets)) {}
             };
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 #include "../common/for_each.hpp"
 #include "../common/host_device.hpp"
@@ -18,8 +19,10 @@
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
 #include "../sid/concept.hpp"
+#include "../sid/convert.hpp"
 #include "common/dim.hpp"
 #include "common/extent.hpp"
+#include "common/tmp_policy.hpp"
 #include "core/execution_types.hpp"
 #include "core/interval.hpp"
 #include "core/level.hpp"
@@ -93,6 +96,23 @@ namespace gridtools {
                 static GT_FUNCTION cache_io_policies_t cache_io_policies() { return {}; }
             };
 
+            template <class Fun, class = void>
+            struct write_only_keys_f {
+                using type = meta::list<>;
+            };
+
+            template <class Fun>
+            struct write_only_keys_f<Fun, void_t<typename Fun::write_only_keys_t>> {
+                using type = typename Fun::write_only_keys_t;
+            };
+
+            /**
+             *  The keys of the outputs that the stage `Fun` only assigns and never reads, empty if the stage doesn't
+             *  declare `write_only_keys_t`. The backends may write them with the streaming stores.
+             */
+            template <class Fun>
+            using get_write_only_keys = typename write_only_keys_f<Fun>::type;
+
             template <template <class...> class GetKey = get_plh, class PlhMap, class Fun>
             auto make_data_stores(PlhMap, Fun &&fun) {
                 return tuple_util::transform(
@@ -104,6 +124,30 @@ namespace gridtools {
                 return tuple_util::transform([&](auto item) { return grid.k_size(item.interval()); }, Items());
             }
 
+            /*
+             *  The element type the temporary should be allocated with: the data type of the placeholder or
+             *  `Storage` if the temporary is declared with `tmp_policy::store_as<Storage>`.
+             */
+            template <class PlhInfo>
+            using tmp_storage_type = tmp_policy::storage_type<typename PlhInfo::plh_t, typename PlhInfo::data_t>;
+
+            /*
+             *  Wraps the temporary allocated with `tmp_storage_type` into the SID with the placeholder data type.
+             */
+            template <class PlhInfo,
+                class Sid,
+                std::enable_if_t<std::is_same<tmp_storage_type<PlhInfo>, typename PlhInfo::data_t>::value, int> = 0>
+            Sid convert_tmp_storage(PlhInfo, Sid sid) {
+                return sid;
+            }
+
+            template <class PlhInfo,
+                class Sid,
+                std::enable_if_t<!std::is_same<tmp_storage_type<PlhInfo>, typename PlhInfo::data_t>::value, int> = 0>
+            auto convert_tmp_storage(PlhInfo, Sid sid) {
+                return sid::convert<typename PlhInfo::data_t>(std::move(sid));
+            }
+
             namespace lazy {
                 template <class...>
                 struct merge_plh_infos;
@@ -10,6 +10,8 @@
 #pragma once
 
 #include "../../common/host_device.hpp"
+#include "../../sid/convert.hpp"
+#include "streaming_store.hpp"
 
 namespace gridtools {
     namespace stencil {
@@ -39,6 +41,24 @@ namespace gridtools {
             using type = T const &;
         };
 
+        // the mixed precision fields: the `in` accessors read the compute type, the `inout` ones get the converting
+        // reference
+        template <class Storage, class Compute>
+        struct apply_intent_type<intent::inout, sid::converting_ref<Storage, Compute>> {
+            using type = sid::converting_ref<Storage, Compute>;
+        };
+
+        template <class Storage, class Compute>
+        struct apply_intent_type<intent::in, sid::converting_ref<Storage, Compute>> {
+            using type = Compute;
+        };
+
+        // the outputs declared write only (only `inout` accessors can be) get the streaming reference on the CPU
+        template <class T>
+        struct apply_intent_type<intent::inout, streaming_ref<T>> {
+            using type = streaming_ref<T>;
+        };
+
         template <intent Intent, class T>
         using apply_intent_t = typename apply_intent_type<Intent, T>::type;
 
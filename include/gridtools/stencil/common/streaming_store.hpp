@@ -0,0 +1,128 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../../common/host_device.hpp"
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_nontemporal_store)
+#define GT_STREAMING_STORE_BUILTIN
+#endif
+#endif
+
+/**
+ *   The non-temporal (streaming) stores for the outputs that the stencil declares write only.
+ *
+ *   The plain store of the element that is not in the cache reads the whole cache line from the memory first (read
+ *   for ownership). The streaming store writes the line directly, which halves the memory traffic of the output.
+ *   The streaming stores are weakly ordered: `streaming_fence()` should be called by the writing thread before the
+ *   results are consumed by the other threads.
+ *
+ *   The streaming stores are opt-in: the functor lists the outputs it only assigns in its `write_only` member (see
+ *   `frontend/cartesian/stage.hpp`). `streaming_ref` supports the assignment only, so where the streaming stores are
+ *   used reading such an output doesn't compile. The stores are streaming if the compiler provides
+ *   `__builtin_nontemporal_store` (clang), that keeps the loops vectorized. Otherwise on x86 only the scalar streaming
+ *   stores (`movnti`) are available; they prevent the vectorization of the loop and pay off only for the memory bound
+ *   stencils, so they are used only if `GT_SCALAR_STREAMING_STORES` is defined. Elsewhere the stores are plain.
+ */
+namespace gridtools {
+    namespace stencil {
+        namespace streaming_store_impl_ {
+#if defined(GT_STREAMING_STORE_BUILTIN)
+            template <class T>
+            struct is_streamable : std::is_arithmetic<T> {};
+
+            template <class T>
+            GT_FORCE_INLINE void store(T *ptr, T value) {
+                __builtin_nontemporal_store(value, ptr);
+            }
+#elif defined(__SSE2__) && defined(GT_SCALAR_STREAMING_STORES)
+            template <class T>
+            struct is_streamable : std::integral_constant<bool,
+                                       std::is_arithmetic<T>::value &&
+#if defined(__x86_64__)
+                                           (sizeof(T) == sizeof(int) || sizeof(T) == sizeof(long long))
+#else
+                                           sizeof(T) == sizeof(int)
+#endif
+                                       > {
+            };
+
+            template <class T, std::enable_if_t<sizeof(T) == sizeof(int), int> = 0>
+            GT_FORCE_INLINE void store(T *ptr, T value) {
+                int bits;
+                std::memcpy(&bits, &value, sizeof(int));
+                _mm_stream_si32(reinterpret_cast<int *>(ptr), bits);
+            }
+
+#if defined(__x86_64__)
+            template <class T, std::enable_if_t<sizeof(T) == sizeof(long long), int> = 0>
+            GT_FORCE_INLINE void store(T *ptr, T value) {
+                long long bits;
+                std::memcpy(&bits, &value, sizeof(long long));
+                _mm_stream_si64(reinterpret_cast<long long *>(ptr), bits);
+            }
+#endif
+#else
+            template <class T>
+            struct is_streamable : std::false_type {};
+
+            template <class T>
+            GT_FORCE_INLINE void store(T *ptr, T value) {
+                *ptr = value;
+            }
+#endif
+
+            /**
+             *  The reference to the element of the write only output: it can be assigned only.
+             */
+            template <class T>
+            class streaming_ref {
+                T *m_ptr;
+
+              public:
+                explicit streaming_ref(T *ptr) : m_ptr(ptr) {}
+                streaming_ref(streaming_ref const &) = default;
+
+                // the reference is returned by value to be safely bound to `auto &&`
+                GT_FORCE_INLINE streaming_ref operator=(T value) const {
+                    store(m_ptr, value);
+                    return *this;
+                }
+
+                streaming_ref &operator=(streaming_ref const &) = delete;
+            };
+
+            /**
+             *  Makes the streaming stores of the calling thread globally visible.
+             */
+            inline void streaming_fence() {
+#if defined(__SSE2__) && (defined(GT_STREAMING_STORE_BUILTIN) || defined(GT_SCALAR_STREAMING_STORES))
+                _mm_sfence();
+#elif defined(GT_STREAMING_STORE_BUILTIN)
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+            }
+        } // namespace streaming_store_impl_
+        using streaming_store_impl_::is_streamable;
+        using streaming_store_impl_::streaming_fence;
+        using streaming_store_impl_::streaming_ref;
+    } // namespace stencil
+} // namespace gridtools
+
+#undef GT_STREAMING_STORE_BUILTIN
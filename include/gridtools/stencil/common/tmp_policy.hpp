@@ -0,0 +1,57 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <type_traits>
+
+#include "../../meta.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace tmp_policy {
+            // the temporary is allocated with its data type and fully materialized (the default)
+            struct materialize {};
+            // the temporary is allocated with the `Storage` element type and converted to/from its data type on access
+            template <class Storage>
+            struct store_as {};
+            // the temporary is not allocated: the stage that produces it is inlined into the stages that read it
+            struct recompute {};
+
+            template <class Plh, class = void>
+            struct get_policy {
+                using type = materialize;
+            };
+
+            template <class Plh>
+            struct get_policy<Plh, void_t<typename Plh::policy_t>> {
+                using type = typename Plh::policy_t;
+            };
+
+            template <class Policy, class Data>
+            struct storage_type_f {
+                using type = Data;
+            };
+
+            template <class Storage, class Data>
+            struct storage_type_f<store_as<Storage>, Data> {
+                using type = Storage;
+            };
+
+            /**
+             *  The element type of the temporary `Plh` in memory.
+             */
+            template <class Plh, class Data = typename Plh::data_t>
+            using storage_type = typename storage_type_f<typename get_policy<Plh>::type, Data>::type;
+
+            template <class Plh>
+            using is_recomputed = std::is_same<typename get_policy<Plh>::type, recompute>;
+        } // namespace tmp_policy
+    }     // namespace stencil
+} // namespace gridtools
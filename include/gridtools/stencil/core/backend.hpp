@@ -12,6 +12,7 @@
 #include <cassert>
 #include <functional>
 #include <utility>
+#include <vector>
 
 #include "../../common/for_each.hpp"
 #include "../../common/hymap.hpp"
@@ -33,24 +34,101 @@ namespace gridtools {
                         std::move(data_stores));
                 }
 
+                template <class BeSpec, class Grid>
+                void check_k_sizes(Grid const &grid) {
+#ifndef NDEBUG
+                    for_each<be_api::make_fused_view<BeSpec>>([&](auto matrix) {
+                        for_each<decltype(matrix)>([&](auto info) {
+                            assert(((void)"domain k-size is too small", grid.k_size(info.interval()) >= 0));
+                        });
+                    });
+#endif
+                }
+
                 template <class Spec>
                 struct call_entry_point_f {
                     template <class Backend, class Grid, class DataStores>
                     void operator()(Backend &&be, Grid const &grid, DataStores data_stores) const {
                         using be_spec_t = convert_fe_to_be_spec<Spec, typename Grid::interval_t, DataStores>;
-#ifndef NDEBUG
-                        for_each<be_api::make_fused_view<be_spec_t>>([&](auto matrix) {
-                            for_each<decltype(matrix)>([&](auto info) {
-                                assert(((void)"domain k-size is too small", grid.k_size(info.interval()) >= 0));
-                            });
-                        });
-#endif
+                        check_k_sizes<be_spec_t>(grid);
                         gridtools_backend_entry_point(
                             std::forward<Backend>(be), be_spec_t(), grid, shift_origin(grid, std::move(data_stores)));
                     }
                 };
+
+                /*
+                 *  Backends may provide `gridtools_backend_make_plan(backend, spec, grid, data_stores)` that does all
+                 *  the preparation work of `gridtools_backend_entry_point` (temporaries allocation, composite and
+                 *  strides setup, blocking) once and returns a nullary callable that executes the loops only.
+                 *
+                 *  For the backends that don't provide it, the plan falls back to calling the entry point.
+                 */
+                template <class Backend, class Spec, class Grid, class DataStores>
+                auto make_backend_plan(Backend const &be, Spec, Grid const &grid, DataStores data_stores, int)
+                    -> decltype(gridtools_backend_make_plan(be, Spec(), grid, std::move(data_stores))) {
+                    return gridtools_backend_make_plan(be, Spec(), grid, std::move(data_stores));
+                }
+
+                template <class Backend, class Spec, class Grid, class DataStores>
+                auto make_backend_plan(Backend const &be, Spec, Grid const &grid, DataStores data_stores, long) {
+                    return [be, grid, data_stores = std::move(data_stores)] {
+                        gridtools_backend_entry_point(be, Spec(), grid, data_stores);
+                    };
+                }
+
+                template <class Spec>
+                struct make_plan_f {
+                    template <class Backend, class Grid, class DataStores>
+                    auto operator()(Backend const &be, Grid const &grid, DataStores data_stores) const {
+                        using be_spec_t = convert_fe_to_be_spec<Spec, typename Grid::interval_t, DataStores>;
+                        check_k_sizes<be_spec_t>(grid);
+                        return make_backend_plan(be, be_spec_t(), grid, shift_origin(grid, std::move(data_stores)), 0);
+                    }
+                };
+
+                /*
+                 *  Backends may provide `gridtools_backend_entry_point_batched(backend, spec, grid, members)` where
+                 *  `members` is a `std::vector` of data store maps, one per ensemble member. It should execute all
+                 *  members within a single parallel launch.
+                 *
+                 *  For the backends that don't provide it, the members are executed one by one.
+                 */
+                template <class Backend, class Spec, class Grid, class DataStores>
+                auto call_batched_entry_point(
+                    Backend &&be, Spec, Grid const &grid, std::vector<DataStores> members, int)
+                    -> decltype(gridtools_backend_entry_point_batched(
+                        std::forward<Backend>(be), Spec(), grid, std::move(members))) {
+                    return gridtools_backend_entry_point_batched(
+                        std::forward<Backend>(be), Spec(), grid, std::move(members));
+                }
+
+                template <class Backend, class Spec, class Grid, class DataStores>
+                void call_batched_entry_point(
+                    Backend &&be, Spec, Grid const &grid, std::vector<DataStores> members, long) {
+                    for (auto &&member : members)
+                        gridtools_backend_entry_point(be, Spec(), grid, std::move(member));
+                }
+
+                template <class Spec>
+                struct call_batched_entry_point_f {
+                    template <class Backend, class Grid, class DataStores>
+                    void operator()(Backend &&be, Grid const &grid, std::vector<DataStores> members) const {
+                        using be_spec_t = convert_fe_to_be_spec<Spec, typename Grid::interval_t, DataStores>;
+                        check_k_sizes<be_spec_t>(grid);
+                        if (members.empty())
+                            return;
+                        using shifted_t = decltype(shift_origin(grid, std::move(members.front())));
+                        std::vector<shifted_t> shifted;
+                        shifted.reserve(members.size());
+                        for (auto &&member : members)
+                            shifted.push_back(shift_origin(grid, std::move(member)));
+                        call_batched_entry_point(std::forward<Backend>(be), be_spec_t(), grid, std::move(shifted), 0);
+                    }
+                };
             } // namespace backend_impl_
+            using backend_impl_::call_batched_entry_point_f;
             using backend_impl_::call_entry_point_f;
+            using backend_impl_::make_plan_f;
         } // namespace core
     }     // namespace stencil
 } // namespace gridtools
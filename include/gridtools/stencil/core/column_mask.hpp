@@ -0,0 +1,76 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../../common/defs.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace core {
+            /**
+             *  The set of the active columns of the compute domain (like the sea points of an ocean model).
+             *
+             *  The backends that support it compute only the blocks of the domain that contain at least one active
+             *  column. The other backends compute the whole domain.
+             */
+            class column_mask {
+                int_t m_i_size;
+                int_t m_j_size;
+                std::vector<bool> m_mask;
+
+              public:
+                /**
+                 *  `is_active(i, j)` is called for each column of the `i_size` x `j_size` compute domain, the indices
+                 *  are relative to the origin of the grid.
+                 */
+                template <class Fun>
+                column_mask(int_t i_size, int_t j_size, Fun &&is_active)
+                    : m_i_size(i_size), m_j_size(j_size), m_mask(i_size * j_size) {
+                    for (int_t j = 0; j < j_size; ++j)
+                        for (int_t i = 0; i < i_size; ++i)
+                            m_mask[i + j * i_size] = is_active(i, j);
+                }
+
+                int_t i_size() const { return m_i_size; }
+                int_t j_size() const { return m_j_size; }
+
+                bool operator()(int_t i, int_t j) const { return m_mask[i + j * m_i_size]; }
+
+                bool any(int_t i_begin, int_t i_end, int_t j_begin, int_t j_end) const {
+                    for (int_t j = j_begin; j < std::min(j_end, m_j_size); ++j)
+                        for (int_t i = i_begin; i < std::min(i_end, m_i_size); ++i)
+                            if ((*this)(i, j))
+                                return true;
+                    return false;
+                }
+
+                /**
+                 *  The indices of the blocks of the `i_block_size` x `j_block_size` tiling of the domain that contain
+                 *  active columns, ordered by the i-block first.
+                 */
+                std::vector<std::pair<int_t, int_t>> active_blocks(int_t i_block_size, int_t j_block_size) const {
+                    std::vector<std::pair<int_t, int_t>> res;
+                    for (int_t bi = 0; bi * i_block_size < m_i_size; ++bi)
+                        for (int_t bj = 0; bj * j_block_size < m_j_size; ++bj)
+                            if (any(bi * i_block_size,
+                                    (bi + 1) * i_block_size,
+                                    bj * j_block_size,
+                                    (bj + 1) * j_block_size))
+                                res.emplace_back(bi, bj);
+                    return res;
+                }
+            };
+        } // namespace core
+    }     // namespace stencil
+} // namespace gridtools
@@ -11,6 +11,7 @@
 
 #include "../../common/defs.hpp"
 #include "../../meta.hpp"
+#include "../../sid/convert.hpp"
 #include "../be_api.hpp"
 #include "cache_info.hpp"
 #include "compute_extents_metafunctions.hpp"
@@ -20,6 +21,7 @@
 #include "level.hpp"
 #include "mss.hpp"
 #include "need_sync.hpp"
+#include "recompute_temporaries.hpp"
 #include "stage.hpp"
 
 namespace gridtools {
@@ -29,7 +31,7 @@ namespace gridtools {
                 template <class Plh, class DataStores, bool = is_tmp_arg<Plh>::value>
                 struct get_data_type {
                     using sid_t = decltype(at_key<Plh>(std::declval<DataStores>()));
-                    using type = sid::element_type<sid_t>;
+                    using type = sid::compute_type<sid_t>;
                 };
 
                 template <class Plh, class DataStores>
@@ -83,7 +85,7 @@ namespace gridtools {
                 struct make_esf_row_f {
                     template <class Esf, class NeedSync>
                     using apply = meta::transform<make_cell_f<Msses, DataStores, Mss, Esf, NeedSync>::template apply,
-                        make_functor_map<typename Esf::esf_function_t, Interval>>;
+                        make_esf_functor_map<typename Esf::esf_function_t, Interval>>;
                 };
 
                 template <class Msses, class Interval, class DataStores>
@@ -95,8 +97,11 @@ namespace gridtools {
                 };
 
                 template <class Msses, class Interval, class DataStores>
-                using convert_fe_to_be_spec =
+                using convert_msses =
                     meta::transform<make_mss_matrix_f<Msses, Interval, DataStores>::template apply, Msses>;
+
+                template <class Msses, class Interval, class DataStores>
+                using convert_fe_to_be_spec = convert_msses<recompute_temporaries<Msses>, Interval, DataStores>;
             } // namespace convert_fe_to_be_spec_impl_
             using convert_fe_to_be_spec_impl_::convert_fe_to_be_spec;
         } // namespace core
@@ -235,6 +235,7 @@ namespace gridtools {
             } // namespace functor_metafunctions_impl_
             using functor_metafunctions_impl_::bound_functor;
             using functor_metafunctions_impl_::check_valid_apply_overloads;
+            using functor_metafunctions_impl_::has_apply;
             using functor_metafunctions_impl_::make_functor_map;
         } // namespace core
     }     // namespace stencil
@@ -12,6 +12,7 @@
 #include <cassert>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <type_traits>
 
 #include "../../common/defs.hpp"
@@ -20,6 +21,7 @@
 #include "../../meta.hpp"
 #include "../common/dim.hpp"
 #include "../common/extent.hpp"
+#include "column_mask.hpp"
 #include "execution_types.hpp"
 #include "interval.hpp"
 #include "level.hpp"
@@ -40,6 +42,7 @@ namespace gridtools {
                 int_t m_j_start;
                 int_t m_j_size;
                 int_t m_k_values[meta::second<Interval>::splitter];
+                std::shared_ptr<column_mask const> m_mask;
 
                 template <uint_t Splitter = 0, int_t Offset = start_offset>
                 static integral_constant<int_t, (Offset > 0) ? Offset - 1 : Offset> offset(
@@ -126,6 +129,16 @@ namespace gridtools {
                 auto size() const {
                     return tuple_util::make<hymap::keys<dim::i, dim::j, dim::k>::values>(i_size(), j_size(), k_size());
                 }
+
+                /**
+                 *  The active columns of the domain or `nullptr` if all columns are active.
+                 */
+                column_mask const *mask() const { return m_mask.get(); }
+
+                void set_mask(std::shared_ptr<column_mask const> mask) {
+                    assert(!mask || (mask->i_size() == m_i_size && mask->j_size() == m_j_size));
+                    m_mask = std::move(mask);
+                }
             };
 
             template <class T>
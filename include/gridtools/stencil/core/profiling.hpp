@@ -0,0 +1,149 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+#include <boost/core/demangle.hpp>
+
+#include "../../common/for_each.hpp"
+#include "../../common/profiling.hpp"
+#include "../../meta.hpp"
+#include "../../thread_pool/concept.hpp"
+#include "../be_api.hpp"
+#include "functor_metafunctions.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace core {
+            namespace profiling_impl_ {
+                template <class F>
+                struct unwrap_functor {
+                    using type = F;
+                };
+
+                template <class F, class Param>
+                struct unwrap_functor<bound_functor<F, Param>> {
+                    using type = F;
+                };
+
+                template <class F>
+                using unwrapped_functor = typename unwrap_functor<F>::type;
+
+                struct run_region {
+                    static char const *prefix() { return "run: "; }
+                };
+
+                struct batched_region {
+                    static char const *prefix() { return "run_batched: "; }
+                };
+
+                struct plan_region {
+                    static char const *prefix() { return "plan: "; }
+                };
+
+                struct stage_region {
+                    static char const *prefix() { return "stage: "; }
+                };
+
+                /**
+                 *  The region name made of the prefix of the `Kind` and the list of the functor names.
+                 *  It is computed once per instantiation.
+                 */
+                template <class Kind, class Functors>
+                std::string const &region_name() {
+                    static std::string const res = [] {
+                        std::string res = Kind::prefix();
+                        bool first = true;
+                        for_each<meta::dedup<Functors>>([&](auto f) {
+                            res += first ? "" : ", ";
+                            res += boost::core::demangle(typeid(f).name());
+                            first = false;
+                        });
+                        return res;
+                    }();
+                    return res;
+                }
+
+                template <class Spec>
+                using spec_functors = meta::transform<meta::first, meta::flatten<meta::transform<meta::second, Spec>>>;
+
+                template <class Cell>
+                using cell_functors =
+                    meta::transform<unwrapped_functor, meta::transform<meta::first, be_api::get_funs<Cell>>>;
+
+                template <class Stage>
+                using stage_functors =
+                    meta::flatten<meta::transform<cell_functors, meta::rename<meta::list, typename Stage::cells_t>>>;
+
+                template <class Stage>
+                char const *stage_name() {
+                    return region_name<stage_region, stage_functors<Stage>>().c_str();
+                }
+
+                template <class Stage, class Loop>
+                struct profiled_loop {
+                    Loop m_loop;
+
+                    template <class... Args>
+                    void operator()(Args &&... args) const {
+                        GT_PROFILING_REGION(stage_name<Stage>());
+                        m_loop(std::forward<Args>(args)...);
+                    }
+                };
+
+                template <class ThreadPool, class Stage, class Loop>
+                struct scoped_loop {
+                    Loop m_loop;
+
+                    template <class... Args>
+                    void operator()(Args &&... args) const {
+                        thread_pool::scope(ThreadPool(), &stage_name<Stage>, [&] {
+                            GT_PROFILING_REGION(stage_name<Stage>());
+                            m_loop(std::forward<Args>(args)...);
+                        });
+                    }
+                };
+
+                /**
+                 *  Wraps the loop over the stage into the profiling region named after the functors of the stage.
+                 */
+#ifdef GT_PROFILING
+                template <class Stage, class Loop>
+                profiled_loop<Stage, Loop> profile_stage(Loop loop) {
+                    return {std::move(loop)};
+                }
+#else
+                template <class Stage, class Loop>
+                Loop profile_stage(Loop loop) {
+                    return loop;
+                }
+#endif
+
+                /**
+                 *  The same for the loops run by the `ThreadPool`; they are also run in the thread pool scope of the
+                 *  same name.
+                 */
+                template <class Stage, class ThreadPool, class Loop>
+                scoped_loop<ThreadPool, Stage, Loop> profile_stage(ThreadPool, Loop loop) {
+                    return {std::move(loop)};
+                }
+            } // namespace profiling_impl_
+            using profiling_impl_::batched_region;
+            using profiling_impl_::plan_region;
+            using profiling_impl_::profile_stage;
+            using profiling_impl_::region_name;
+            using profiling_impl_::run_region;
+            using profiling_impl_::spec_functors;
+        } // namespace core
+    }     // namespace stencil
+} // namespace gridtools
@@ -0,0 +1,332 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../../meta.hpp"
+#include "../common/extent.hpp"
+#include "../common/intent.hpp"
+#include "../common/tmp_policy.hpp"
+#include "esf.hpp"
+#include "esf_metafunctions.hpp"
+#include "functor_metafunctions.hpp"
+#include "is_tmp_arg.hpp"
+#include "mss.hpp"
+
+/**
+ *   Inlining of the temporaries declared with `tmp_policy::recompute`.
+ *
+ *   The stage that produces such a temporary is removed from the spec and every stage that reads the temporary is
+ *   fused with it: the parameter of the temporary is replaced by the input parameters of the producer (extended by
+ *   the extent of the temporary parameter) and every read of the temporary evaluates the producer at the offset of
+ *   the read. The temporary is neither allocated nor written, the flops are traded for the bytes.
+ *
+ *   The frontend provides the fused functors and the parameters via ADL `get_recompute(Params...)` (the same way as
+ *   `get_stage`). The interval specific overloads are matched per k-level: the fused functor for the given level
+ *   consists of the consumer and the producer functors for that level.
+ *
+ *   Restrictions (checked at compile time):
+ *     - the temporary is written by a single stage and it is the only output of that stage;
+ *     - the temporary is not read before it is written and it is not modified by the consumers;
+ *     - the inputs of the producer are not modified after the producer;
+ *     - the producer has no interval specific overloads if the temporary is read at the vertical offsets.
+ */
+namespace gridtools {
+    namespace stencil {
+        namespace core {
+            namespace recompute_temporaries_impl_ {
+                template <class>
+                struct meta_recompute;
+
+                template <template <class...> class L, class... Ts>
+                struct meta_recompute<L<Ts...>> : decltype(get_recompute(std::declval<Ts>()...)) {};
+
+                template <class List, class T>
+                using contains = bool_constant<meta::find<List, T>::value != meta::length<List>::value>;
+
+                template <class Consumer,
+                    size_t TmpIndex,
+                    class Producer,
+                    class Data,
+                    class ConsumerIndices,
+                    class ProducerIndices,
+                    class ParamList>
+                struct fused_function {
+                    using param_list = ParamList;
+                    using tmp_extent_t = typename meta::at_c<typename Consumer::param_list, TmpIndex>::extent_t;
+
+                    template <class ConsumerFunctor, class ProducerFunctor>
+                    using functor = typename meta_recompute<ParamList>::template functor<ConsumerFunctor,
+                        TmpIndex,
+                        ProducerFunctor,
+                        Data,
+                        ConsumerIndices,
+                        ProducerIndices,
+                        ParamList>;
+                };
+
+                template <class Fused, class ConsumerItem, class ProducerItem>
+                struct fuse_item;
+
+                template <class Fused, class Key, class... ProducerFunctors>
+                struct fuse_item<Fused, meta::list<Key>, meta::list<Key, ProducerFunctors...>> {
+                    using type = meta::list<Key>;
+                };
+
+                template <class Fused, class Key, class ConsumerFunctor, class ProducerFunctor>
+                struct fuse_item<Fused, meta::list<Key, ConsumerFunctor>, meta::list<Key, ProducerFunctor>> {
+                    using type = meta::list<Key, typename Fused::template functor<ConsumerFunctor, ProducerFunctor>>;
+                };
+
+                template <class Fused, class Key, class ConsumerFunctor>
+                struct fuse_item<Fused, meta::list<Key, ConsumerFunctor>, meta::list<Key>> {
+                    static_assert(sizeof(Key) < 0,
+                        "The recomputed temporary is read within the interval where its producer has no apply() "
+                        "overload.");
+                };
+
+                template <class Fused>
+                struct fuse_item_f {
+                    template <class ConsumerItem, class ProducerItem>
+                    using apply = typename fuse_item<Fused, ConsumerItem, ProducerItem>::type;
+                };
+
+                template <class Function, class Interval>
+                struct functor_map {
+                    using type = make_functor_map<Function, Interval>;
+                };
+
+                template <class Function, class Interval>
+                using make_esf_functor_map = typename functor_map<Function, Interval>::type;
+
+                template <class Consumer,
+                    size_t TmpIndex,
+                    class Producer,
+                    class Data,
+                    class ConsumerIndices,
+                    class ProducerIndices,
+                    class ParamList,
+                    class Interval>
+                struct functor_map<
+                    fused_function<Consumer, TmpIndex, Producer, Data, ConsumerIndices, ProducerIndices, ParamList>,
+                    Interval> {
+                    using fused_t =
+                        fused_function<Consumer, TmpIndex, Producer, Data, ConsumerIndices, ProducerIndices, ParamList>;
+                    using extent_t = typename fused_t::tmp_extent_t;
+                    using producer_map_t = make_esf_functor_map<Producer, Interval>;
+                    using producer_functors_t = meta::dedup<meta::transform<meta::pop_front, producer_map_t>>;
+
+                    static_assert((extent_t::kminus::value == 0 && extent_t::kplus::value == 0) ||
+                                      meta::length<producer_functors_t>::value == 1,
+                        "The producer of the temporary that is recomputed at the vertical offsets should have a single "
+                        "apply() overload for the whole computation interval.");
+
+                    using type = meta::transform<fuse_item_f<fused_t>::template apply,
+                        make_esf_functor_map<Consumer, Interval>,
+                        producer_map_t>;
+                };
+
+                template <class T>
+                struct is_not_f {
+                    template <class U>
+                    using apply = negation<std::is_same<T, U>>;
+                };
+
+                template <class Recompute,
+                    class TmpExtent,
+                    class Arg,
+                    class Index,
+                    class ConsumerItem,
+                    class ProducerItem>
+                struct make_param;
+
+                template <class Recompute, class TmpExtent, class Arg, class Index, class Param>
+                struct make_param<Recompute, TmpExtent, Arg, Index, meta::list<Arg, Param>, void> {
+                    using type = typename Recompute::
+                        template param<Index::value, Param::intent_v, typename Param::extent_t, Param>;
+                };
+
+                template <class Recompute, class TmpExtent, class Arg, class Index, class Param>
+                struct make_param<Recompute, TmpExtent, Arg, Index, void, meta::list<Arg, Param>> {
+                    using type = typename Recompute::template param<Index::value,
+                        intent::in,
+                        sum_extent<TmpExtent, typename Param::extent_t>,
+                        Param>;
+                };
+
+                template <class Recompute,
+                    class TmpExtent,
+                    class Arg,
+                    class Index,
+                    class ConsumerParam,
+                    class ProducerParam>
+                struct make_param<Recompute,
+                    TmpExtent,
+                    Arg,
+                    Index,
+                    meta::list<Arg, ConsumerParam>,
+                    meta::list<Arg, ProducerParam>> {
+                    using type = typename Recompute::template param<Index::value,
+                        ConsumerParam::intent_v,
+                        enclosing_extent<typename ConsumerParam::extent_t,
+                            sum_extent<TmpExtent, typename ProducerParam::extent_t>>,
+                        ConsumerParam,
+                        ProducerParam>;
+                };
+
+                template <class Recompute, class TmpExtent, class ConsumerMap, class ProducerMap>
+                struct make_param_f {
+                    template <class Arg, class Index>
+                    using apply = typename make_param<Recompute,
+                        TmpExtent,
+                        Arg,
+                        Index,
+                        meta::mp_find<ConsumerMap, Arg>,
+                        meta::mp_find<ProducerMap, Arg>>::type;
+                };
+
+                template <class Args>
+                struct position_f {
+                    template <class Arg>
+                    using apply = std::integral_constant<size_t, meta::find<Args, Arg>::value>;
+                };
+
+                template <class Plh, class Producer, class Consumer>
+                struct fuse_esfs {
+                    using consumer_args_t = typename Consumer::args_t;
+                    using consumer_params_t = esf_param_list<Consumer>;
+                    using producer_args_t = typename Producer::args_t;
+                    using producer_params_t = esf_param_list<Producer>;
+
+                    static constexpr size_t tmp_index = meta::find<consumer_args_t, Plh>::value;
+                    using tmp_param_t = meta::at_c<consumer_params_t, tmp_index>;
+                    static_assert(tmp_param_t::intent_v == intent::in,
+                        "The recomputed temporary can be modified only by its producer.");
+
+                    using args_t =
+                        meta::dedup<meta::concat<meta::filter<is_not_f<Plh>::template apply, consumer_args_t>,
+                            meta::filter<is_not_f<Plh>::template apply, producer_args_t>>>;
+
+                    using params_t = meta::transform<make_param_f<meta_recompute<consumer_params_t>,
+                                                         typename tmp_param_t::extent_t,
+                                                         meta::zip<consumer_args_t, consumer_params_t>,
+                                                         meta::zip<producer_args_t, producer_params_t>>::template apply,
+                        args_t,
+                        meta::make_indices_for<args_t>>;
+
+                    using function_t = fused_function<typename Consumer::esf_function_t,
+                        tmp_index,
+                        typename Producer::esf_function_t,
+                        typename Plh::data_t,
+                        meta::transform<position_f<args_t>::template apply, consumer_args_t>,
+                        meta::transform<position_f<args_t>::template apply, producer_args_t>,
+                        params_t>;
+
+                    using type = esf_descriptor<function_t, args_t, typename Consumer::extent_t>;
+                };
+
+                template <class Plh, class Producer>
+                struct fuse_esf_f {
+                    template <class Esf>
+                    using apply = typename meta::if_<contains<typename Esf::args_t, Plh>,
+                        fuse_esfs<Plh, Producer, Esf>,
+                        meta::lazy::id<Esf>>::type;
+                };
+
+                template <class Plh>
+                struct is_not_cache_of_f {
+                    template <class CacheInfo>
+                    using apply = negation<std::is_same<typename CacheInfo::plh_t, Plh>>;
+                };
+
+                template <class Plh, class Producer>
+                struct recompute_in_mss_f {
+                    template <class Mss>
+                    using apply = mss_descriptor<typename Mss::execution_engine_t,
+                        meta::transform<fuse_esf_f<Plh, Producer>::template apply,
+                            meta::filter<is_not_f<Producer>::template apply, typename Mss::esf_sequence_t>>,
+                        meta::filter<is_not_cache_of_f<Plh>::template apply, typename Mss::cache_map_t>>;
+                };
+
+                template <class Plh>
+                struct writes_f {
+                    template <class Esf>
+                    using apply = contains<esf_get_w_args_per_functor<Esf>, Plh>;
+                };
+
+                template <class Plh>
+                struct reads_f {
+                    template <class Esf>
+                    using apply = contains<typename Esf::args_t, Plh>;
+                };
+
+                template <class Esf>
+                struct is_written_by_f {
+                    template <class Arg>
+                    using apply = contains<esf_get_w_args_per_functor<Esf>, Arg>;
+                };
+
+                template <class Args>
+                struct writes_any_of_f {
+                    template <class Esf>
+                    using apply = meta::any_of<is_written_by_f<Esf>::template apply, Args>;
+                };
+
+                template <class Mss>
+                using get_esfs = typename Mss::esf_sequence_t;
+
+                template <class Mss>
+                using has_esfs = negation<meta::is_empty<get_esfs<Mss>>>;
+
+                template <class Msses, class Plh>
+                struct recompute_plh {
+                    using esfs_t = meta::flatten<meta::transform<get_esfs, Msses>>;
+                    using producers_t = meta::filter<writes_f<Plh>::template apply, esfs_t>;
+                    static_assert(meta::length<producers_t>::value == 1,
+                        "The recomputed temporary should be written by exactly one stage.");
+                    using producer_t = meta::first<producers_t>;
+                    static_assert(meta::length<esf_get_w_args_per_functor<producer_t>>::value == 1,
+                        "The stage that produces the recomputed temporary should have no other outputs.");
+
+                    static constexpr size_t pos = meta::find<esfs_t, producer_t>::value;
+                    static_assert(!meta::any_of<reads_f<Plh>::template apply, meta::take_c<pos, esfs_t>>::value,
+                        "The recomputed temporary is read before it is written.");
+                    static_assert(!meta::any_of<writes_any_of_f<meta::filter<is_not_f<Plh>::template apply,
+                                                    typename producer_t::args_t>>::template apply,
+                                      meta::drop_front_c<pos + 1, esfs_t>>::value,
+                        "The inputs of the stage that produces the recomputed temporary should not be modified after "
+                        "it.");
+
+                    using type = meta::filter<has_esfs,
+                        meta::transform<recompute_in_mss_f<Plh, producer_t>::template apply, Msses>>;
+                };
+
+                template <class Msses, class Plh>
+                using recompute_plh_t = typename recompute_plh<Msses, Plh>::type;
+
+                template <class Esf>
+                using get_args = typename Esf::args_t;
+
+                template <class Plh>
+                using is_recomputed = conjunction<is_tmp_arg<Plh>, tmp_policy::is_recomputed<Plh>>;
+
+                template <class Msses,
+                    class Esfs = meta::flatten<meta::transform<get_esfs, Msses>>,
+                    class Plhs = meta::dedup<meta::flatten<meta::transform<get_args, Esfs>>>>
+                using recompute_temporaries = meta::foldl<recompute_plh_t, Msses, meta::filter<is_recomputed, Plhs>>;
+            } // namespace recompute_temporaries_impl_
+            using recompute_temporaries_impl_::make_esf_functor_map;
+            using recompute_temporaries_impl_::recompute_temporaries;
+        } // namespace core
+    }     // namespace stencil
+} // namespace gridtools
@@ -0,0 +1,260 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ *   @file
+ *
+ *   Static cost model of the stencil computations.
+ *
+ *   `cost_model` is a backend that doesn't execute anything. It walks the fused view of the spec (the same one that
+ *   `dump` emits) and writes the JSON report of the predicted costs for the given grid and blocking:
+ *
+ *     run(spec, cost_model{std::cout, 64, 8}, grid, fields...);
+ *
+ *   The parameters are:
+ *     - the sink;
+ *     - the horizontal block sizes. Zero means that the dimension is not blocked;
+ *     - the cache size in bytes the working set is checked against (L2 by default);
+ *     - whether the cached temporaries are materialized (as the backends without the software caches do).
+ *
+ *   For every kernel (multi stage) and every stage the report contains:
+ *     - `points`: the number of the computed points including the redundant computations on the block halos;
+ *     - `redundant_points`: the part of `points` that is computed more than once because the halos of the
+ *       neighboring blocks overlap;
+ *     - `bytes_read` and `bytes_written`: the main memory traffic assuming perfect reuse within the stage.
+ *       All fields are read within the accessor extents: the non const ones too, because of the read-modify-write
+ *       or the write-allocate of the cache lines. The non const fields are written once per unique computed point,
+ *       the redundant computations on the block halos don't add the writes. IJ-cached temporaries produce no
+ *       traffic, K-cached ones produce the traffic of their fill/flush policies;
+ *     - `flops`: if the functor declares `static constexpr int flops = <flops per point>;`.
+ *   Every kernel also reports the footprint of the materialized temporaries (per block and for the whole domain)
+ *   and the working set of one k-level of a block; `exceeds_cache` is set if the working set doesn't fit the cache.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+#include <nlohmann/json.hpp>
+
+#include "../common/defs.hpp"
+#include "../common/for_each.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "be_api.hpp"
+#include "common/caches.hpp"
+#include "common/dim.hpp"
+#include "dump.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace cost_model_backend {
+            using nlohmann::json;
+
+            template <class Fun, class = void>
+            struct flops_per_point : std::integral_constant<int, -1> {};
+
+            template <class Fun>
+            struct flops_per_point<Fun, std::enable_if_t<std::is_integral<decltype(Fun::flops)>::value>>
+                : std::integral_constant<int, Fun::flops> {};
+
+            template <class FunCall>
+            using fun_call_flops = flops_per_point<meta::first<FunCall>>;
+
+            template <class Caches, class Cache>
+            using has_cache = meta::st_contains<Caches, Cache>;
+
+            struct domain {
+                int_t ni;
+                int_t nj;
+                int_t block_i;
+                int_t block_j;
+
+                int_t blocks(int_t n, int_t block) const { return (n + block - 1) / block; }
+                int_t blocks_i() const { return blocks(ni, block_i); }
+                int_t blocks_j() const { return blocks(nj, block_j); }
+
+                // the number of the points in ij-plane that are visited in all blocks with the given extent
+                template <class Extent>
+                double ij_points(Extent extent) const {
+                    return (ni + (double)blocks_i() * (extent.plus(dim::i()) - extent.minus(dim::i()))) *
+                           (nj + (double)blocks_j() * (extent.plus(dim::j()) - extent.minus(dim::j())));
+                }
+
+                template <class Extent>
+                double block_points(Extent extent) const {
+                    return double(extent.extend(dim::i(), block_i)) * extent.extend(dim::j(), block_j);
+                }
+            };
+
+            struct totals {
+                double points = 0;
+                double redundant_points = 0;
+                double bytes_read = 0;
+                double bytes_written = 0;
+                double flops = 0;
+                double temporary_bytes = 0;
+
+                void add(json const &stage) {
+                    points += stage["points"].get<double>();
+                    redundant_points += stage["redundant_points"].get<double>();
+                    bytes_read += stage["bytes_read"].get<double>();
+                    bytes_written += stage["bytes_written"].get<double>();
+                    if (stage.contains("flops"))
+                        flops += stage["flops"].get<double>();
+                }
+
+                json to_json() const {
+                    return {{"points", points},
+                        {"redundant_points", redundant_points},
+                        {"bytes_read", bytes_read},
+                        {"bytes_written", bytes_written},
+                        {"flops", flops},
+                        {"temporary_bytes", temporary_bytes}};
+                }
+            };
+
+            struct cost_model {
+                std::ostream &m_sink;
+                int_t m_block_i = 0;
+                int_t m_block_j = 0;
+                size_t m_cache_size = 1 << 20;
+                bool m_materialize_caches = false;
+
+                // a placeholder produces no traffic if it lives in the ij-cache
+                template <class Info>
+                bool is_ij_cached(Info) const {
+                    return !m_materialize_caches && has_cache<typename Info::caches_t, cache_type::ij>::value;
+                }
+
+                template <class Info>
+                bool is_k_cached(Info) const {
+                    return !m_materialize_caches && has_cache<typename Info::caches_t, cache_type::k>::value;
+                }
+
+                template <class Info>
+                static bool has_policy(Info, cache_io_policy::fill p) {
+                    return meta::st_contains<typename Info::cache_io_policies_t, decltype(p)>::value;
+                }
+
+                template <class Info>
+                static bool has_policy(Info, cache_io_policy::flush p) {
+                    return meta::st_contains<typename Info::cache_io_policies_t, decltype(p)>::value;
+                }
+
+                template <class Cell, class Grid>
+                json stage_report(Cell cell, Grid const &grid, domain const &dom) const {
+                    using funs_t = typename Cell::funs_t;
+                    auto interval = cell.interval();
+                    double k_size = grid.k_size(interval);
+                    double points = dom.ij_points(cell.extent()) * k_size;
+                    double unique_points = double(grid.i_size(cell.extent())) * grid.j_size(cell.extent()) * k_size;
+                    double bytes_read = 0;
+                    double bytes_written = 0;
+                    tuple_util::for_each(
+                        [&](auto info) {
+                            if (is_ij_cached(info))
+                                return;
+                            double size = sizeof(be_api::tmp_storage_type<decltype(info)>);
+                            if (info.is_tmp())
+                                size *= std::max(int(info.num_colors()), 1);
+                            bool k_cached = is_k_cached(info);
+                            if (!k_cached || has_policy(info, cache_io_policy::fill()))
+                                bytes_read += size * dom.ij_points(info.extent()) *
+                                              (k_cached ? k_size : grid.k_size(interval, info.extent()));
+                            if (k_cached ? has_policy(info, cache_io_policy::flush()) : !info.is_const())
+                                bytes_written += size * unique_points;
+                        },
+                        cell.plh_map());
+                    json res = {{"functors", json::array()},
+                        {"interval", dump_backend::from(interval)},
+                        {"extent", dump_backend::from(cell.extent())},
+                        {"points", points},
+                        {"redundant_points", points - unique_points},
+                        {"bytes_read", bytes_read},
+                        {"bytes_written", bytes_written}};
+                    for_each<funs_t>(
+                        [&](auto fun_call) { res["functors"].push_back(dump_backend::from_fun_call(fun_call)); });
+                    double flops = 0;
+                    bool has_flops = true;
+                    for_each<meta::transform<fun_call_flops, funs_t>>([&](auto f) {
+                        has_flops = has_flops && decltype(f)::value >= 0;
+                        flops += decltype(f)::value;
+                    });
+                    if (has_flops)
+                        res["flops"] = flops * points;
+                    return res;
+                }
+
+                template <class Item, class Grid>
+                json kernel_report(Item item, Grid const &grid, domain const &dom, totals &total) const {
+                    json stages = json::array();
+                    tuple_util::for_each(
+                        [&](auto interval_info) {
+                            tuple_util::for_each(
+                                [&](auto cell) {
+                                    auto stage = stage_report(cell, grid, dom);
+                                    total.add(stage);
+                                    stages.push_back(std::move(stage));
+                                },
+                                interval_info.cells());
+                        },
+                        item.interval_infos());
+                    json temporaries = json::array();
+                    double working_set = 0;
+                    for_each<typename Item::plh_map_t>([&](auto info) {
+                        double size = sizeof(be_api::tmp_storage_type<decltype(info)>);
+                        if (info.is_tmp())
+                            size *= std::max(int(info.num_colors()), 1);
+                        auto extent = info.extent();
+                        working_set += size * dom.block_points(extent);
+                        if (!info.is_tmp() || is_ij_cached(info) || is_k_cached(info))
+                            return;
+                        double k_size = grid.k_size(item.interval(), extent);
+                        double bytes = size * grid.i_size(extent) * grid.j_size(extent) * k_size;
+                        total.temporary_bytes += bytes;
+                        temporaries.push_back({{"plh", dump_backend::from_plh(info.plh())},
+                            {"bytes_per_block", size * dom.block_points(extent) * k_size},
+                            {"bytes", bytes}});
+                    });
+                    return {{"execution", dump_backend::from(item.execution())},
+                        {"stages", std::move(stages)},
+                        {"temporaries", std::move(temporaries)},
+                        {"working_set_per_block", working_set},
+                        {"exceeds_cache", working_set > m_cache_size}};
+                }
+
+                template <class Spec, class Grid, class DataStores>
+                friend void gridtools_backend_entry_point(cost_model obj, Spec, Grid const &grid, DataStores &&) {
+                    domain dom = {grid.i_size(),
+                        grid.j_size(),
+                        obj.m_block_i > 0 ? std::min(obj.m_block_i, grid.i_size()) : grid.i_size(),
+                        obj.m_block_j > 0 ? std::min(obj.m_block_j, grid.j_size()) : grid.j_size()};
+                    totals total;
+                    json kernels = json::array();
+                    for_each<be_api::make_fused_view<Spec>>(
+                        [&](auto item) { kernels.push_back(obj.kernel_report(item, grid, dom, total)); });
+                    json res = {{"domain", {{"i", dom.ni}, {"j", dom.nj}, {"k", grid.k_size()}}},
+                        {"block", {{"i", dom.block_i}, {"j", dom.block_j}}},
+                        {"blocks", dom.blocks_i() * dom.blocks_j()},
+                        {"cache_size", obj.m_cache_size},
+                        {"materialize_caches", obj.m_materialize_caches},
+                        {"kernels", std::move(kernels)},
+                        {"total", total.to_json()}};
+                    obj.m_sink << res << std::endl;
+                }
+            };
+        } // namespace cost_model_backend
+        using cost_model_backend::cost_model;
+    } // namespace stencil
+} // namespace gridtools
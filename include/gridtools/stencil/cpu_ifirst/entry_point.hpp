@@ -9,7 +9,10 @@
  */
 #pragma once
 
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../../common/defs.hpp"
 #include "../../common/hymap.hpp"
@@ -20,9 +23,13 @@
 #include "../../sid/block.hpp"
 #include "../../sid/composite.hpp"
 #include "../../sid/concept.hpp"
+#include "../../thread_pool/concept.hpp"
 #include "../../thread_pool/omp.hpp"
 #include "../be_api.hpp"
 #include "../common/dim.hpp"
+#include "../common/extent.hpp"
+#include "../common/streaming_store.hpp"
+#include "../core/profiling.hpp"
 #include "execinfo.hpp"
 #include "loops.hpp"
 #include "pos3.hpp"
@@ -31,59 +38,221 @@
 namespace gridtools {
     namespace stencil {
         namespace cpu_ifirst_backend {
+            template <class ThreadPool, class AllParallel, class Loops>
+            struct plan_f {
+                tmp_allocator m_alloc;
+                execinfo m_info;
+                int_t m_k_size;
+                Loops m_loops;
+                // the number of threads the blocking and the temporaries are made for
+                int_t m_max_threads;
+                bool m_masked;
+                std::vector<std::pair<int_t, int_t>> m_active_blocks;
+
+                void operator()() const {
+                    if (thread_pool::get_max_threads(ThreadPool()) > m_max_threads)
+                        throw std::runtime_error("gridtools::stencil::cpu_ifirst: the plan was created for fewer "
+                                                 "threads than the thread pool has now, recreate the plan.");
+                    if (m_masked)
+                        run_active_loops<ThreadPool>(AllParallel(), m_info, m_k_size, m_active_blocks, m_loops);
+                    else
+                        run_loops<ThreadPool>(AllParallel(), m_info, m_k_size, m_loops);
+                }
+            };
+
+            // the tiles of the masked grids: the rows are long enough to vectorize, short enough to skip the land
+            constexpr int_t masked_i_block_size = 64;
+            constexpr int_t masked_j_block_size = 8;
+
+            template <class ThreadPool, class Grid>
+            execinfo make_execinfo(Grid const &grid) {
+                if (grid.mask())
+                    return {grid, masked_i_block_size, masked_j_block_size};
+                return {ThreadPool(), grid};
+            }
+
+            // the blocks that have the active columns of the masked grid, empty if the grid is not masked
+            template <class Grid>
+            std::vector<std::pair<int_t, int_t>> active_blocks(Grid const &grid, execinfo const &info) {
+                if (!grid.mask())
+                    return {};
+                return grid.mask()->active_blocks(info.i_block_size(), info.j_block_size());
+            }
+
+            template <class Spec>
+            using all_parallel = typename meta::all_of<be_api::is_parallel,
+                meta::transform<be_api::get_execution, be_api::make_split_view<Spec>>>::type;
+
+            template <class Row>
+            using row_plh_map = meta::rename<be_api::merge_plh_maps, meta::transform<be_api::get_plh_map, Row>>;
+
+            template <class Info>
+            using is_streaming_candidate = conjunction<negation<be_api::get_is_tmp<Info>>,
+                negation<be_api::get_is_const<Info>>,
+                std::is_same<be_api::get_extent<Info>, extent<>>>;
+
+            template <class Keys>
+            struct is_unique_f {
+                template <class Key>
+                using apply = bool_constant<meta::length<meta::filter<meta::curry<std::is_same, Key>::template apply,
+                                                Keys>>::value == 1>;
+            };
+
+            template <class Cell>
+            using cell_write_only_keys =
+                meta::flatten<meta::transform<be_api::get_write_only_keys, be_api::get_funs<Cell>>>;
+
+            template <class Spec>
+            using spec_write_only_keys =
+                meta::dedup<meta::flatten<meta::transform<cell_write_only_keys, meta::flatten<meta::flatten<Spec>>>>>;
+
+            /**
+             *  The keys of the external fields that are written with the streaming stores: the stages declare them
+             *  write only, and they are accessed with zero extent by a single stage of the spec, so no other stage
+             *  reads them either.
+             */
+            template <class Spec,
+                class PlhMaps = meta::transform<row_plh_map, meta::flatten<Spec>>,
+                class AllKeys = meta::transform<be_api::get_key, meta::flatten<PlhMaps>>,
+                class WriteOnlyKeys = spec_write_only_keys<Spec>,
+                class Candidates =
+                    meta::transform<be_api::get_key, meta::filter<is_streaming_candidate, meta::flatten<PlhMaps>>>>
+            using streaming_keys = meta::filter<is_unique_f<AllKeys>::template apply,
+                meta::filter<meta::curry<meta::st_contains, WriteOnlyKeys>::template apply, Candidates>>;
+
+            /**
+             *  The fields of `Keys` are written with the streaming stores. `fence` is called by the thread at the end
+             *  of each block.
+             */
+            template <class Keys>
+            struct deref_f {
+                template <class Key,
+                    class T,
+                    std::enable_if_t<meta::st_contains<Keys, Key>::value && !std::is_const<T>::value &&
+                                         is_streamable<T>::value,
+                        int> = 0>
+                GT_FORCE_INLINE streaming_ref<T> operator()(Key, T *ptr) const {
+                    return streaming_ref<T>(ptr);
+                }
+
+                template <class Key, class Ptr>
+                GT_FORCE_INLINE decltype(auto) operator()(Key, Ptr ptr) const {
+                    return *ptr;
+                }
+
+                static void fence() {
+                    if (!meta::is_empty<Keys>::value)
+                        streaming_fence();
+                }
+            };
+
+            template <class ThreadPool, class Spec, class Grid>
+            auto make_temporaries(Spec, Grid const &grid, execinfo const &info, tmp_allocator &alloc) {
+                using stages_t = be_api::make_split_view<Spec>;
+                using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
+                return be_api::make_data_stores(tmp_plh_map_t(),
+                    [&alloc,
+                        block_size = make_pos3(
+                            (size_t)info.i_block_size(), (size_t)info.j_block_size(), (size_t)grid.k_size())](
+                        auto info) {
+                        return be_api::convert_tmp_storage(info,
+                            make_tmp_storage<be_api::tmp_storage_type<decltype(info)>,
+                                decltype(info.extent()),
+                                all_parallel<Spec>::value,
+                                ThreadPool>(alloc, block_size));
+                    });
+            }
+
+            template <class ThreadPool, class Spec, class Grid, class DataStores, class Temporaries>
+            auto make_loops(Spec,
+                Grid const &grid,
+                execinfo const &info,
+                DataStores external_data_stores,
+                Temporaries temporaries) {
+                using stages_t = be_api::make_split_view<Spec>;
+
+                auto blocked_externals = tuple_util::transform(
+                    [block_size = tuple_util::make<hymap::keys<dim::i, dim::j>::values>(
+                         info.i_block_size(), info.j_block_size())](auto &&data_store) {
+                        return sid::block(std::forward<decltype(data_store)>(data_store), block_size);
+                    },
+                    std::move(external_data_stores));
+
+                auto data_stores = hymap::concat(std::move(blocked_externals), std::move(temporaries));
+
+                return tuple_util::transform(
+                    [&](auto stage) {
+                        using stage_t = decltype(stage);
+                        auto k_sizes = tuple_util::transform(
+                            [&](auto cell) { return grid.k_size(cell.interval()); }, stage_t::cells());
+
+                        using plh_map_t = typename stage_t::plh_map_t;
+                        using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
+                        auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
+                            [&](auto info) {
+                                return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores));
+                            },
+                            stage_t::plh_map()));
+                        return core::profile_stage<stage_t>(ThreadPool(),
+                            make_loop<ThreadPool, stage_t, deref_f<streaming_keys<Spec>>>(
+                                all_parallel<Spec>(), grid, std::move(composite), std::move(k_sizes)));
+                    },
+                    meta::rename<tuple, stages_t>());
+            }
+
             template <class ThreadPool = thread_pool::omp>
             struct cpu_ifirst {
                 template <class Spec, class Grid, class DataStores>
-                friend void gridtools_backend_entry_point(
+                friend auto gridtools_backend_make_plan(
                     cpu_ifirst, Spec, Grid const &grid, DataStores external_data_stores) {
-                    using stages_t = be_api::make_split_view<Spec>;
-                    using all_parrallel_t = typename meta::all_of<be_api::is_parallel,
-                        meta::transform<be_api::get_execution, stages_t>>::type;
+                    tmp_allocator alloc;
+                    auto info = make_execinfo<ThreadPool>(grid);
+                    auto loops = make_loops<ThreadPool>(Spec(),
+                        grid,
+                        info,
+                        std::move(external_data_stores),
+                        make_temporaries<ThreadPool>(Spec(), grid, info, alloc));
+                    return plan_f<ThreadPool, all_parallel<Spec>, decltype(loops)>{
+                        std::move(alloc),
+                        info,
+                        grid.k_size(),
+                        std::move(loops),
+                        thread_pool::get_max_threads(ThreadPool()),
+                        grid.mask() != nullptr,
+                        active_blocks(grid, info)};
+                }
 
+                template <class Spec, class Grid, class DataStores>
+                friend void gridtools_backend_entry_point(
+                    cpu_ifirst be, Spec, Grid const &grid, DataStores external_data_stores) {
+                    gridtools_backend_make_plan(be, Spec(), grid, std::move(external_data_stores))();
+                }
+
+                /**
+                 *  Runs the same spec over several independent sets of fields (ensemble members).
+                 *  Members are an additional outer dimension of the parallel loop; the temporaries are indexed by
+                 *  thread and therefore shared by all members.
+                 */
+                template <class Spec, class Grid, class DataStores>
+                friend void gridtools_backend_entry_point_batched(
+                    cpu_ifirst, Spec, Grid const &grid, std::vector<DataStores> members) {
                     tmp_allocator alloc;
+                    auto info = make_execinfo<ThreadPool>(grid);
+                    auto temporaries = make_temporaries<ThreadPool>(Spec(), grid, info, alloc);
 
-                    execinfo info(ThreadPool(), grid);
+                    using loops_t = decltype(
+                        make_loops<ThreadPool>(Spec(), grid, info, std::move(members.front()), temporaries));
+                    std::vector<loops_t> loops;
+                    loops.reserve(members.size());
+                    for (auto &&member : members)
+                        loops.push_back(make_loops<ThreadPool>(Spec(), grid, info, std::move(member), temporaries));
 
-                    using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-                    auto temporaries = be_api::make_data_stores(tmp_plh_map_t(),
-                        [&alloc,
-                            block_size = make_pos3(
-                                (size_t)info.i_block_size(), (size_t)info.j_block_size(), (size_t)grid.k_size())](
-                            auto info) {
-                            return make_tmp_storage<decltype(info.data()),
-                                decltype(info.extent()),
-                                all_parrallel_t::value,
-                                ThreadPool>(alloc, block_size);
-                        });
-
-                    auto blocked_externals = tuple_util::transform(
-                        [block_size = tuple_util::make<hymap::keys<dim::i, dim::j>::values>(
-                             info.i_block_size(), info.j_block_size())](auto &&data_store) {
-                            return sid::block(std::forward<decltype(data_store)>(data_store), block_size);
-                        },
-                        std::move(external_data_stores));
-
-                    auto data_stores = hymap::concat(std::move(blocked_externals), std::move(temporaries));
-
-                    auto loops = tuple_util::transform(
-                        [&](auto stage) {
-                            using stage_t = decltype(stage);
-                            auto k_sizes = tuple_util::transform(
-                                [&](auto cell) { return grid.k_size(cell.interval()); }, stage_t::cells());
-
-                            using plh_map_t = typename stage_t::plh_map_t;
-                            using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
-                            auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
-                                [&](auto info) {
-                                    return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores));
-                                },
-                                stage_t::plh_map()));
-                            return make_loop<ThreadPool, stage_t>(
-                                all_parrallel_t(), grid, std::move(composite), std::move(k_sizes));
-                        },
-                        meta::rename<tuple, stages_t>());
-
-                    run_loops<ThreadPool>(all_parrallel_t(), grid, std::move(loops));
+                    if (grid.mask()) {
+                        run_batched_active_loops<ThreadPool>(
+                            all_parallel<Spec>(), info, grid.k_size(), active_blocks(grid, info), loops);
+                        return;
+                    }
+                    run_batched_loops<ThreadPool>(all_parallel<Spec>(), info, grid.k_size(), loops);
                 }
             };
         } // namespace cpu_ifirst_backend
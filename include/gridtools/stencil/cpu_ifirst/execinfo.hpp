@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "../../common/defs.hpp"
 #include "../../common/host_device.hpp"
 #include "../../thread_pool/concept.hpp"
@@ -71,6 +73,20 @@ namespace gridtools {
                     assert(m_i_block_size > 0 && m_j_block_size > 0);
                 }
 
+                /**
+                 * @brief The tiling of the grid into the blocks of the given size (used for the masked grids, where
+                 * only the blocks with the active columns are executed).
+                 */
+                template <class Grid>
+                GT_FORCE_INLINE execinfo(const Grid &grid, int_t i_block_size, int_t j_block_size)
+                    : m_i_grid_size(grid.i_size()), m_j_grid_size(grid.j_size()),
+                      m_i_block_size(std::min(i_block_size, m_i_grid_size)),
+                      m_j_block_size(std::min(j_block_size, m_j_grid_size)) {
+                    assert(m_i_block_size > 0 && m_j_block_size > 0);
+                    m_i_blocks = (m_i_grid_size + m_i_block_size - 1) / m_i_block_size;
+                    m_j_blocks = (m_j_grid_size + m_j_block_size - 1) / m_j_block_size;
+                }
+
                 /**
                  * @brief Computes the effective (clamped) block size and position for k-serial stencils.
                  *
@@ -104,6 +120,30 @@ namespace gridtools {
                         clamped_block_size(m_j_grid_size, j_block_index, m_j_block_size, m_j_blocks)};
                 }
 
+                /**
+                 * @brief The same for the i-block that spans the subrange `[i_begin, i_end)` of the grid, as passed by
+                 * `thread_pool::parallel_for_range` with the grain `i_block_size()`.
+                 */
+                GT_FORCE_INLINE execinfo_block_kserial block_range(
+                    int_t i_begin, int_t i_end, int_t j_block_index) const {
+                    return {i_begin / m_i_block_size,
+                        j_block_index,
+                        i_end - i_begin,
+                        clamped_block_size(m_j_grid_size, j_block_index, m_j_block_size, m_j_blocks)};
+                }
+
+                GT_FORCE_INLINE execinfo_block_kparallel block_range(
+                    int_t i_begin, int_t i_end, int_t j_block_index, int_t k) const {
+                    return {i_begin / m_i_block_size,
+                        j_block_index,
+                        k,
+                        i_end - i_begin,
+                        clamped_block_size(m_j_grid_size, j_block_index, m_j_block_size, m_j_blocks)};
+                }
+
+                /** @brief Grid size along i-axis. */
+                GT_FORCE_INLINE int_t i_size() const { return m_i_grid_size; }
+
                 /** @brief Number of blocks along i-axis. */
                 GT_FORCE_INLINE int_t i_blocks() const { return m_i_blocks; }
                 /** @brief Number of blocks along j-axis. */
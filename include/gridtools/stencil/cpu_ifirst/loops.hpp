@@ -11,10 +11,12 @@
 
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../../common/defs.hpp"
 #include "../../common/for_each.hpp"
 #include "../../common/omp.hpp"
+#include "../../common/profiling.hpp"
 #include "../../common/tuple_util.hpp"
 #include "../../meta.hpp"
 #include "../../sid/concept.hpp"
@@ -26,18 +28,18 @@ namespace gridtools {
     namespace stencil {
         namespace cpu_ifirst_backend {
             namespace loops_impl_ {
-                template <class Stage, class Ptr, class Strides>
+                template <class Deref, class Stage, class Ptr, class Strides>
                 GT_FORCE_INLINE void i_loop(int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
 #pragma omp simd
                     for (int_t i = 0; i < size; ++i) {
                         using namespace literals;
-                        stage(ptr, strides);
+                        stage.template operator()<Deref>(ptr, strides);
                         sid::shift(ptr, sid::get_stride<dim::i>(strides), 1_c);
                     }
                     sid::shift(ptr, sid::get_stride<dim::i>(strides), -size);
                 }
 
-                template <class Ptr, class Strides>
+                template <class Deref, class Ptr, class Strides>
                 struct k_i_loops_f {
                     int_t m_i_size;
                     Ptr &m_ptr;
@@ -46,19 +48,19 @@ namespace gridtools {
                     template <class Cell, class KSize>
                     GT_FORCE_INLINE void operator()(Cell cell, KSize k_size) const {
                         for (int_t k = 0; k < k_size; ++k) {
-                            i_loop(m_i_size, cell, m_ptr, m_strides);
+                            i_loop<Deref>(m_i_size, cell, m_ptr, m_strides);
                             cell.inc_k(m_ptr, m_strides);
                         }
                     }
                 };
 
-                template <class Ptr, class Strides>
-                GT_FORCE_INLINE k_i_loops_f<Ptr, Strides> make_k_i_loops(
+                template <class Deref, class Ptr, class Strides>
+                GT_FORCE_INLINE k_i_loops_f<Deref, Ptr, Strides> make_k_i_loops(
                     int_t i_size, Ptr &ptr, Strides const &strides) {
                     return {i_size, ptr, strides};
                 }
 
-                template <class ThreadPool, class Stage, class Grid, class Composite, class KSizes>
+                template <class ThreadPool, class Stage, class Deref, class Grid, class Composite, class KSizes>
                 auto make_loop(std::true_type, Grid const &grid, Composite composite, KSizes k_sizes) {
                     using extent_t = typename Stage::extent_t;
                     using ptr_diff_t = sid::ptr_diff_type<Composite>;
@@ -87,32 +89,32 @@ namespace gridtools {
                             tuple_util::for_each(
                                 [&ptr, &strides, &cur, k = info.k, i_size](auto cell, auto k_size) {
                                     if (k >= cur && k < cur + k_size)
-                                        i_loop(i_size, cell, ptr, strides);
+                                        i_loop<Deref>(i_size, cell, ptr, strides);
                                     cur += k_size;
                                 },
                                 Stage::cells(),
                                 k_sizes);
                             sid::shift(ptr, sid::get_stride<dim::j>(strides), 1_c);
                         }
+                        Deref::fence();
                     };
                 }
 
-                template <class ThreadPool, class Grid, class Loops>
-                void run_loops(std::true_type, Grid const &grid, Loops loops) {
-                    execinfo info(ThreadPool(), grid);
-                    int_t i_blocks = info.i_blocks();
-                    int_t j_blocks = info.j_blocks();
-                    int_t k_size = grid.k_size();
-                    thread_pool::parallel_for_loop(ThreadPool(),
-                        [&](auto i, auto k, auto j) {
-                            tuple_util::for_each([block = info.block(i, j, k)](auto &&loop) { loop(block); }, loops);
-                        },
-                        i_blocks,
+                template <class ThreadPool, class Loops>
+                void run_loops(std::true_type, execinfo const &info, int_t k_size, Loops const &loops) {
+                    thread_pool::parallel_for_range(
+                        ThreadPool(),
+                        profiling::nested([&](auto i_begin, auto i_end, auto k, auto j) {
+                            tuple_util::for_each(
+                                [block = info.block_range(i_begin, i_end, j, k)](auto &&loop) { loop(block); }, loops);
+                        }),
+                        info.i_block_size(),
+                        info.i_size(),
                         k_size,
-                        j_blocks);
+                        info.j_blocks());
                 }
 
-                template <class ThreadPool, class Stage, class Grid, class Composite, class KSizes>
+                template <class ThreadPool, class Stage, class Deref, class Grid, class Composite, class KSizes>
                 auto make_loop(std::false_type, Grid const &grid, Composite composite, KSizes k_sizes) {
                     using extent_t = typename Stage::extent_t;
                     using ptr_diff_t = sid::ptr_diff_type<Composite>;
@@ -138,28 +140,129 @@ namespace gridtools {
                         int_t j_size = extent_t::extend(dim::j(), info.j_block_size);
                         int_t i_size = extent_t::extend(dim::i(), info.i_block_size);
 
-                        auto k_i_loops = make_k_i_loops(i_size, ptr, strides);
+                        auto k_i_loops = make_k_i_loops<Deref>(i_size, ptr, strides);
                         for (int_t j = 0; j < j_size; ++j) {
                             using namespace literals;
                             tuple_util::for_each(k_i_loops, Stage::cells(), k_sizes);
                             sid::shift(ptr, sid::get_stride<dim::k>(strides), k_shift_back);
                             sid::shift(ptr, sid::get_stride<dim::j>(strides), 1_c);
                         }
+                        Deref::fence();
                     };
                 }
 
-                template <class ThreadPool, class Grid, class Loops>
-                void run_loops(std::false_type, Grid const &grid, Loops loops) {
-                    execinfo info(ThreadPool(), grid);
-                    thread_pool::parallel_for_loop(ThreadPool(),
-                        [&](auto i, auto j) {
-                            tuple_util::for_each([block = info.block(i, j)](auto &&loop) { loop(block); }, loops);
-                        },
-                        info.i_blocks(),
+                template <class ThreadPool, class Loops>
+                void run_loops(std::false_type, execinfo const &info, int_t, Loops const &loops) {
+                    thread_pool::parallel_for_range(
+                        ThreadPool(),
+                        profiling::nested([&](auto i_begin, auto i_end, auto j) {
+                            tuple_util::for_each(
+                                [block = info.block_range(i_begin, i_end, j)](auto &&loop) { loop(block); }, loops);
+                        }),
+                        info.i_block_size(),
+                        info.i_size(),
                         info.j_blocks());
                 }
+
+                template <class ThreadPool, class Loops>
+                void run_batched_loops(
+                    std::true_type, execinfo const &info, int_t k_size, std::vector<Loops> const &loops) {
+                    thread_pool::parallel_for_range(
+                        ThreadPool(),
+                        profiling::nested([&](auto i_begin, auto i_end, auto k, auto j, auto m) {
+                            tuple_util::for_each(
+                                [block = info.block_range(i_begin, i_end, j, k)](auto &&loop) { loop(block); },
+                                loops[m]);
+                        }),
+                        info.i_block_size(),
+                        info.i_size(),
+                        k_size,
+                        info.j_blocks(),
+                        (int_t)loops.size());
+                }
+
+                template <class ThreadPool, class Loops>
+                void run_batched_loops(std::false_type, execinfo const &info, int_t, std::vector<Loops> const &loops) {
+                    thread_pool::parallel_for_range(
+                        ThreadPool(),
+                        profiling::nested([&](auto i_begin, auto i_end, auto j, auto m) {
+                            tuple_util::for_each(
+                                [block = info.block_range(i_begin, i_end, j)](auto &&loop) { loop(block); }, loops[m]);
+                        }),
+                        info.i_block_size(),
+                        info.i_size(),
+                        info.j_blocks(),
+                        (int_t)loops.size());
+                }
+
+                template <class ThreadPool, class Loops>
+                void run_active_loops(std::true_type,
+                    execinfo const &info,
+                    int_t k_size,
+                    std::vector<std::pair<int_t, int_t>> const &blocks,
+                    Loops const &loops) {
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        profiling::nested([&](auto b, auto k) {
+                            auto block = info.block(blocks[b].first, blocks[b].second, k);
+                            tuple_util::for_each([&](auto &&loop) { loop(block); }, loops);
+                        }),
+                        (int_t)blocks.size(),
+                        k_size);
+                }
+
+                template <class ThreadPool, class Loops>
+                void run_active_loops(std::false_type,
+                    execinfo const &info,
+                    int_t,
+                    std::vector<std::pair<int_t, int_t>> const &blocks,
+                    Loops const &loops) {
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        profiling::nested([&](auto b) {
+                            auto block = info.block(blocks[b].first, blocks[b].second);
+                            tuple_util::for_each([&](auto &&loop) { loop(block); }, loops);
+                        }),
+                        (int_t)blocks.size());
+                }
+
+                template <class ThreadPool, class Loops>
+                void run_batched_active_loops(std::true_type,
+                    execinfo const &info,
+                    int_t k_size,
+                    std::vector<std::pair<int_t, int_t>> const &blocks,
+                    std::vector<Loops> const &loops) {
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        profiling::nested([&](auto b, auto k, auto m) {
+                            auto block = info.block(blocks[b].first, blocks[b].second, k);
+                            tuple_util::for_each([&](auto &&loop) { loop(block); }, loops[m]);
+                        }),
+                        (int_t)blocks.size(),
+                        k_size,
+                        (int_t)loops.size());
+                }
+
+                template <class ThreadPool, class Loops>
+                void run_batched_active_loops(std::false_type,
+                    execinfo const &info,
+                    int_t,
+                    std::vector<std::pair<int_t, int_t>> const &blocks,
+                    std::vector<Loops> const &loops) {
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        profiling::nested([&](auto b, auto m) {
+                            auto block = info.block(blocks[b].first, blocks[b].second);
+                            tuple_util::for_each([&](auto &&loop) { loop(block); }, loops[m]);
+                        }),
+                        (int_t)blocks.size(),
+                        (int_t)loops.size());
+                }
             } // namespace loops_impl_
             using loops_impl_::make_loop;
+            using loops_impl_::run_active_loops;
+            using loops_impl_::run_batched_active_loops;
+            using loops_impl_::run_batched_loops;
             using loops_impl_::run_loops;
         } // namespace cpu_ifirst_backend
     }     // namespace stencil
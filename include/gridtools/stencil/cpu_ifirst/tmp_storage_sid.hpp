@@ -13,6 +13,7 @@
 
 #include "../../common/hugepage_alloc.hpp"
 #include "../../common/hymap.hpp"
+#include "../../common/stride_padding.hpp"
 #include "../../sid/allocator.hpp"
 #include "../../sid/concept.hpp"
 #include "../../sid/simple_ptr_holder.hpp"
@@ -45,9 +46,15 @@ namespace gridtools {
                 template <class T, class Extent>
                 pos3<std::size_t> full_block_size(pos3<std::size_t> const &block_size) {
                     // add padding to the i dimension to align all first elements along the i dimension
-                    const std::size_t size_i = pad<T>(Extent::extend(dim::i(), block_size.i));
-                    const std::size_t size_j = Extent::extend(dim::j(), block_size.j);
-                    const std::size_t size_k = Extent::extend(dim::k(), block_size.k);
+                    std::size_t size_i = pad<T>(Extent::extend(dim::i(), block_size.i));
+                    std::size_t size_j = Extent::extend(dim::j(), block_size.j);
+                    std::size_t size_k = Extent::extend(dim::k(), block_size.k);
+                    // pad the i, k and j sizes (in the order of the strides) against cache set aliasing
+                    constexpr std::size_t step_i =
+                        byte_alignment::value % sizeof(T) ? 1 : byte_alignment::value / sizeof(T);
+                    size_i = stride_padding::pad_length(size_i, sizeof(T), step_i);
+                    size_k = stride_padding::pad_length(size_k, size_i * sizeof(T));
+                    size_j = stride_padding::pad_length(size_j, size_i * size_k * sizeof(T));
                     return {size_i, size_j, size_k};
                 }
 
@@ -9,13 +9,18 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../common/defs.hpp"
 #include "../common/for_each.hpp"
 #include "../common/host_device.hpp"
 #include "../common/integral_constant.hpp"
+#include "../common/stride_padding.hpp"
 #include "../common/tuple.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
@@ -31,12 +36,48 @@
 #include "../thread_pool/omp.hpp"
 #include "be_api.hpp"
 #include "common/dim.hpp"
+#include "core/profiling.hpp"
 
 namespace gridtools {
     namespace stencil {
         namespace cpu_kfirst_backend {
-            template <class ThreadPool, class Stage, class Grid, class DataStores>
-            auto make_stage_loop(ThreadPool, Stage, Grid const &grid, DataStores &data_stores) {
+            template <class T>
+            GT_FORCE_INLINE void prefetch(T *ptr, int_t offset) {
+#if defined(__GNUC__)
+                __builtin_prefetch(ptr + offset, std::is_const<T>::value ? 0 : 1);
+#endif
+            }
+
+            // the converting pointers (see `sid/convert.hpp`) are not prefetched
+            template <class Ptr>
+            GT_FORCE_INLINE void prefetch(Ptr const &, int_t) {}
+
+            /**
+             *  Prefetches the external fields `Distance` k-levels ahead of the level `k` of the column of `k_size`
+             *  levels. Close to the end of the column the first levels of the next column (in the order of the
+             *  traversal, i.e. the next `j`) are prefetched instead.
+             */
+            template <class Keys, class Distance, class Ptr, class Strides, class KStep>
+            GT_FORCE_INLINE void prefetch_ahead(
+                Distance, Ptr const &ptr, Strides const &strides, KStep k_step, int_t k, int_t k_size) {
+                int_t k_offset = Distance::value * k_step;
+                bool next_column = k + Distance::value >= k_size;
+                if (next_column)
+                    k_offset -= k_size * k_step;
+                for_each<meta::transform<meta::lazy::id, Keys>>([&](auto key) {
+                    using key_t = typename decltype(key)::type;
+                    auto &&k_stride = sid::get_stride_element<key_t, dim::k>(strides);
+                    auto &&j_stride = sid::get_stride_element<key_t, dim::j>(strides);
+                    prefetch(at_key<key_t>(ptr), k_stride * k_offset + (next_column ? j_stride : 0));
+                });
+            }
+
+            template <class Keys, class Ptr, class Strides, class KStep>
+            GT_FORCE_INLINE void prefetch_ahead(
+                integral_constant<int_t, 0>, Ptr const &, Strides const &, KStep, int_t, int_t) {}
+
+            template <class ThreadPool, class PrefetchDistance, class Stage, class Grid, class DataStores>
+            auto make_stage_loop(ThreadPool, PrefetchDistance, Stage, Grid const &grid, DataStores &data_stores) {
                 using extent_t = typename Stage::extent_t;
 
                 using plh_map_t = typename Stage::plh_map_t;
@@ -55,13 +96,20 @@ namespace gridtools {
                 sid::shift(
                     offset, sid::get_stride<dim::k>(strides), grid.k_start(Stage::interval(), Stage::execution()));
 
-                auto shift_back = -grid.k_size(Stage::interval()) * Stage::k_step();
+                using prefetch_keys_t =
+                    meta::transform<be_api::get_key, meta::filter<meta::not_<be_api::get_is_tmp>::apply, plh_map_t>>;
+
+                int_t k_size = grid.k_size(Stage::interval());
+                auto shift_back = -k_size * Stage::k_step();
                 auto k_sizes =
                     tuple_util::transform([&](auto cell) { return grid.k_size(cell.interval()); }, Stage::cells());
-                auto k_loop = [k_sizes = std::move(k_sizes), shift_back](auto &ptr, auto const &strides) {
+                auto k_loop = [k_sizes = std::move(k_sizes), k_size, shift_back](auto &ptr, auto const &strides) {
+                    int_t level = 0;
                     tuple_util::for_each(
-                        [&ptr, &strides](auto cell, auto size) {
-                            for (int_t k = 0; k < size; ++k) {
+                        [&ptr, &strides, &level, k_size](auto cell, auto size) {
+                            for (int_t k = 0; k < size; ++k, ++level) {
+                                prefetch_ahead<prefetch_keys_t>(
+                                    PrefetchDistance(), ptr, strides, Stage::k_step(), level, k_size);
                                 cell(ptr, strides);
                                 cell.inc_k(ptr, strides);
                             }
@@ -70,9 +118,9 @@ namespace gridtools {
                         k_sizes);
                     sid::shift(ptr, sid::get_stride<dim::k>(strides), shift_back);
                 };
-                return [origin = sid::get_origin(composite) + offset,
-                           strides = std::move(strides),
-                           k_loop = std::move(k_loop)](int_t i_block, int_t j_block, int_t i_size, int_t j_size) {
+                auto loop = [origin = sid::get_origin(composite) + offset,
+                                strides = std::move(strides),
+                                k_loop = std::move(k_loop)](int_t i_block, int_t j_block, int_t i_size, int_t j_size) {
                     ptr_diff_t offset{};
                     sid::shift(
                         offset, sid::get_stride<dim::thread>(strides), thread_pool::get_thread_num(ThreadPool()));
@@ -82,24 +130,87 @@ namespace gridtools {
                     auto j_loop = sid::make_loop<dim::j>(extent_t::extend(dim::j(), j_size));
                     i_loop(j_loop(k_loop))(origin() + offset, strides);
                 };
+                return core::profile_stage<Stage>(ThreadPool(), std::move(loop));
             }
 
+            /**
+             *  `PrefetchDistance` is the number of k-levels ahead of the computation for which the external fields are
+             *  prefetched in software. It is zero (no prefetching) by default, the good value depends on the machine
+             *  and on the number of the fields in the stencil.
+             */
             template <class IBlockSize = integral_constant<int_t, 8>,
                 class JBlockSize = integral_constant<int_t, 8>,
-                class ThreadPool = thread_pool::omp>
+                class ThreadPool = thread_pool::omp,
+                class PrefetchDistance = integral_constant<int_t, 0>>
             struct cpu_kfirst {};
 
-            template <class IBlockSize, class JBlockSize, class ThreadPool, class Spec, class Grid, class DataStores>
-            void gridtools_backend_entry_point(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool>,
-                Spec,
-                Grid const &grid,
-                DataStores external_data_stores) {
-                using stages_t = be_api::make_split_view<Spec>;
+            // the blocks that have the active columns of the masked grid, empty if the grid is not masked
+            template <class IBlockSize, class JBlockSize, class Grid>
+            std::vector<std::pair<int_t, int_t>> active_blocks(Grid const &grid) {
+                if (!grid.mask())
+                    return {};
+                return grid.mask()->active_blocks(IBlockSize::value, JBlockSize::value);
+            }
 
-                auto alloc = sid::make_cached_allocator(&std::make_unique<char[]>);
+            template <class IBlockSize, class JBlockSize, class ThreadPool, class Allocator, class StageLoops>
+            struct plan_f {
+                Allocator m_alloc;
+                StageLoops m_stage_loops;
+                int_t m_total_i;
+                int_t m_total_j;
+                // the dim::thread extent of the temporaries
+                int_t m_max_threads;
+                bool m_masked;
+                std::vector<std::pair<int_t, int_t>> m_active_blocks;
+
+                void run_active_blocks() const {
+                    int_t total_i = m_total_i;
+                    int_t total_j = m_total_j;
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        profiling::nested([&](auto b) {
+                            int_t bi = m_active_blocks[b].first;
+                            int_t bj = m_active_blocks[b].second;
+                            int_t i_size = std::min(total_i - bi * IBlockSize::value, int_t(IBlockSize::value));
+                            int_t j_size = std::min(total_j - bj * JBlockSize::value, int_t(JBlockSize::value));
+                            tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, m_stage_loops);
+                        }),
+                        (int_t)m_active_blocks.size());
+                }
+
+                void operator()() const {
+                    if (thread_pool::get_max_threads(ThreadPool()) > m_max_threads)
+                        throw std::runtime_error("gridtools::stencil::cpu_kfirst: the plan was created for fewer "
+                                                 "threads than the thread pool has now, recreate the plan.");
+                    if (m_masked) {
+                        run_active_blocks();
+                        return;
+                    }
+                    int_t total_i = m_total_i;
+                    int_t total_j = m_total_j;
 
+                    int_t NBI = (total_i + IBlockSize::value - 1) / IBlockSize::value;
+
+                    // the j-blocks are the chunks of the range, the i-blocks are the outer dimension
+                    thread_pool::parallel_for_range(
+                        ThreadPool(),
+                        profiling::nested([&](auto j_begin, auto j_end, auto bi) {
+                            int_t bj = j_begin / JBlockSize::value;
+                            int_t i_size = bi + 1 == NBI ? total_i - bi * IBlockSize::value : IBlockSize::value;
+                            int_t j_size = j_end - j_begin;
+                            tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, m_stage_loops);
+                        }),
+                        JBlockSize::value,
+                        total_j,
+                        NBI);
+                }
+            };
+
+            template <class IBlockSize, class JBlockSize, class ThreadPool, class Spec, class Grid, class Allocator>
+            auto make_temporaries(Spec, Grid const &grid, Allocator &alloc) {
+                using stages_t = be_api::make_split_view<Spec>;
                 using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-                auto temporaries = be_api::make_data_stores(tmp_plh_map_t(), [&grid, &alloc](auto info) {
+                return be_api::make_data_stores(tmp_plh_map_t(), [&grid, &alloc](auto info) {
                     auto extent = info.extent();
                     auto interval = stages_t::interval();
                     auto num_colors = info.num_colors();
@@ -107,17 +218,34 @@ namespace gridtools {
                         tuple_util::make<hymap::keys<dim::i, dim::j, dim::k>::values>(-extent.minus(dim::i()),
                             -extent.minus(dim::j()),
                             -grid.k_start(interval) - extent.minus(dim::k()));
-                    auto sizes =
-                        tuple_util::make<hymap::keys<dim::c, dim::k, dim::j, dim::i, dim::thread>::values>(num_colors,
-                            grid.k_size(interval, extent),
-                            extent.extend(dim::j(), JBlockSize()),
-                            extent.extend(dim::i(), IBlockSize()),
-                            thread_pool::get_max_threads(ThreadPool()));
+                    // pad the k, j and i sizes (in the order of the strides) against cache set aliasing
+                    using storage_t = be_api::tmp_storage_type<decltype(info)>;
+                    std::size_t stride = std::max<std::size_t>(num_colors, 1) * sizeof(storage_t);
+                    int_t k_size = stride_padding::pad_length<int_t>(grid.k_size(interval, extent), stride);
+                    int_t j_size =
+                        stride_padding::pad_length<int_t>(extent.extend(dim::j(), JBlockSize()), stride *= k_size);
+                    int_t i_size =
+                        stride_padding::pad_length<int_t>(extent.extend(dim::i(), IBlockSize()), stride *= j_size);
+                    auto sizes = tuple_util::make<hymap::keys<dim::c, dim::k, dim::j, dim::i, dim::thread>::values>(
+                        num_colors, k_size, j_size, i_size, thread_pool::get_max_threads(ThreadPool()));
 
                     using stride_kind = meta::list<decltype(extent), decltype(num_colors)>;
-                    return sid::shift_sid_origin(
-                        sid::make_contiguous<decltype(info.data()), int_t, stride_kind>(alloc, sizes), offsets);
+                    return be_api::convert_tmp_storage(info,
+                        sid::shift_sid_origin(
+                            sid::make_contiguous<storage_t, int_t, stride_kind>(alloc, sizes), offsets));
                 });
+            }
+
+            template <class IBlockSize,
+                class JBlockSize,
+                class ThreadPool,
+                class PrefetchDistance,
+                class Spec,
+                class Grid,
+                class DataStores,
+                class Temporaries>
+            auto make_stage_loops(Spec, Grid const &grid, DataStores external_data_stores, Temporaries temporaries) {
+                using stages_t = be_api::make_split_view<Spec>;
 
                 auto blocked_external_data_stores = tuple_util::transform(
                     [&](auto &&data_store) {
@@ -128,24 +256,113 @@ namespace gridtools {
 
                 auto data_stores = hymap::concat(std::move(blocked_external_data_stores), std::move(temporaries));
 
-                auto stage_loops = tuple_util::transform(
-                    [&](auto stage) { return make_stage_loop(ThreadPool(), stage, grid, data_stores); },
+                return tuple_util::transform(
+                    [&](auto stage) {
+                        return make_stage_loop(ThreadPool(), PrefetchDistance(), stage, grid, data_stores);
+                    },
                     meta::rename<tuple, stages_t>());
+            }
+
+            template <class IBlockSize,
+                class JBlockSize,
+                class ThreadPool,
+                class PrefetchDistance,
+                class Spec,
+                class Grid,
+                class DataStores>
+            auto gridtools_backend_make_plan(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool, PrefetchDistance>,
+                Spec,
+                Grid const &grid,
+                DataStores external_data_stores) {
+                auto alloc = sid::make_cached_allocator(&std::make_unique<char[]>);
+                auto stage_loops = make_stage_loops<IBlockSize, JBlockSize, ThreadPool, PrefetchDistance>(Spec(),
+                    grid,
+                    std::move(external_data_stores),
+                    make_temporaries<IBlockSize, JBlockSize, ThreadPool>(Spec(), grid, alloc));
+                return plan_f<IBlockSize, JBlockSize, ThreadPool, decltype(alloc), decltype(stage_loops)>{
+                    std::move(alloc),
+                    std::move(stage_loops),
+                    grid.i_size(),
+                    grid.j_size(),
+                    thread_pool::get_max_threads(ThreadPool()),
+                    grid.mask() != nullptr,
+                    active_blocks<IBlockSize, JBlockSize>(grid)};
+            }
+
+            template <class IBlockSize,
+                class JBlockSize,
+                class ThreadPool,
+                class PrefetchDistance,
+                class Spec,
+                class Grid,
+                class DataStores>
+            void gridtools_backend_entry_point(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool, PrefetchDistance> be,
+                Spec,
+                Grid const &grid,
+                DataStores external_data_stores) {
+                gridtools_backend_make_plan(be, Spec(), grid, std::move(external_data_stores))();
+            }
+
+            /**
+             *  Runs the same spec over several independent sets of fields (ensemble members).
+             *  Members are an additional outer dimension of the parallel loop; the temporaries are indexed by thread
+             *  and therefore shared by all members.
+             */
+            template <class IBlockSize,
+                class JBlockSize,
+                class ThreadPool,
+                class PrefetchDistance,
+                class Spec,
+                class Grid,
+                class DataStores>
+            void gridtools_backend_entry_point_batched(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool, PrefetchDistance>,
+                Spec,
+                Grid const &grid,
+                std::vector<DataStores> members) {
+                auto alloc = sid::make_cached_allocator(&std::make_unique<char[]>);
+                auto temporaries = make_temporaries<IBlockSize, JBlockSize, ThreadPool>(Spec(), grid, alloc);
+
+                using stage_loops_t = decltype(make_stage_loops<IBlockSize, JBlockSize, ThreadPool, PrefetchDistance>(
+                    Spec(), grid, std::move(members.front()), temporaries));
+                std::vector<stage_loops_t> stage_loops;
+                stage_loops.reserve(members.size());
+                for (auto &&member : members)
+                    stage_loops.push_back(make_stage_loops<IBlockSize, JBlockSize, ThreadPool, PrefetchDistance>(
+                        Spec(), grid, std::move(member), temporaries));
 
                 int_t total_i = grid.i_size();
                 int_t total_j = grid.j_size();
 
                 int_t NBI = (total_i + IBlockSize::value - 1) / IBlockSize::value;
-                int_t NBJ = (total_j + JBlockSize::value - 1) / JBlockSize::value;
 
-                thread_pool::parallel_for_loop(ThreadPool(),
-                    [&](auto bj, auto bi) {
+                if (grid.mask()) {
+                    auto blocks = active_blocks<IBlockSize, JBlockSize>(grid);
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        profiling::nested([&](auto b, auto m) {
+                            int_t bi = blocks[b].first;
+                            int_t bj = blocks[b].second;
+                            int_t i_size = std::min(total_i - bi * IBlockSize::value, int_t(IBlockSize::value));
+                            int_t j_size = std::min(total_j - bj * JBlockSize::value, int_t(JBlockSize::value));
+                            tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, stage_loops[m]);
+                        }),
+                        (int_t)blocks.size(),
+                        (int_t)stage_loops.size());
+                    return;
+                }
+
+                thread_pool::parallel_for_range(
+                    ThreadPool(),
+                    profiling::nested([&](auto j_begin, auto j_end, auto bi, auto m) {
+                        int_t bj = j_begin / JBlockSize::value;
                         int_t i_size = bi + 1 == NBI ? total_i - bi * IBlockSize::value : IBlockSize::value;
-                        int_t j_size = bj + 1 == NBJ ? total_j - bj * JBlockSize::value : JBlockSize::value;
-                        tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, stage_loops);
-                    },
-                    NBJ,
-                    NBI);
+                        int_t j_size = j_end - j_begin;
+                        tuple_util::for_each([=](auto &&fun) { fun(bi, bj, i_size, j_size); }, stage_loops[m]);
+                    }),
+                    JBlockSize::value,
+                    total_j,
+                    NBI,
+                    (int_t)stage_loops.size());
             }
         } // namespace cpu_kfirst_backend
         using cpu_kfirst_backend::cpu_kfirst;
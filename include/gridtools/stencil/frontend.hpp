@@ -16,4 +16,7 @@
 #include "frontend/expandable_run.hpp"
 #include "frontend/make_grid.hpp"
 #include "frontend/make_param_list.hpp"
+#include "frontend/make_plan.hpp"
 #include "frontend/run.hpp"
+#include "frontend/run_async.hpp"
+#include "frontend/run_batched.hpp"
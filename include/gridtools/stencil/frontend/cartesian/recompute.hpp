@@ -0,0 +1,141 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../../../common/defs.hpp"
+#include "../../../common/host_device.hpp"
+#include "../../../common/tuple.hpp"
+#include "../../../common/tuple_util.hpp"
+#include "../../../meta.hpp"
+#include "../../common/intent.hpp"
+#include "accessor.hpp"
+#include "expressions/expr_base.hpp"
+#include "stencil_functions.hpp"
+
+/**
+ *   The cartesian part of the `tmp_policy::recompute` implementation (see `core/recompute_temporaries.hpp`).
+ *
+ *   The fused functor evaluates the consumer with the evaluator that forwards the accesses to the parameters of the
+ *   consumer to the fused parameters and evaluates the producer (as a stencil function) at the offset of each access
+ *   to the recomputed temporary.
+ */
+namespace gridtools {
+    namespace stencil {
+        namespace cartesian {
+            namespace recompute_impl_ {
+                template <size_t... Dims>
+                struct max_dim;
+
+                template <>
+                struct max_dim<> : std::integral_constant<size_t, 0> {};
+
+                template <size_t Dim, size_t... Dims>
+                struct max_dim<Dim, Dims...>
+                    : std::integral_constant<size_t, (Dim > max_dim<Dims...>::value ? Dim : max_dim<Dims...>::value)> {
+                };
+
+                template <class Params>
+                struct is_in_param_f {
+                    template <class I>
+                    using apply = bool_constant<meta::at<Params, I>::intent_v == intent::in>;
+                };
+
+                template <class Eval,
+                    size_t TmpIndex,
+                    class Producer,
+                    class Data,
+                    class ConsumerIndices,
+                    class ProducerIndices,
+                    class Params>
+                struct evaluator {
+                    Eval &m_eval;
+
+                    template <class Param, class Accessor>
+                    static GT_FUNCTION Param reindex(Accessor const &acc) {
+                        return call_interfaces_impl_::sum_offsets<Param>(acc, tuple<>());
+                    }
+
+                    template <class Accessor, class... Is>
+                    GT_FUNCTION Data recompute(Accessor const &acc, meta::list<Is...>) const {
+                        return call<Producer>::template return_type<Data>::with(
+                            m_eval, reindex<meta::at<Params, meta::at<ProducerIndices, Is>>>(acc)...);
+                    }
+
+                    template <class Accessor, std::enable_if_t<Accessor::index_t::value != TmpIndex, int> = 0>
+                    GT_FUNCTION decltype(auto) operator()(Accessor acc) const {
+                        return m_eval(
+                            reindex<meta::at<Params, meta::at<ConsumerIndices, typename Accessor::index_t>>>(acc));
+                    }
+
+                    template <class Accessor, std::enable_if_t<Accessor::index_t::value == TmpIndex, int> = 0>
+                    GT_FUNCTION Data operator()(Accessor acc) const {
+                        using producer_params_t = typename Producer::param_list;
+                        return recompute(acc,
+                            meta::filter<is_in_param_f<producer_params_t>::template apply,
+                                meta::make_indices_for<producer_params_t>>());
+                    }
+
+                    template <class Op, class... Ts>
+                    GT_FUNCTION auto operator()(expr<Op, Ts...> arg) const {
+                        return expressions::evaluation::value(*this, wstd::move(arg));
+                    }
+                };
+
+                template <class Consumer,
+                    size_t TmpIndex,
+                    class Producer,
+                    class Data,
+                    class ConsumerIndices,
+                    class ProducerIndices,
+                    class Params>
+                struct fused_functor {
+                    using param_list = Params;
+
+                    template <class Eval>
+                    static GT_FUNCTION void apply(Eval &&eval) {
+                        using eval_t = evaluator<std::remove_reference_t<Eval>,
+                            TmpIndex,
+                            Producer,
+                            Data,
+                            ConsumerIndices,
+                            ProducerIndices,
+                            Params>;
+                        eval_t fused_eval{eval};
+                        Consumer::template apply<eval_t &>(fused_eval);
+                    }
+                };
+
+                struct recompute_f {
+                    template <size_t Index, intent Intent, class Extent, class... Params>
+                    using param = accessor<Index,
+                        Intent,
+                        Extent,
+                        max_dim<accessor_impl_::minimal_dim<Extent>::value, tuple_util::size<Params>::value...>::value>;
+
+                    template <class Consumer,
+                        size_t TmpIndex,
+                        class Producer,
+                        class Data,
+                        class ConsumerIndices,
+                        class ProducerIndices,
+                        class Params>
+                    using functor =
+                        fused_functor<Consumer, TmpIndex, Producer, Data, ConsumerIndices, ProducerIndices, Params>;
+                };
+            } // namespace recompute_impl_
+
+            template <class... Ts>
+            recompute_impl_::recompute_f get_recompute(Ts &&...);
+        } // namespace cartesian
+    }     // namespace stencil
+} // namespace gridtools
@@ -0,0 +1,132 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ *   @file
+ *
+ *   Runtime sized alternative to `expandable_run`.
+ *
+ *   `runtime_expand<Functor, Is...>` is a stencil operator that applies `Functor` to every element of the fourth
+ *   dimension of the fields that are passed as the parameters with indices `Is...`. The number of elements is taken at
+ *   runtime from the extra last parameter that should be bound to a `global_parameter` of an integral type.
+ *   Parameters that are not listed in `Is...` are passed to `Functor` unchanged.
+ *
+ *   Example:
+ *     run([](auto velocity, auto tracers, auto n) {
+ *             return execute_parallel().stage(runtime_expand<advect, 1>(), velocity, tracers, n);
+ *         },
+ *         backend,
+ *         grid,
+ *         velocity,                          // 3D field
+ *         tracers,                           // 4D field, the fourth dimension enumerates tracers
+ *         make_global_parameter(n_tracers));
+ *
+ *   In contrast to `expandable_run` the functor is instantiated only once. The loop over the fourth dimension is
+ *   executed within the innermost loop of the backend, the fields should be stored contiguously in that dimension.
+ *
+ *   Only functors with an `apply` overload without the interval parameter are supported.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "../../../common/defs.hpp"
+#include "../../../common/host_device.hpp"
+#include "../../../common/tuple_util.hpp"
+#include "../../../meta.hpp"
+#include "../../core/functor_metafunctions.hpp"
+#include "accessor.hpp"
+#include "expressions/expr_base.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace cartesian {
+            namespace runtime_expand_impl_ {
+                template <class Accessor>
+                struct expand_accessor;
+
+                template <uint_t Id, intent Intent, class Extent, size_t Dim, class Seq>
+                struct expand_accessor<accessor<Id, Intent, Extent, Dim, Seq>> {
+                    using type = accessor<Id, Intent, Extent, (Dim > 4 ? Dim : 4)>;
+                };
+
+                template <class Accessor>
+                using expanded_accessor = typename expand_accessor<Accessor>::type;
+
+                template <class Expanded, class Accessor>
+                using is_expanded = meta::st_contains<Expanded, integral_constant<size_t, Accessor::index_t::value>>;
+
+                template <class Expanded>
+                struct convert_param_f {
+                    template <class Param>
+                    using apply = meta::if_<is_expanded<Expanded, Param>, expanded_accessor<Param>, Param>;
+                };
+
+                template <size_t... Is, class Src, class Dst>
+                GT_FUNCTION void copy_offsets(std::index_sequence<Is...>, Src const &src, Dst &dst) {
+                    using loop_t = int[sizeof...(Is) + 1];
+                    (void)loop_t{0, (dst[Is] = tuple_util::host_device::get<Is>(src), 0)...};
+                }
+
+                template <class Eval, class Expanded>
+                struct evaluator {
+                    Eval &m_eval;
+                    int_t m_pos;
+
+                    template <class Accessor, std::enable_if_t<is_expanded<Expanded, Accessor>::value, int> = 0>
+                    GT_FUNCTION decltype(auto) operator()(Accessor const &acc) const {
+                        expanded_accessor<Accessor> res;
+                        copy_offsets(std::make_index_sequence<tuple_util::size<Accessor>::value>(), acc, res);
+                        res[3] += m_pos;
+                        return m_eval(res);
+                    }
+
+                    template <class Accessor, std::enable_if_t<!is_expanded<Expanded, Accessor>::value, int> = 0>
+                    GT_FUNCTION decltype(auto) operator()(Accessor const &acc) const {
+                        return m_eval(acc);
+                    }
+
+                    template <class Op, class... Ts>
+                    GT_FUNCTION auto operator()(expr<Op, Ts...> arg) const {
+                        return expressions::evaluation::value(*this, wstd::move(arg));
+                    }
+                };
+
+                template <class Functor, size_t... Is>
+                struct runtime_expand {
+                    static_assert(sizeof...(Is) > 0, "At least one parameter should be expanded.");
+                    static_assert(core::has_apply<Functor>::value,
+                        "runtime_expand supports only functors with `apply` overload without interval parameter.");
+
+                    using expanded_t = meta::list<integral_constant<size_t, Is>...>;
+
+                    using count = in_accessor<meta::length<typename Functor::param_list>::value>;
+
+                    using param_list = meta::push_back<
+                        meta::transform<convert_param_f<expanded_t>::template apply, typename Functor::param_list>,
+                        count>;
+
+                    template <class Eval>
+                    GT_FUNCTION static void apply(Eval &&eval) {
+                        using eval_t = evaluator<std::remove_reference_t<Eval>, expanded_t>;
+                        int_t n = eval(count());
+                        for (int_t i = 0; i < n; ++i) {
+                            eval_t expanded_eval{eval, i};
+                            Functor::template apply<eval_t &>(expanded_eval);
+                        }
+                    }
+                };
+            } // namespace runtime_expand_impl_
+            using runtime_expand_impl_::runtime_expand;
+        } // namespace cartesian
+    }     // namespace stencil
+} // namespace gridtools
@@ -67,8 +67,37 @@ namespace gridtools {
                     }
                 };
 
+                template <class Functor, class = void>
+                struct functor_write_only {
+                    using type = meta::list<>;
+                };
+
+                template <class Functor>
+                struct functor_write_only<Functor, void_t<typename Functor::write_only>> {
+                    using type = typename Functor::write_only;
+                };
+
+                template <class Keys>
+                struct write_only_key_f {
+                    template <class Accessor>
+                    struct apply_impl {
+                        static_assert(Accessor::intent_v == intent::inout,
+                            "only the inout accessors can be declared write only");
+                        static_assert(std::is_same<typename Accessor::extent_t, extent<>>::value,
+                            "the write only accessors should have zero extent");
+                        using type = meta::at_c<Keys, Accessor::index_t::value>;
+                    };
+
+                    template <class Accessor>
+                    using apply = typename apply_impl<Accessor>::type;
+                };
+
                 template <class Functor, class PlhMap>
                 struct stage {
+                    // the outputs that the functor lists in its optional `write_only` member
+                    using write_only_keys_t = meta::transform<write_only_key_f<PlhMap>::template apply,
+                        typename functor_write_only<Functor>::type>;
+
                     template <class Deref = void, class Ptr, class Strides>
                     GT_FUNCTION void operator()(Ptr const &ptr, Strides const &strides) const {
                         using deref_t = meta::if_<std::is_void<Deref>, default_deref_f, Deref>;
@@ -14,9 +14,11 @@
 
 #include <boost/preprocessor/punctuation/remove_parens.hpp>
 #include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/tuple/elem.hpp>
 #include <boost/preprocessor/variadic/to_seq.hpp>
 
 #include "../../../common/integral_constant.hpp"
+#include "../../common/tmp_policy.hpp"
 
 #define GT_INTERNAL_DECLARE_TMP(r, type, name) \
     constexpr ::gridtools::stencil::cartesian::tmp_arg<__COUNTER__, BOOST_PP_REMOVE_PARENS(type)> name = {};
@@ -25,6 +27,22 @@
     BOOST_PP_SEQ_FOR_EACH(GT_INTERNAL_DECLARE_TMP, type, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)) \
     static_assert(1, "")
 
+#define GT_INTERNAL_DECLARE_TMP_WITH_POLICY(r, type_and_policy, name)       \
+    constexpr ::gridtools::stencil::cartesian::tmp_arg<__COUNTER__,         \
+        BOOST_PP_REMOVE_PARENS(BOOST_PP_TUPLE_ELEM(2, 0, type_and_policy)), \
+        BOOST_PP_REMOVE_PARENS(BOOST_PP_TUPLE_ELEM(2, 1, type_and_policy))> \
+        name = {};
+
+/**
+ *  Declares the temporaries with the given `tmp_policy`, like
+ *  `GT_DECLARE_TMP_WITH_POLICY(double, tmp_policy::store_as<float>, lap);` or
+ *  `GT_DECLARE_TMP_WITH_POLICY(double, tmp_policy::recompute, flx, fly);`
+ */
+#define GT_DECLARE_TMP_WITH_POLICY(type, policy, ...)                                               \
+    BOOST_PP_SEQ_FOR_EACH(                                                                          \
+        GT_INTERNAL_DECLARE_TMP_WITH_POLICY, (type, policy), BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)) \
+    static_assert(1, "")
+
 #define GT_INTERNAL_DECLARE_EXPANDABLE_TMP(r, type, name)                                    \
     constexpr ::gridtools::stencil::expandable<                                              \
         ::gridtools::stencil::cartesian::tmp_arg<__COUNTER__, BOOST_PP_REMOVE_PARENS(type)>> \
@@ -37,9 +55,10 @@
 namespace gridtools {
     namespace stencil {
         namespace cartesian {
-            template <size_t I, class Data>
+            template <size_t I, class Data, class Policy = tmp_policy::materialize>
             struct tmp_arg : std::integral_constant<size_t, I> {
                 using data_t = Data;
+                using policy_t = Policy;
                 using num_colors_t = integral_constant<int_t, 1>;
                 using tmp_tag = std::true_type;
             };
@@ -11,5 +11,6 @@
 
 #include "icosahedral/accessor.hpp"
 #include "icosahedral/location_type.hpp"
+#include "icosahedral/neighbor_table.hpp"
 #include "icosahedral/stage.hpp"
 #include "icosahedral/tmp_arg.hpp"
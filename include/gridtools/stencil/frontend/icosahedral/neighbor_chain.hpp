@@ -0,0 +1,300 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ *   @file
+ *
+ *   Host side composition of the neighbor tables along `topo` neighbor chains.
+ *
+ *   `connectivity` keeps the tables for the links of the mesh (`vertex::edge`, `edge::cell` etc.) and produces the
+ *   tables for the longer chains on request:
+ *
+ *     connectivity conn(4); // rows are padded to the multiple of 4
+ *     conn.set<topo::vertex::edge>(v2e);
+ *     conn.set<topo::edge::vertex>(e2v);
+ *     auto const &v2v = conn.get<topo::vertex::edge::vertex>();
+ *
+ *   A chain is composed along one of its `topo::splits`. Only the splits which parts are already known are
+ *   considered; the cheapest of them is chosen by the estimated number of the visited table entries. Every prefix of
+ *   the chosen split is cached, so the chains that share the beginning reuse the work. The neighbors in the composed
+ *   rows are deduplicated, the neighbors that fall out of the table domain are dropped.
+ *
+ *   The resulting table can be uploaded to the target as a field of `neighbor_table_row<N>` (see `neighbor_table.hpp`)
+ *   filled by the `row<N>(i, j, c)` member of `neighbor_table` and read in the kernel with `table_accessor`. Then the
+ *   kernel pays a single indirection per neighbor regardless of the length of the chain.
+ */
+
+#pragma once
+
+#if __cplusplus < 201703
+#error gridtools::stencil::icosahedral::connectivity requires C++17
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../../common/defs.hpp"
+#include "../../../common/for_each.hpp"
+#include "../../../meta.hpp"
+#include "../../../topo.hpp"
+#include "neighbor_table.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace icosahedral {
+            namespace neighbor_chain_impl_ {
+                /**
+                 *  Host side neighbor table with the runtime width.
+                 *  Rows are padded to the width and stored contiguously with `i` being the fastest index.
+                 */
+                class neighbor_table {
+                    int_t m_ni;
+                    int_t m_nj;
+                    int_t m_colors;
+                    int_t m_width;
+                    std::vector<int_t> m_sizes;
+                    std::vector<neighbor_offset> m_offsets;
+
+                    size_t index(int_t i, int_t j, int_t c) const {
+                        assert(contains(i, j, c));
+                        return (size_t(j) * m_colors + c) * m_ni + i;
+                    }
+
+                  public:
+                    neighbor_table(int_t ni, int_t nj, int_t colors, int_t width)
+                        : m_ni(ni), m_nj(nj), m_colors(colors), m_width(width), m_sizes(size_t(ni) * nj * colors),
+                          m_offsets(m_sizes.size() * width) {}
+
+                    /**
+                     *  Fills the table from the function that returns `neighbor_table_row<N>` for the given `i`, `j`
+                     *  and `color`.
+                     */
+                    template <class Fun, size_t N = decltype(std::declval<Fun>()(0, 0, 0).offsets)::size()>
+                    neighbor_table(int_t ni, int_t nj, int_t colors, Fun &&fun) : neighbor_table(ni, nj, colors, N) {
+                        for (int_t j = 0; j < nj; ++j)
+                            for (int_t c = 0; c < colors; ++c)
+                                for (int_t i = 0; i < ni; ++i) {
+                                    auto const &src = fun(i, j, c);
+                                    for (int_t n = 0; n < src.size; ++n)
+                                        push_back(i, j, c, src.offsets[n]);
+                                }
+                    }
+
+                    int_t ni() const { return m_ni; }
+                    int_t nj() const { return m_nj; }
+                    int_t colors() const { return m_colors; }
+                    int_t width() const { return m_width; }
+
+                    /**
+                     *  The number of the allocated entries including padding.
+                     */
+                    size_t entries() const { return m_offsets.size(); }
+
+                    bool contains(int_t i, int_t j, int_t c) const {
+                        return i >= 0 && i < m_ni && j >= 0 && j < m_nj && c >= 0 && c < m_colors;
+                    }
+
+                    int_t size(int_t i, int_t j, int_t c) const { return m_sizes[index(i, j, c)]; }
+
+                    neighbor_offset const *begin(int_t i, int_t j, int_t c) const {
+                        return m_offsets.data() + index(i, j, c) * m_width;
+                    }
+
+                    neighbor_offset const *end(int_t i, int_t j, int_t c) const {
+                        return begin(i, j, c) + size(i, j, c);
+                    }
+
+                    void push_back(int_t i, int_t j, int_t c, neighbor_offset offset) {
+                        size_t idx = index(i, j, c);
+                        assert(m_sizes[idx] < m_width);
+                        m_offsets[idx * m_width + m_sizes[idx]++] = offset;
+                    }
+
+                    /**
+                     *  The row in the form that is consumed by `table_accessor`.
+                     */
+                    template <size_t N>
+                    neighbor_table_row<N> row(int_t i, int_t j, int_t c) const {
+                        neighbor_table_row<N> res = {};
+                        assert(size(i, j, c) <= (int_t)N);
+                        res.size = static_cast<std::int8_t>(size(i, j, c));
+                        std::copy(begin(i, j, c), end(i, j, c), res.offsets.begin());
+                        return res;
+                    }
+                };
+
+                /**
+                 *  Composes `lhs` (From -> Via) and `rhs` (Via -> To) into From -> To table.
+                 *  The width of the result is the largest number of distinct neighbors rounded up to `padding`.
+                 */
+                inline neighbor_table compose(neighbor_table const &lhs, neighbor_table const &rhs, int_t padding = 1) {
+                    assert(padding > 0);
+                    std::vector<std::vector<neighbor_offset>> rows(size_t(lhs.ni()) * lhs.nj() * lhs.colors());
+                    size_t max_size = 0;
+                    auto row = rows.begin();
+                    for (int_t j = 0; j < lhs.nj(); ++j)
+                        for (int_t c = 0; c < lhs.colors(); ++c)
+                            for (int_t i = 0; i < lhs.ni(); ++i, ++row) {
+                                for (auto first = lhs.begin(i, j, c), last = lhs.end(i, j, c); first != last; ++first) {
+                                    int_t ii = i + first->i;
+                                    int_t jj = j + first->j;
+                                    if (!rhs.contains(ii, jj, first->c))
+                                        continue;
+                                    for (auto it = rhs.begin(ii, jj, first->c), e = rhs.end(ii, jj, first->c); it != e;
+                                         ++it) {
+                                        auto offset = make_neighbor_offset(first->i + it->i, first->j + it->j, it->c);
+                                        if (std::find(row->begin(), row->end(), offset) == row->end())
+                                            row->push_back(offset);
+                                    }
+                                }
+                                max_size = std::max(max_size, row->size());
+                            }
+                    int_t width = (int_t(max_size) + padding - 1) / padding * padding;
+                    neighbor_table res(lhs.ni(), lhs.nj(), lhs.colors(), width);
+                    row = rows.begin();
+                    for (int_t j = 0; j < lhs.nj(); ++j)
+                        for (int_t c = 0; c < lhs.colors(); ++c)
+                            for (int_t i = 0; i < lhs.ni(); ++i, ++row)
+                                for (auto &&offset : *row)
+                                    res.push_back(i, j, c, offset);
+                    return res;
+                }
+
+                template <class>
+                struct split_info;
+
+                template <template <class...> class L, class... Parts>
+                struct split_info<L<Parts...>> {
+                    template <size_t... Is>
+                    static std::vector<std::type_index> prefixes(std::index_sequence<Is...>) {
+                        return {typeid(topo::join<meta::take_c<Is + 1, L<Parts...>>>)...};
+                    }
+
+                    static std::vector<std::type_index> parts() { return {typeid(Parts)...}; }
+
+                    static std::vector<std::type_index> prefixes() {
+                        return prefixes(std::index_sequence_for<Parts...>());
+                    }
+                };
+
+                /**
+                 *  The cache of the neighbor tables keyed by `topo` chains.
+                 */
+                class connectivity {
+                    int_t m_padding;
+                    std::unordered_map<std::type_index, neighbor_table> m_tables;
+                    // the keys of the tables that were composed by `get` rather than set by the user
+                    std::vector<std::type_index> m_composed;
+
+                    neighbor_table const *find(std::type_index key) const {
+                        auto it = m_tables.find(key);
+                        return it == m_tables.end() ? nullptr : &it->second;
+                    }
+
+                    // the upper bound of the number of table entries visited while composing along the split,
+                    // the prefixes that are already cached cost nothing
+                    size_t cost(
+                        std::vector<std::type_index> const &parts, std::vector<std::type_index> const &prefixes) const {
+                        auto const *first = find(parts.front());
+                        if (!first)
+                            return std::numeric_limits<size_t>::max();
+                        size_t elements = first->entries() / std::max(first->width(), 1);
+                        size_t width = first->width();
+                        size_t res = 0;
+                        for (size_t n = 1; n != parts.size(); ++n) {
+                            if (auto const *prefix = find(prefixes[n])) {
+                                width = prefix->width();
+                                continue;
+                            }
+                            auto const *part = find(parts[n]);
+                            if (!part)
+                                return std::numeric_limits<size_t>::max();
+                            res += elements * width * part->width();
+                            width *= part->width();
+                        }
+                        return res;
+                    }
+
+                  public:
+                    /**
+                     *  `padding` - the rows of the composed tables are padded to the multiple of this value.
+                     */
+                    explicit connectivity(int_t padding = 1) : m_padding(padding) {}
+
+                    /**
+                     *  Sets the table for the given chain. The tables composed so far are dropped: they may depend
+                     *  on the replaced one.
+                     */
+                    template <class Chain>
+                    void set(neighbor_table table) {
+                        static_assert(topo::is_chain<Chain>::value, "Chain expected.");
+                        for (auto &&key : m_composed)
+                            m_tables.erase(key);
+                        m_composed.clear();
+                        m_tables.insert_or_assign(typeid(Chain), std::move(table));
+                    }
+
+                    template <class Chain>
+                    bool contains() const {
+                        static_assert(topo::is_chain<Chain>::value, "Chain expected.");
+                        return find(typeid(Chain));
+                    }
+
+                    /**
+                     *  Returns the table for the given chain composing it if needed.
+                     *  Throws if the chain can't be composed from the known tables.
+                     */
+                    template <class Chain>
+                    neighbor_table const &get() {
+                        static_assert(topo::is_chain<Chain>::value, "Chain expected.");
+                        if (auto const *res = find(typeid(Chain)))
+                            return *res;
+                        std::vector<std::type_index> parts, prefixes;
+                        size_t best = std::numeric_limits<size_t>::max();
+                        for_each<topo::splits<Chain>>([&](auto split) {
+                            using info_t = split_info<decltype(split)>;
+                            auto split_parts = info_t::parts();
+                            if (split_parts.size() < 2)
+                                return;
+                            auto split_prefixes = info_t::prefixes();
+                            size_t c = cost(split_parts, split_prefixes);
+                            if (c < best) {
+                                best = c;
+                                parts = std::move(split_parts);
+                                prefixes = std::move(split_prefixes);
+                            }
+                        });
+                        if (parts.empty())
+                            throw std::runtime_error("gridtools::stencil::icosahedral::connectivity: the tables for "
+                                                     "the links of the chain are not provided");
+                        for (size_t n = 1; n != parts.size(); ++n) {
+                            if (find(prefixes[n]))
+                                continue;
+                            auto table = compose(*find(prefixes[n - 1]), *find(parts[n]), m_padding);
+                            m_tables.emplace(prefixes[n], std::move(table));
+                            m_composed.push_back(prefixes[n]);
+                        }
+                        return *find(typeid(Chain));
+                    }
+                };
+            } // namespace neighbor_chain_impl_
+            using neighbor_chain_impl_::compose;
+            using neighbor_chain_impl_::connectivity;
+            using neighbor_chain_impl_::neighbor_table;
+        } // namespace icosahedral
+    }     // namespace stencil
+} // namespace gridtools
@@ -0,0 +1,205 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ *   @file
+ *
+ *   Irregular neighbor sets on the structured icosahedral grid.
+ *
+ *   The compile time `neighbor_offsets` describe the regular triangular mesh only. A neighbor table is an ordinary
+ *   field on the `From` location which value type is `neighbor_table_row<MaxNeighbors>`: a fixed width padded row
+ *   that holds the actual number of neighbors and their offsets. The offsets follow the convention of the compile time
+ *   connectivity: `i` and `j` are relative to the current element, `c` is the color of the neighbor.
+ *   Hence the rows can describe irregular elements (like pentagon points) and can list the neighbors in any order that
+ *   suits the user (for example, sorted to improve the locality of the gathers). The functors that depend on the
+ *   position of the neighbor in the row (like the sign of the edge in `curl`) need the order of `make_structured_row`.
+ *
+ *   The offsets are bounded by the accessor extents and the colors by the location, so the rows are stored in bytes:
+ *   the row of six neighbors takes 19 bytes. `make_neighbor_offset` checks the range in debug mode.
+ *
+ *   In the functor the table is declared with `table_accessor<Id, From, To, MaxNeighbors>` and passed as the first
+ *   accessor to `for_neighbors`:
+ *
+ *     using v2e = table_accessor<0, vertices, edges, 6>;
+ *     using in = in_accessor<1, edges, extent<-1, 0, -1, 0>>;
+ *     ...
+ *     eval.for_neighbors([&](auto x) { ... }, v2e(), in());
+ *
+ *   The extents of the accessors to the neighbors can't be deduced from the runtime table, they should be provided
+ *   explicitly. In debug mode `for_neighbors` asserts that every offset of the row lies within the extents of the
+ *   accessors and that the colors are valid for the `To` location. The table itself is read only at the current
+ *   element.
+ *
+ *   The scope is the structured grid only; this is not an unstructured backend. There are no global element indices
+ *   and no compressed (CSR) rows, so arbitrary meshes and domain decomposed patches can't be described. The elements
+ *   are addressed in the structured (i, j, c) index space of the icosahedral grid and the neighbors are given
+ *   relative to the current element, within the compile time extents. Only the set and the order of the neighbors of
+ *   each element are free; the elements themselves can't be renumbered or reordered in memory.
+ *
+ *   With C++17 the tables can be named by `topo` neighbor chains: `chain_table_accessor<0, topo::vertex::edge, 6>`.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "../../../common/array.hpp"
+#include "../../../common/defs.hpp"
+#include "../../../common/for_each.hpp"
+#include "../../../common/host_device.hpp"
+#include "../../../common/tuple_util.hpp"
+#include "../../common/intent.hpp"
+#include "accessor.hpp"
+#include "connectivity.hpp"
+#include "location_type.hpp"
+
+#if __cplusplus >= 201703
+#include "../../../topo.hpp"
+#endif
+
+namespace gridtools {
+    namespace stencil {
+        namespace icosahedral {
+            namespace neighbor_table_impl_ {
+                struct neighbor_offset {
+                    std::int8_t i;
+                    std::int8_t j;
+                    std::int8_t c;
+                };
+
+                inline bool fits_neighbor_offset(int_t val) {
+                    return val >= std::numeric_limits<std::int8_t>::min() &&
+                           val <= std::numeric_limits<std::int8_t>::max();
+                }
+
+                inline neighbor_offset make_neighbor_offset(int_t i, int_t j, int_t c) {
+                    assert(fits_neighbor_offset(i) && fits_neighbor_offset(j) && fits_neighbor_offset(c));
+                    return {static_cast<std::int8_t>(i), static_cast<std::int8_t>(j), static_cast<std::int8_t>(c)};
+                }
+
+                GT_FUNCTION constexpr bool operator==(neighbor_offset const &lhs, neighbor_offset const &rhs) {
+                    return lhs.i == rhs.i && lhs.j == rhs.j && lhs.c == rhs.c;
+                }
+
+                GT_FUNCTION constexpr bool operator!=(neighbor_offset const &lhs, neighbor_offset const &rhs) {
+                    return !(lhs == rhs);
+                }
+
+                /**
+                 *  Whether the neighbor at the given offset is reachable through `Accessor`.
+                 */
+                template <class Accessor>
+                GT_FUNCTION constexpr bool is_within_extent(neighbor_offset const &offset) {
+                    using extent_t = typename Accessor::extent_t;
+                    return offset.i >= extent_t::iminus::value && offset.i <= extent_t::iplus::value &&
+                           offset.j >= extent_t::jminus::value && offset.j <= extent_t::jplus::value && offset.c >= 0 &&
+                           offset.c < Accessor::location_t::value;
+                }
+
+                GT_FUNCTION constexpr bool are_within_extents(neighbor_offset const &) { return true; }
+
+                template <class Accessor, class... Accessors>
+                GT_FUNCTION constexpr bool are_within_extents(neighbor_offset const &offset, Accessor, Accessors...) {
+                    return is_within_extent<Accessor>(offset) && are_within_extents(offset, Accessors()...);
+                }
+
+                template <size_t MaxNeighbors>
+                struct neighbor_table_row {
+                    static_assert(MaxNeighbors <= std::numeric_limits<std::int8_t>::max(), "too many neighbors");
+
+                    std::int8_t size;
+                    array<neighbor_offset, MaxNeighbors> offsets;
+                };
+
+                template <uint_t Id, class From, class To, size_t MaxNeighbors>
+                struct table_accessor : accessor<Id, intent::in, From> {
+                    static_assert(is_location_type<To>::value, GT_INTERNAL_ERROR);
+                    using to_location_t = To;
+                    using row_t = neighbor_table_row<MaxNeighbors>;
+                };
+
+                template <class>
+                struct is_table_accessor : std::false_type {};
+
+                template <uint_t Id, class From, class To, size_t MaxNeighbors>
+                struct is_table_accessor<table_accessor<Id, From, To, MaxNeighbors>> : std::true_type {};
+
+                template <class From, class To, int Color, size_t MaxNeighbors>
+                neighbor_table_row<MaxNeighbors> structured_row() {
+                    neighbor_table_row<MaxNeighbors> res = {};
+                    for_each<neighbor_offsets<From, To, Color>>([&](auto offset) {
+                        assert(res.size < (int_t)MaxNeighbors);
+                        res.offsets[res.size++] = make_neighbor_offset(
+                            tuple_util::get<0>(offset), tuple_util::get<1>(offset), tuple_util::get<3>(offset));
+                    });
+                    return res;
+                }
+
+                template <class From, class To, size_t MaxNeighbors, int... Colors>
+                neighbor_table_row<MaxNeighbors> structured_row(int color, std::integer_sequence<int, Colors...>) {
+                    using fun_t = neighbor_table_row<MaxNeighbors> (*)();
+                    static constexpr fun_t funs[] = {&structured_row<From, To, Colors, MaxNeighbors>...};
+                    assert(color >= 0 && color < From::value);
+                    return funs[color]();
+                }
+
+                /**
+                 *  The row of the table that reproduces the compile time connectivity of the regular mesh for the
+                 *  given color of `From` location.
+                 */
+                template <class From, class To, size_t MaxNeighbors>
+                neighbor_table_row<MaxNeighbors> make_structured_row(int color) {
+                    return structured_row<From, To, MaxNeighbors>(
+                        color, std::make_integer_sequence<int, From::value>());
+                }
+
+#if __cplusplus >= 201703
+                template <class>
+                struct location_of;
+
+                template <>
+                struct location_of<topo::vertex> {
+                    using type = vertices;
+                };
+
+                template <>
+                struct location_of<topo::edge> {
+                    using type = edges;
+                };
+
+                template <>
+                struct location_of<topo::cell> {
+                    using type = cells;
+                };
+
+                template <uint_t Id, class Chain, size_t MaxNeighbors>
+                using chain_table_accessor = table_accessor<Id,
+                    typename location_of<topo::first<Chain>>::type,
+                    typename location_of<topo::last<Chain>>::type,
+                    MaxNeighbors>;
+#endif
+            } // namespace neighbor_table_impl_
+            using neighbor_table_impl_::are_within_extents;
+            using neighbor_table_impl_::is_table_accessor;
+            using neighbor_table_impl_::make_neighbor_offset;
+            using neighbor_table_impl_::make_structured_row;
+            using neighbor_table_impl_::neighbor_offset;
+            using neighbor_table_impl_::neighbor_table_row;
+            using neighbor_table_impl_::table_accessor;
+#if __cplusplus >= 201703
+            using neighbor_table_impl_::chain_table_accessor;
+#endif
+        } // namespace icosahedral
+    }     // namespace stencil
+} // namespace gridtools
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <type_traits>
 
 #include "../../../common/defs.hpp"
@@ -26,6 +27,7 @@
 #include "../../common/intent.hpp"
 #include "connectivity.hpp"
 #include "location_type.hpp"
+#include "neighbor_table.hpp"
 
 /**
  *   @file
@@ -91,7 +93,10 @@ namespace gridtools {
 
                     static constexpr int_t color = Color;
 
-                    template <class Fun, class Accessor, class... Accessors>
+                    template <class Fun,
+                        class Accessor,
+                        class... Accessors,
+                        std::enable_if_t<!is_table_accessor<Accessor>::value, int> = 0>
                     GT_FUNCTION void for_neighbors(Fun &&fun, Accessor, Accessors...) const {
                         static_assert(
                             conjunction<
@@ -100,6 +105,27 @@ namespace gridtools {
                         host_device::for_each<neighbor_offsets<LocationType, typename Accessor::location_t, Color>>(
                             [&](auto offset) { fun(neighbor(Accessor(), offset), neighbor(Accessors(), offset)...); });
                     }
+
+                    template <class Fun,
+                        class Table,
+                        class Accessor,
+                        class... Accessors,
+                        std::enable_if_t<is_table_accessor<Table>::value, int> = 0>
+                    GT_FUNCTION void for_neighbors(Fun &&fun, Table, Accessor, Accessors...) const {
+                        static_assert(
+                            conjunction<std::is_same<typename Table::to_location_t, typename Accessor::location_t>,
+                                std::is_same<typename Table::to_location_t, typename Accessors::location_t>...>::value,
+                            "All accessors should be of the location the table points to");
+                        typename Table::row_t const &row = (*this)(Table());
+                        assert(row.size >= 0 && row.size <= (int_t)row.offsets.size());
+                        for (int_t n = 0; n < row.size; ++n) {
+                            assert(((void)"neighbor table offset out of the accessor extent",
+                                are_within_extents(row.offsets[n], Accessor(), Accessors()...)));
+                            auto offset = hymap::keys<dim::i, dim::j, dim::c>::values<int_t, int_t, int_t>(
+                                row.offsets[n].i, row.offsets[n].j, row.offsets[n].c);
+                            fun(neighbor(Accessor(), offset), neighbor(Accessors(), offset)...);
+                        }
+                    }
                 };
 
                 template <class Functor, class PlhMap>
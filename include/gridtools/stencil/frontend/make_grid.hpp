@@ -9,8 +9,12 @@
  */
 #pragma once
 
+#include <memory>
+#include <utility>
+
 #include "../../common/defs.hpp"
 #include "../../common/halo_descriptor.hpp"
+#include "../core/column_mask.hpp"
 #include "../core/grid.hpp"
 #include "axis.hpp"
 
@@ -40,5 +44,17 @@ namespace gridtools {
                 (int_t)direction_j.end() + 1 - (int_t)direction_j.begin(),
                 {dk}};
         }
+
+        /**
+         *  Restricts the computation on the `grid` to the active columns: `is_active(i, j)` tells if the column `(i,
+         *  j)` of the compute domain (relative to its origin) should be computed. The CPU backends skip the blocks that
+         *  have no active columns, the values at the inactive columns are unspecified after the run.
+         */
+        template <class Interval, class Fun>
+        core::grid<Interval> mask_columns(core::grid<Interval> grid, Fun &&is_active) {
+            grid.set_mask(
+                std::make_shared<core::column_mask>(grid.i_size(), grid.j_size(), std::forward<Fun>(is_active)));
+            return grid;
+        }
     } // namespace stencil
 } // namespace gridtools
@@ -0,0 +1,134 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "../../common/for_each.hpp"
+#include "../../common/hymap.hpp"
+#include "../../meta.hpp"
+#include "../../sid/as_const.hpp"
+#include "../../sid/concept.hpp"
+#include "../common/intent.hpp"
+#include "../core/backend.hpp"
+#include "../core/profiling.hpp"
+#include "run.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace frontend_impl_ {
+            // takes the origins of the fields again as `run` would do: the data stores save their snapshots (see
+            // `storage/snapshot.hpp`) and synchronize the target before the body writes via the captured pointers
+            template <class Spec, class DataStoreMap>
+            void acquire_fields(DataStoreMap &data_stores) {
+                for_each<get_keys<DataStoreMap>>([&](auto key) {
+                    auto &field = at_key<decltype(key)>(data_stores);
+                    if (decltype(get_arg_intent(Spec(), key))::value == intent::inout) {
+                        (void)sid::get_origin(field);
+                    } else {
+                        auto &&const_field = sid::as_const(field);
+                        (void)sid::get_origin(const_field);
+                    }
+                });
+            }
+
+            /**
+             *  A stencil computation that is prepared once and can be executed many times.
+             *
+             *  The composite SIDs, strides, temporaries and blocking decisions are set up on construction (and on
+             *  `rebind`). Calling the plan only executes the loops.
+             *
+             *  The plan keeps copies of the fields it was created with. The body captures the target pointers of the
+             *  `data_store` fields at creation time; before every execution the plan takes the origins of its fields
+             *  again, so that the snapshots taken after the creation of the plan are saved before they are
+             *  overwritten and the target buffers are synchronized with the host modifications.
+             */
+            template <class Spec, class Backend, class Grid, class DataStoreMap>
+            class plan {
+                using body_t = decltype(core::make_plan_f<Spec>()(
+                    std::declval<Backend const &>(), std::declval<Grid const &>(), std::declval<DataStoreMap>()));
+
+                Backend m_backend;
+                Grid m_grid;
+                // the body refers to the fields by raw pointers, the plan keeps them alive
+                std::unique_ptr<DataStoreMap> m_data_stores;
+                std::unique_ptr<body_t> m_body;
+
+                std::unique_ptr<body_t> make_body() const {
+                    return std::unique_ptr<body_t>(
+                        new body_t(core::make_plan_f<Spec>()(m_backend, m_grid, *m_data_stores)));
+                }
+
+              public:
+                plan(Backend be, Grid const &grid, DataStoreMap data_stores)
+                    : m_backend(std::move(be)), m_grid(grid), m_data_stores(new DataStoreMap(std::move(data_stores))),
+                      m_body(make_body()) {}
+
+                void operator()() const {
+                    GT_PROFILING_REGION((core::region_name<core::plan_region, core::spec_functors<Spec>>()));
+                    acquire_fields<Spec>(*m_data_stores);
+                    (*m_body)();
+                }
+
+                /**
+                 *  Binds the plan to the new set of fields of the same types.
+                 *  The temporaries of the previous binding are reused.
+                 */
+                template <class... Fields>
+                void rebind(Fields &&... fields) {
+                    static_assert(sizeof...(Fields) == meta::length<get_keys<DataStoreMap>>::value,
+                        "The number of fields should match the number of fields the plan was created with.");
+                    check_bounds<Spec>(m_grid, std::index_sequence_for<Fields...>(), fields...);
+                    // release the old body first to let its temporaries be taken from the allocator cache
+                    m_body.reset();
+                    m_data_stores.reset(new DataStoreMap{std::forward<Fields>(fields)...});
+                    m_body = make_body();
+                }
+            };
+
+            template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
+            auto make_plan_impl(
+                Comp comp, Backend &&be, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields)
+                -> plan<decltype(comp(arg<Is>()...)),
+                    std::decay_t<Backend>,
+                    Grid,
+                    typename hymap::keys<arg<Is>...>::template values<std::decay_t<Fields>...>> {
+                using spec_t = decltype(comp(arg<Is>()...));
+                check_spec<spec_t, Grid>();
+                check_bounds<spec_t>(grid, std::index_sequence<Is...>(), fields...);
+                using data_store_map_t = typename hymap::keys<arg<Is>...>::template values<std::decay_t<Fields>...>;
+                return {std::forward<Backend>(be), grid, data_store_map_t{std::forward<Fields>(fields)...}};
+            }
+
+            template <class... Ts>
+            void make_plan_impl(Ts...) {
+                static_assert(sizeof...(Ts) < 0, "Unexpected first argument of gridtools::stencil::make_plan.");
+            }
+
+            /**
+             *  Same signature as `run`, but instead of executing the computation returns a `plan` object.
+             */
+            template <class Comp, class Backend, class Grid, class... Fields>
+            auto make_plan(Comp comp, Backend &&be, Grid const &grid, Fields &&... fields) {
+                static_assert(
+                    conjunction<is_sid<Fields>...>::value, "All computation fields must satisfy SID concept.");
+                return make_plan_impl(comp,
+                    std::forward<Backend>(be),
+                    grid,
+                    std::index_sequence_for<Fields...>(),
+                    std::forward<Fields>(fields)...);
+            }
+        } // namespace frontend_impl_
+        using frontend_impl_::make_plan;
+    } // namespace stencil
+} // namespace gridtools
@@ -30,6 +30,7 @@
 #include "../core/functor_metafunctions.hpp"
 #include "../core/is_tmp_arg.hpp"
 #include "../core/mss.hpp"
+#include "../core/profiling.hpp"
 
 namespace gridtools {
     namespace stencil {
@@ -198,22 +199,22 @@ namespace gridtools {
                 using apply = core::check_valid_apply_overloads<Functor, Interval>;
             };
 
-            template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
-            auto run_impl(Comp comp, Backend &&be, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields)
-                -> void_t<decltype(comp(arg<Is>()...))> {
-                using spec_t = decltype(comp(arg<Is>()...));
+            template <class Spec, class Grid>
+            void check_spec() {
                 static_assert(
-                    meta::is_instantiation_of<spec, spec_t>::value, "Invalid stencil composition specification.");
+                    meta::is_instantiation_of<spec, Spec>::value, "Invalid stencil composition specification.");
                 static_assert(
                     meta::is_instantiation_of<core::interval, typename Grid::interval_t>::value, "Invalid grid.");
-                using functors_t = meta::transform<meta::first, meta::flatten<meta::transform<meta::second, spec_t>>>;
+                using functors_t = meta::transform<meta::first, meta::flatten<meta::transform<meta::second, Spec>>>;
                 static_assert(meta::all_of<check_valid_apply_overloads<typename Grid::interval_t>::template apply,
                                   functors_t>::value,
                     "Invalid stencil operator detected.");
+            }
 
-                using data_store_map_t = typename hymap::keys<arg<Is>...>::template values<Fields &...>;
+            template <class Spec, class Grid, class... Fields, size_t... Is>
+            void check_bounds(Grid const &grid, std::index_sequence<Is...>, Fields const &... fields) {
 #ifndef NDEBUG
-                using extent_map_t = core::get_extent_map_from_msses<spec_t>;
+                using extent_map_t = core::get_extent_map_from_msses<Spec>;
                 auto check_bounds = [origin = grid.origin(), size = grid.size()](auto arg, auto const &field) {
                     using extent_t = core::lookup_extent_map<extent_map_t, decltype(arg)>;
                     // There is no check in k-direction because at the fields may be used within subintervals
@@ -227,9 +228,19 @@ namespace gridtools {
                         });
                     return 0;
                 };
-                using loop_t = int[sizeof...(Is)];
-                (void)loop_t{check_bounds(arg<Is>(), fields)...};
+                using loop_t = int[sizeof...(Is) + 1];
+                (void)loop_t{0, check_bounds(arg<Is>(), fields)...};
 #endif
+            }
+
+            template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
+            auto run_impl(Comp comp, Backend &&be, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields)
+                -> void_t<decltype(comp(arg<Is>()...))> {
+                using spec_t = decltype(comp(arg<Is>()...));
+                check_spec<spec_t, Grid>();
+                check_bounds<spec_t>(grid, std::index_sequence<Is...>(), fields...);
+                using data_store_map_t = typename hymap::keys<arg<Is>...>::template values<Fields &...>;
+                GT_PROFILING_REGION((core::region_name<core::run_region, core::spec_functors<spec_t>>()));
                 core::call_entry_point_f<spec_t>()(std::forward<Backend>(be), grid, data_store_map_t{fields...});
             }
 
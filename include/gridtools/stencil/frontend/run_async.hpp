@@ -0,0 +1,367 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ *   @file
+ *
+ *   Asynchronous execution of the stencil computations.
+ *
+ *   `run_async` has the same signature as `run`, but executes the computation on a separate host thread and returns
+ *   immediately with an `async_run` handle:
+ *
+ *     auto dyn = run_async(dynamics_spec, backend, grid, u, v, w);
+ *     write_output(t);               // overlaps with the dynamics
+ *     dyn.wait();
+ *
+ *   The handle keeps the copies of the fields (for the `data_store`s it means the ownership) until the computation is
+ *   finished. Its destructor waits for the completion. The exceptions thrown by the computation are rethrown by `wait`.
+ *
+ *   The host threads are kept between the calls and a new one is started only if all of them are busy, so the thread
+ *   local caches of the backends (like the cached allocator of the temporaries) are reused by the subsequent runs.
+ *
+ *   To keep the cores for the host work the computation can be restricted to a partition of the thread pool (see
+ *   `thread_pool/partition.hpp`):
+ *
+ *     auto dyn = run_async(thread_pool::partition::cores(0, 12), dynamics_spec, backend, grid, u, v, w);
+ *
+ *   Only the backends on `thread_pool::omp` respect the partition, the other thread pools run on the full width.
+ *
+ *   The fields are tracked while the computation is in flight. `run_async` throws `std::runtime_error` if the new
+ *   computation writes a field that is used by an in-flight one or reads a field that an in-flight computation writes.
+ *   Fields are identified by their origin pointers: the `data_store`s and other pointer based SIDs are tracked, the
+ *   SIDs with the non-pointer origins (like `global_parameter`) are not. Note that two SIDs that view the same
+ *   buffer with the different origins are not recognized as the same field. The host code that touches the fields
+ *   of an in-flight computation is not checked either.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../meta.hpp"
+#include "../../sid/as_const.hpp"
+#include "../../sid/concept.hpp"
+#include "../../sid/convert.hpp"
+#include "../../thread_pool/partition.hpp"
+#include "../common/intent.hpp"
+#include "run.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace frontend_impl_ {
+            struct field_use {
+                void const *ptr;
+                bool written;
+            };
+
+            template <class T>
+            void const *field_key(T *ptr) {
+                return ptr;
+            }
+
+            template <class Storage, class Compute>
+            void const *field_key(sid::converting_ptr<Storage, Compute> ptr) {
+                return ptr.m_ptr;
+            }
+
+            template <class T>
+            void const *field_key(T const &) {
+                return nullptr;
+            }
+
+            // the address only: the origin is taken read only (see `sid_get_const_origin` in `storage/sid.hpp`)
+            template <class Field>
+            void const *field_address(Field &field) {
+                auto &&const_field = sid::as_const(field);
+                return field_key(sid::get_origin(const_field)());
+            }
+
+            /**
+             *  The set of the fields that are used by the in-flight computations.
+             */
+            class field_registry {
+                struct entry {
+                    field_use use;
+                    size_t run;
+                };
+
+                std::mutex m_mutex;
+                std::vector<entry> m_entries;
+                size_t m_next_run = 0;
+
+              public:
+                static field_registry &get() {
+                    static field_registry res;
+                    return res;
+                }
+
+                // checks the uses against the in-flight computations, registers them and returns the run id
+                size_t acquire(std::vector<field_use> const &uses) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (auto &&use : uses)
+                        for (auto &&e : m_entries)
+                            if (e.use.ptr == use.ptr && (e.use.written || use.written))
+                                throw std::runtime_error(use.written
+                                                             ? "gridtools::stencil::run_async: the computation writes "
+                                                               "a field that is used by an in-flight computation"
+                                                             : "gridtools::stencil::run_async: the computation reads a "
+                                                               "field that is written by an in-flight computation");
+                    size_t run = m_next_run++;
+                    for (auto &&use : uses)
+                        m_entries.push_back({use, run});
+                    return run;
+                }
+
+                void release(size_t run) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_entries.erase(std::remove_if(m_entries.begin(),
+                                        m_entries.end(),
+                                        [run](entry const &e) { return e.run == run; }),
+                        m_entries.end());
+                }
+            };
+
+            class release_guard {
+                size_t m_run;
+
+              public:
+                explicit release_guard(size_t run) : m_run(run) {}
+                ~release_guard() { field_registry::get().release(m_run); }
+            };
+
+            /**
+             *  The host threads that execute the computations launched by `run_async`.
+             */
+            class async_workers {
+                std::mutex m_mutex;
+                std::condition_variable m_cv;
+                std::deque<std::packaged_task<void()>> m_tasks;
+                std::vector<std::thread> m_threads;
+                size_t m_idle = 0;
+                bool m_stop = false;
+
+                void work() {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    ++m_idle;
+                    while (true) {
+                        m_cv.wait(lock, [&] { return m_stop || !m_tasks.empty(); });
+                        // the pending tasks are completed before the stop
+                        if (m_tasks.empty())
+                            return;
+                        auto task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                        --m_idle;
+                        lock.unlock();
+                        task();
+                        lock.lock();
+                    }
+                }
+
+                // the worker is counted as idle again before the future of its task gets ready; otherwise a task
+                // submitted right after the `wait` would start a new thread
+                class idle_guard {
+                    async_workers &m_workers;
+
+                  public:
+                    explicit idle_guard(async_workers &workers) : m_workers(workers) {}
+                    ~idle_guard() {
+                        std::lock_guard<std::mutex> lock(m_workers.m_mutex);
+                        ++m_workers.m_idle;
+                    }
+                };
+
+                async_workers() = default;
+
+              public:
+                static async_workers &get() {
+                    static async_workers res;
+                    return res;
+                }
+
+                ~async_workers() {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stop = true;
+                    }
+                    m_cv.notify_all();
+                    for (auto &&thread : m_threads)
+                        thread.join();
+                }
+
+                size_t threads() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_threads.size();
+                }
+
+                template <class F>
+                std::future<void> submit(F &&f) {
+                    std::packaged_task<void()> task([this, f = std::forward<F>(f)]() mutable {
+                        idle_guard guard(*this);
+                        f();
+                    });
+                    auto res = task.get_future();
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_idle <= m_tasks.size())
+                        m_threads.emplace_back(&async_workers::work, this);
+                    m_tasks.push_back(std::move(task));
+                    m_cv.notify_one();
+                    return res;
+                }
+            };
+
+            /**
+             *  The handle of the computation launched by `run_async`.
+             */
+            class async_run {
+                std::future<void> m_future;
+
+              public:
+                async_run() = default;
+                explicit async_run(std::future<void> future) : m_future(std::move(future)) {}
+                async_run(async_run &&) = default;
+                async_run &operator=(async_run &&other) {
+                    if (this == &other)
+                        return *this;
+                    if (m_future.valid())
+                        m_future.wait();
+                    m_future = std::move(other.m_future);
+                    return *this;
+                }
+                ~async_run() {
+                    if (m_future.valid())
+                        m_future.wait();
+                }
+
+                /**
+                 *  `false` for the default constructed handles and after `wait`.
+                 */
+                bool valid() const { return m_future.valid(); }
+
+                bool ready() const {
+                    return !m_future.valid() ||
+                           m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                }
+
+                /**
+                 *  Blocks until the computation is finished. Rethrows the exception of the computation if any.
+                 */
+                void wait() {
+                    if (m_future.valid())
+                        m_future.get();
+                }
+            };
+
+            template <class Spec, size_t... Is, class... Fields>
+            std::vector<field_use> field_uses(std::index_sequence<Is...>, Fields &... fields) {
+                std::vector<field_use> res;
+                using loop_t = int[sizeof...(Is) + 1];
+                (void)loop_t{0,
+                    (res.push_back(
+                         {field_address(fields),
+                             decltype(get_arg_intent(Spec(), arg<Is>()))::value == intent::inout}),
+                        0)...};
+                res.erase(std::remove_if(res.begin(), res.end(), [](field_use const &use) { return !use.ptr; }),
+                    res.end());
+                return res;
+            }
+
+            template <class Comp, class Backend, class Grid, class Fields, size_t... Is>
+            void run_tuple(Comp comp, Backend &be, Grid const &grid, Fields &fields, std::index_sequence<Is...>) {
+                run(comp, be, grid, std::get<Is>(fields)...);
+            }
+
+            template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
+            auto run_async_impl(std::unique_ptr<thread_pool::partition> part,
+                Comp comp,
+                Backend &&be,
+                Grid const &grid,
+                std::index_sequence<Is...>,
+                Fields &&... fields) -> decltype(void(comp(arg<Is>()...)), async_run()) {
+                using spec_t = decltype(comp(arg<Is>()...));
+                check_spec<spec_t, Grid>();
+                check_bounds<spec_t>(grid, std::index_sequence<Is...>(), fields...);
+                size_t id = field_registry::get().acquire(field_uses<spec_t>(std::index_sequence<Is...>(), fields...));
+                std::future<void> future;
+                try {
+                    future = async_workers::get().submit([comp,
+                                                             be = std::decay_t<Backend>(std::forward<Backend>(be)),
+                                                             grid,
+                                                             fields = std::make_tuple(std::forward<Fields>(fields)...),
+                                                             id,
+                                                             part = std::move(part)]() mutable {
+                        release_guard guard(id);
+                        std::unique_ptr<thread_pool::scoped_partition> scope;
+                        if (part)
+                            scope.reset(new thread_pool::scoped_partition(*part));
+                        run_tuple(comp, be, grid, fields, std::index_sequence<Is...>());
+                    });
+                } catch (...) {
+                    field_registry::get().release(id);
+                    throw;
+                }
+                return async_run(std::move(future));
+            }
+
+            template <class... Ts>
+            void run_async_impl(Ts...) {
+                static_assert(sizeof...(Ts) < 0, "Unexpected first argument of gridtools::stencil::run_async.");
+            }
+
+            /**
+             *  Same signature as `run`, but the computation is executed asynchronously.
+             */
+            template <class Comp,
+                class Backend,
+                class Grid,
+                class... Fields,
+                std::enable_if_t<!std::is_same<Comp, thread_pool::partition>::value, int> = 0>
+            async_run run_async(Comp comp, Backend &&be, Grid const &grid, Fields &&... fields) {
+                static_assert(
+                    conjunction<is_sid<Fields>...>::value, "All computation fields must satisfy SID concept.");
+                return run_async_impl(std::unique_ptr<thread_pool::partition>(),
+                    comp,
+                    std::forward<Backend>(be),
+                    grid,
+                    std::index_sequence_for<Fields...>(),
+                    std::forward<Fields>(fields)...);
+            }
+
+            /**
+             *  The computation is executed asynchronously within the given partition of the thread pool.
+             */
+            template <class Comp, class Backend, class Grid, class... Fields>
+            async_run run_async(
+                thread_pool::partition const &part, Comp comp, Backend &&be, Grid const &grid, Fields &&... fields) {
+                static_assert(
+                    conjunction<is_sid<Fields>...>::value, "All computation fields must satisfy SID concept.");
+                return run_async_impl(std::unique_ptr<thread_pool::partition>(new thread_pool::partition(part)),
+                    comp,
+                    std::forward<Backend>(be),
+                    grid,
+                    std::index_sequence_for<Fields...>(),
+                    std::forward<Fields>(fields)...);
+            }
+        } // namespace frontend_impl_
+        using frontend_impl_::async_run;
+        using frontend_impl_::run_async;
+    } // namespace stencil
+} // namespace gridtools
@@ -0,0 +1,131 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../common/hymap.hpp"
+#include "../../meta.hpp"
+#include "../../sid/concept.hpp"
+#include "../core/backend.hpp"
+#include "../core/profiling.hpp"
+#include "run.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace batched_frontend_impl_ {
+            template <class Field>
+            struct member_type {
+                using type = Field const &;
+            };
+
+            template <class T, class A>
+            struct member_type<std::vector<T, A>> {
+                using type = T const &;
+            };
+
+            template <class Field>
+            using member_t = typename member_type<std::decay_t<Field>>::type;
+
+            template <class Field>
+            struct is_batched : std::false_type {};
+
+            template <class T, class A>
+            struct is_batched<std::vector<T, A>> : std::true_type {};
+
+            // the shared fields are accessed by all members concurrently, they can only be read
+            template <class Spec, class Arg, class Field>
+            using is_valid_shared_field = bool_constant<is_batched<std::decay_t<Field>>::value ||
+                !meta::st_contains<frontend_impl_::all_rw_args<Spec>, Arg>::value>;
+
+            template <class Field>
+            Field const &get_member(Field const &field, size_t) {
+                return field;
+            }
+
+            template <class T, class A>
+            T const &get_member(std::vector<T, A> const &field, size_t member) {
+                return field[member];
+            }
+
+            template <class Field>
+            size_t get_members_count(Field const &) {
+                return size_t(-1);
+            }
+
+            template <class T, class A>
+            size_t get_members_count(std::vector<T, A> const &field) {
+                return field.size();
+            }
+
+            template <class... Fields>
+            size_t members_count(Fields const &... fields) {
+                size_t res = size_t(-1);
+                for (size_t count : {size_t(-1), get_members_count(fields)...}) {
+                    if (count == size_t(-1))
+                        continue;
+                    if (res != size_t(-1) && res != count)
+                        throw std::invalid_argument("gridtools::stencil::run_batched: all batched fields should have "
+                                                    "the same number of members");
+                    res = count;
+                }
+                return res == size_t(-1) ? 1 : res;
+            }
+
+            template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
+            auto run_impl(Comp comp, Backend &&be, Grid const &grid, std::index_sequence<Is...>, Fields &&... fields)
+                -> void_t<decltype(comp(frontend_impl_::arg<Is>()...))> {
+                using spec_t = decltype(comp(frontend_impl_::arg<Is>()...));
+                frontend_impl_::check_spec<spec_t, Grid>();
+                static_assert(conjunction<is_valid_shared_field<spec_t, frontend_impl_::arg<Is>, Fields>...>::value,
+                    "The fields that are shared by all members should not be written by the computation.");
+                using data_store_map_t =
+                    typename hymap::keys<frontend_impl_::arg<Is>...>::template values<member_t<Fields>...>;
+                size_t count = members_count(fields...);
+                std::vector<data_store_map_t> members;
+                members.reserve(count);
+                for (size_t m = 0; m != count; ++m) {
+                    frontend_impl_::check_bounds<spec_t>(grid, std::index_sequence<Is...>(), get_member(fields, m)...);
+                    members.push_back(data_store_map_t{get_member(fields, m)...});
+                }
+                GT_PROFILING_REGION((core::region_name<core::batched_region, core::spec_functors<spec_t>>()));
+                core::call_batched_entry_point_f<spec_t>()(std::forward<Backend>(be), grid, std::move(members));
+            }
+
+            template <class... Ts>
+            void run_impl(Ts...) {
+                static_assert(sizeof...(Ts) < 0, "Unexpected first argument of gridtools::stencil::run_batched.");
+            }
+
+            /**
+             *  Runs the same computation over several independent ensemble members within one launch.
+             *
+             *  The fields that are passed as `std::vector` provide one SID per member, all of them should have the
+             *  same size, `std::invalid_argument` is thrown otherwise. The rest of the fields are shared by all members
+             *  and should be read only.
+             */
+            template <class Comp, class Backend, class Grid, class... Fields>
+            void run_batched(Comp comp, Backend &&be, Grid const &grid, Fields &&... fields) {
+                static_assert(conjunction<is_sid<std::decay_t<member_t<Fields>>>...>::value,
+                    "All computation fields (or the elements of the batched ones) must satisfy SID concept.");
+                run_impl(comp,
+                    std::forward<Backend>(be),
+                    grid,
+                    std::index_sequence_for<Fields...>(),
+                    std::forward<Fields>(fields)...);
+            }
+        } // namespace batched_frontend_impl_
+        using batched_frontend_impl_::run_batched;
+    } // namespace stencil
+} // namespace gridtools
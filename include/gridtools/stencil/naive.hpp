@@ -26,6 +26,7 @@
 #include "../sid/sid_shift_origin.hpp"
 #include "be_api.hpp"
 #include "common/dim.hpp"
+#include "core/profiling.hpp"
 
 namespace gridtools {
     namespace stencil {
@@ -46,8 +47,11 @@ namespace gridtools {
                     auto sizes = tuple_util::make<hymap::keys<dim::c, dim::k, dim::j, dim::i>::values>(
                         num_colors, grid.k_size(interval, extent), grid.j_size(extent), grid.i_size(extent));
                     using stride_kind = meta::list<decltype(extent), decltype(num_colors)>;
-                    return sid::shift_sid_origin(
-                        sid::make_contiguous<decltype(info.data()), ptrdiff_t, stride_kind>(alloc, sizes), offsets);
+                    return be_api::convert_tmp_storage(info,
+                        sid::shift_sid_origin(
+                            sid::make_contiguous<be_api::tmp_storage_type<decltype(info)>, ptrdiff_t, stride_kind>(
+                                alloc, sizes),
+                            offsets));
                 });
                 auto data_stores = hymap::concat(external_data_stores, temporaries);
                 using plh_map_t = typename stages_t::plh_map_t;
@@ -60,20 +64,24 @@ namespace gridtools {
                 auto origin = sid::get_origin(composite);
                 auto strides = sid::get_strides(composite);
                 for_each<stages_t>([&](auto stage) {
-                    tuple_util::for_each(
-                        [&](auto cell) {
-                            auto ptr = origin();
-                            auto extent = cell.extent();
-                            auto interval = cell.interval();
-                            sid::shift(ptr, sid::get_stride<dim::i>(strides), extent.minus(dim::i()));
-                            sid::shift(ptr, sid::get_stride<dim::j>(strides), extent.minus(dim::j()));
-                            sid::shift(ptr, sid::get_stride<dim::k>(strides), grid.k_start(interval, cell.execution()));
-                            auto i_loop = sid::make_loop<dim::i>(grid.i_size(extent));
-                            auto j_loop = sid::make_loop<dim::j>(grid.j_size(extent));
-                            auto k_loop = sid::make_loop<dim::k>(grid.k_size(interval), cell.k_step());
-                            i_loop(j_loop(k_loop(cell)))(ptr, strides);
-                        },
-                        stage.cells());
+                    core::profile_stage<decltype(stage)>([&] {
+                        tuple_util::for_each(
+                            [&](auto cell) {
+                                auto ptr = origin();
+                                auto extent = cell.extent();
+                                auto interval = cell.interval();
+                                sid::shift(ptr, sid::get_stride<dim::i>(strides), extent.minus(dim::i()));
+                                sid::shift(ptr, sid::get_stride<dim::j>(strides), extent.minus(dim::j()));
+                                sid::shift(ptr,
+                                    sid::get_stride<dim::k>(strides),
+                                    grid.k_start(interval, cell.execution()));
+                                auto i_loop = sid::make_loop<dim::i>(grid.i_size(extent));
+                                auto j_loop = sid::make_loop<dim::j>(grid.j_size(extent));
+                                auto k_loop = sid::make_loop<dim::k>(grid.k_size(interval), cell.k_step());
+                                i_loop(j_loop(k_loop(cell)))(ptr, strides);
+                            },
+                            stage.cells());
+                    })();
                 });
             }
         };
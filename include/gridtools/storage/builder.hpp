@@ -17,11 +17,13 @@
 #include "../common/hymap.hpp"
 #include "../common/integral_constant.hpp"
 #include "../common/layout_map.hpp"
+#include "../common/stride_padding.hpp"
 #include "../common/tuple.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
 #include "../sid/unknown_kind.hpp"
 #include "data_store.hpp"
+#include "pool.hpp"
 #include "traits.hpp"
 
 namespace gridtools {
@@ -35,6 +37,10 @@ namespace gridtools {
                 struct halos {};
                 struct initializer {};
                 struct layout {};
+                struct padding {};
+                struct storage_type {};
+                struct bundle {};
+                struct pool {};
             } // namespace param
 
             template <class T>
@@ -103,6 +109,13 @@ namespace gridtools {
                 };
             }
 
+            struct no_pool {
+                template <class Traits, class T, class Id, class... Args>
+                static auto make_data_store(Args const &... args) {
+                    return storage::make_data_store<Traits, T, Id>(args...);
+                }
+            };
+
             template <class Traits, class Layout>
             struct custom_traits : Traits {
                 friend Layout storage_layout(custom_traits, std::integral_constant<size_t, Layout::masked_length>) {
@@ -110,6 +123,75 @@ namespace gridtools {
                 }
             };
 
+            template <class Traits, class Padding>
+            struct padded_traits : Traits {
+                friend Padding storage_padding(padded_traits) { return {}; }
+            };
+
+            template <class Traits, class Compute>
+            struct compute_traits : Traits {
+                friend meta::lazy::id<Compute> storage_compute_type(compute_traits) { return {}; }
+            };
+
+            // the element type of the data store and the traits that know the compute type
+            template <class Traits, class T, class Storage>
+            struct storage_params {
+                using traits_t = compute_traits<Traits, std::remove_const_t<T>>;
+                using data_t = std::conditional_t<std::is_const<T>::value, Storage const, Storage>;
+            };
+
+            template <class Traits, class T>
+            struct storage_params<Traits, T, void> {
+                using traits_t = Traits;
+                using data_t = T;
+            };
+
+            template <class Layout>
+            struct bundled_layout;
+
+            // the member dimension goes next to the innermost one: the members are interleaved by the innermost rows
+            template <int... Args>
+            struct bundled_layout<layout_map<Args...>> {
+                static constexpr int innermost = layout_map<Args...>::max_arg;
+                using type = meta::if_c<(innermost < 0),
+                    layout_map<Args..., 0>,
+                    layout_map<(Args == innermost ? Args + 1 : Args)..., innermost>>;
+            };
+
+            // the layout traits, lengths and halos of the data store without the bundle
+            template <class Traits, class Layout, class Bundle, size_t Dims>
+            struct bundle_params {
+                using traits_t = meta::if_c<std::is_void<Layout>::value, Traits, custom_traits<Traits, Layout>>;
+
+                template <class Lengths>
+                static Lengths const &lengths(Lengths const &src) {
+                    return src;
+                }
+
+                static array<int, Dims> const &halos(array<int, Dims> const &src) { return src; }
+            };
+
+            // the bundle of `N` fields is the data store with the extra (last) dimension of the length `N`
+            template <class Traits, class Layout, size_t N, size_t Dims>
+            struct bundle_params<Traits, Layout, std::integral_constant<size_t, N>, Dims> {
+                using traits_t = custom_traits<Traits,
+                    typename bundled_layout<
+                        meta::if_c<std::is_void<Layout>::value, traits::layout_type<Traits, Dims>, Layout>>::type>;
+
+                template <class Lengths>
+                static auto lengths(Lengths const &src) {
+                    return tuple_util::deep_copy(tuple_util::push_back(src, integral_constant<int_t, N>()));
+                }
+
+                static array<int, Dims + 1> halos(array<int, Dims> const &src) {
+                    array<int, Dims + 1> res;
+                    for (size_t i = 0; i < Dims; ++i)
+                        res[i] = src[i];
+                    res[Dims] = 0;
+                    return res;
+                }
+            };
+
             template <class... Keys>
             struct keys {
                 template <class... Vals>
@@ -264,6 +346,51 @@ namespace gridtools {
                     return add_type<param::layout, layout_t>();
                 }
 
+                /**
+                 *  Pads the strides with the `Padding` policy to avoid the cache set and 4K aliasing (see
+                 *  `common/stride_padding.hpp`).
+                 */
+                template <class Padding = stride_padding>
+                auto padding() const {
+                    static_assert(!has<param::padding>::value, "storage padding is set twice");
+                    return add_type<param::padding, Padding>();
+                }
+
+                /**
+                 *  Stores the elements as `T` (like `float` or `bfloat16`) while the stencils compute in the type set
+                 *  by `type<...>()`: the SID of the data store converts on load and store. The views access the
+                 *  buffer in the storage type.
+                 */
+                template <class T>
+                auto storage_type() const {
+                    static_assert(!has<param::storage_type>::value, "storage storage_type is set twice");
+                    static_assert(!std::is_const<T>::value, "use builder.type<T const>() for the read only storages");
+                    return add_type<param::storage_type, meta::lazy::id<T>>();
+                }
+
+                /**
+                 *  Builds the bundle of `N` fields of the same shape: the data store with the extra last dimension
+                 *  of the length `N` that indexes the members. The members are interleaved by the innermost rows, so
+                 *  that all of them share the strides and are traversed as a single memory stream (see
+                 *  `storage/bundle.hpp` for the member SIDs). The initializer takes the member index as the last
+                 *  argument.
+                 */
+                template <size_t N>
+                auto bundle() const {
+                    static_assert(!has<param::bundle>::value, "storage bundle is set twice");
+                    static_assert(N > 0, "the bundle should have at least one member");
+                    return add_type<param::bundle, std::integral_constant<size_t, N>>();
+                }
+
+                /**
+                 *  Takes the data stores from the `pool` and returns them there when they are released. The repeated
+                 *  builds with the same parameters don't allocate and the uninitialized data stores are not touched.
+                 */
+                auto pool(storage::pool value) const {
+                    static_assert(!has<param::pool>::value, "storage pool is set twice");
+                    return add_value<param::pool>(std::move(value));
+                }
+
                 auto name(std::string value) const {
                     static_assert(!has<param::name>::value, "storage name is set twice");
                     return add_value<param::name>(std::move(value));
@@ -303,15 +430,28 @@ namespace gridtools {
                 auto build() const {
                     static_assert(has<param::type>::value, "storage type is not set");
                     static_assert(has<param::lengths>::value, "storage lengths are not set");
-                    using traits_t =
-                        meta::if_c<has<param::layout>::value, custom_traits<Traits, value_type<param::layout>>, Traits>;
                     auto &&lengths = value<param::lengths>();
+                    constexpr auto n = tuple_util::size<std::decay_t<decltype(lengths)>>::value;
+                    using bundle_params_t =
+                        bundle_params<Traits, value_type<param::layout>, value_type<param::bundle>, n>;
+                    using layout_traits_t = typename bundle_params_t::traits_t;
+                    using padded_traits_t = meta::if_c<has<param::padding>::value,
+                        padded_traits<layout_traits_t, value_type<param::padding>>,
+                        layout_traits_t>;
+                    using params_t = storage_params<padded_traits_t,
+                        typename value_type<param::type>::type,
+                        typename meta::if_c<has<param::storage_type>::value,
+                            value_type<param::storage_type>,
+                            meta::lazy::id<void>>::type>;
+                    using traits_t = typename params_t::traits_t;
                     auto &&name = value<param::name, std::string>();
-                    constexpr auto n = tuple_util::size<decltype(lengths)>::value;
                     auto &&halos = value<param::halos, array<int, n>>();
                     auto initializer = value<param::initializer, uninitialized>();
-                    return make_data_store<traits_t, typename value_type<param::type>::type, value_type<param::id>>(
-                        name, lengths, halos, initializer);
+                    return value<param::pool, no_pool>()
+                        .template make_data_store<traits_t, typename params_t::data_t, value_type<param::id>>(name,
+                            bundle_params_t::lengths(lengths),
+                            bundle_params_t::halos(halos),
+                            initializer);
                 }
 
                 auto operator()() const { return build(); }
@@ -0,0 +1,72 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "../common/hymap.hpp"
+#include "../common/integral_constant.hpp"
+#include "../common/tuple.hpp"
+#include "../common/tuple_util.hpp"
+#include "../sid/sid_shift_origin.hpp"
+#include "data_store.hpp"
+#include "sid.hpp"
+
+/**
+ *   The members of the field bundles (see `builder.bundle<N>()`).
+ *
+ *   The member SIDs are the bundle data store with the origin shifted along the member dimension. They share the
+ *   strides and the strides kind of the bundle, so that the stride deduplication of `sid::composite` keeps a single
+ *   set of strides for all members of the bundle.
+ */
+namespace gridtools {
+    namespace storage {
+        namespace bundle_impl_ {
+            template <class DataStore>
+            using member_dim = integral_constant<int, DataStore::ndims - 1>;
+
+            template <class DataStore>
+            using bundle_size = std::decay_t<decltype(tuple_util::get<DataStore::ndims - 1>(
+                std::declval<DataStore const &>().native_lengths()))>;
+
+            template <class DataStore, class Offset>
+            auto member(std::shared_ptr<DataStore> const &ds, Offset offset) {
+                static_assert(is_integral_constant<bundle_size<DataStore>>::value,
+                    "the data store is not built with builder.bundle<N>()");
+                return sid::shift_sid_origin(
+                    ds, tuple_util::make<hymap::keys<member_dim<DataStore>>::template values>(offset));
+            }
+
+            template <class DataStore, size_t... Is>
+            auto members(std::shared_ptr<DataStore> const &ds, std::index_sequence<Is...>) {
+                return tuple_util::make<tuple>(member(ds, integral_constant<int, Is>())...);
+            }
+        } // namespace bundle_impl_
+
+        /**
+         *  The SID of the member `n` of the bundle `ds`.
+         */
+        template <class DataStore>
+        auto bundle_member(std::shared_ptr<DataStore> const &ds, int n) {
+            return bundle_impl_::member(ds, n);
+        }
+
+        /**
+         *  The tuple of the SIDs of all members of the bundle `ds`.
+         */
+        template <class DataStore>
+        auto bundle_members(std::shared_ptr<DataStore> const &ds) {
+            return bundle_impl_::members(
+                ds, std::make_index_sequence<bundle_impl_::bundle_size<DataStore>::value>());
+        }
+    } // namespace storage
+} // namespace gridtools
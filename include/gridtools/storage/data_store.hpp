@@ -20,7 +20,9 @@
 #include "../common/layout_map.hpp"
 #include "../common/numeric.hpp"
 #include "data_view.hpp"
+#include "dirty_ranges.hpp"
 #include "info.hpp"
+#include "snapshot.hpp"
 #include "traits.hpp"
 
 namespace gridtools {
@@ -47,6 +49,7 @@ namespace gridtools {
               public:
                 using layout_t = traits::layout_type<Traits, Info::ndims>;
                 using data_t = T;
+                using compute_t = traits::compute_type<Traits, T>;
                 using kind_t = Kind;
                 static constexpr size_t ndims = Info::ndims;
 
@@ -86,17 +89,25 @@ namespace gridtools {
                 enum state { synced, invalid_host, invalid_target };
                 state m_state;
                 std::unique_ptr<T[]> m_host_ptr;
+                // the parts of the host buffer that are not yet copied to the target if `m_state == invalid_target`
+                dirty_ranges m_dirty;
+                snapshot_impl_::snapshot_list<T> m_snapshots;
 
                 void update_target() {
                     if (m_state != invalid_target)
                         return;
-                    traits::update_target<Traits>(this->raw_target_ptr(), m_host_ptr.get(), this->info().length());
+                    m_dirty.for_each_batch([&](int begin, int width, int count, int pitch) {
+                        traits::update_target_strided<Traits>(
+                            this->raw_target_ptr() + begin, m_host_ptr.get() + begin, width, count, pitch);
+                    });
+                    m_dirty.clear();
                     m_state = synced;
                 }
 
                 void update_host() {
                     if (m_state != invalid_host)
                         return;
+                    m_snapshots.before_write();
                     traits::update_host<Traits>(m_host_ptr.get(), this->raw_target_ptr(), this->info().length());
                     m_state = synced;
                 }
@@ -112,6 +123,7 @@ namespace gridtools {
                     : data_store::base(std::move(name), std::move(info), halos), m_state(invalid_target),
                       m_host_ptr(std::make_unique<T[]>(this->info().length())) {
                     initializer(m_host_ptr.get(), typename data_store::layout_t(), this->info());
+                    m_dirty.add(0, this->info().length());
                 }
 
                 T *get_target_ptr() {
@@ -127,16 +139,38 @@ namespace gridtools {
 
                 T *get_host_ptr() {
                     update_host();
+                    m_snapshots.before_write();
                     m_state = invalid_target;
+                    m_dirty.add(0, this->info().length());
                     return m_host_ptr.get();
                 }
 
+                /**
+                 *  The host pointer for the caller that modifies only the box `[lower, upper)` of the indices: only
+                 *  that box is copied to the target on the next target access.
+                 */
+                T *get_host_ptr(array<int, Info::ndims> const &lower, array<int, Info::ndims> const &upper) {
+                    update_host();
+                    m_snapshots.before_write(this->info(), lower, upper);
+                    m_state = invalid_target;
+                    m_dirty.add(this->info(), lower, upper);
+                    return m_host_ptr.get();
+                }
+
+                /**
+                 *  Registers the copy-on-write snapshot of the host buffer (see `snapshot.hpp`).
+                 */
+                auto add_snapshot() { return m_snapshots.add(get_const_host_ptr(), this->info().length()); }
+
                 T const *get_const_host_ptr() {
                     update_host();
                     return m_host_ptr.get();
                 }
 
                 auto host_view() { return make_host_view(get_host_ptr(), this->info()); }
+                auto host_view(array<int, Info::ndims> const &lower, array<int, Info::ndims> const &upper) {
+                    return make_host_view(get_host_ptr(lower, upper), this->info());
+                }
                 auto const_host_view() { return make_host_view(get_const_host_ptr(), this->info()); }
 
                 auto target_view() { return traits::make_target_view<Traits>(get_target_ptr(), this->info()); }
@@ -147,6 +181,8 @@ namespace gridtools {
 
             template <class Traits, class T, class Info, class Kind>
             class data_store<Traits, T, Info, Kind, false, true> : public base<Traits, T, Info, Kind> {
+                mutable snapshot_impl_::snapshot_list<T> m_snapshots;
+
               public:
                 template <class Halos>
                 data_store(std::string name, Info info, Halos const &halos, uninitialized const &)
@@ -158,7 +194,10 @@ namespace gridtools {
                     initializer(this->raw_target_ptr(), typename data_store::layout_t(), this->info());
                 }
 
-                T *get_target_ptr() const { return this->raw_target_ptr(); }
+                T *get_target_ptr() const {
+                    m_snapshots.before_write();
+                    return this->raw_target_ptr();
+                }
                 T const *get_const_target_ptr() const { return this->raw_target_ptr(); }
 
                 auto target_view() const { return traits::make_target_view<Traits>(get_target_ptr(), this->info()); }
@@ -167,9 +206,21 @@ namespace gridtools {
                 }
 
                 T *get_host_ptr() { return get_target_ptr(); }
+                T *get_host_ptr(array<int, Info::ndims> const &lower, array<int, Info::ndims> const &upper) const {
+                    m_snapshots.before_write(this->info(), lower, upper);
+                    return this->raw_target_ptr();
+                }
                 T const *get_const_host_ptr() { return get_const_target_ptr(); }
                 auto host_view() const { return target_view(); }
+                auto host_view(array<int, Info::ndims> const &lower, array<int, Info::ndims> const &upper) const {
+                    return traits::make_target_view<Traits>(get_host_ptr(lower, upper), this->info());
+                }
                 auto const_host_view() const { return const_target_view(); }
+
+                /**
+                 *  Registers the copy-on-write snapshot of the buffer (see `snapshot.hpp`).
+                 */
+                auto add_snapshot() const { return m_snapshots.add(this->raw_target_ptr(), this->info().length()); }
             };
 
             template <class Traits, class T, class Info, class Kind, bool IsHostRefrenceable>
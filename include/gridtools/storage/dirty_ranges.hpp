@@ -0,0 +1,169 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../common/array.hpp"
+
+namespace gridtools {
+    namespace storage {
+        /**
+         *  The set of the modified ranges `[begin, end)` of the buffer of the data store.
+         *
+         *  The ranges are kept sorted and merged, so that each of them is synchronized with a single copy. The boxes
+         *  of indices are decomposed into the contiguous slabs: the dimensions that are covered in full are merged with
+         *  the next outer one.
+         */
+        class dirty_ranges {
+            std::vector<std::pair<int, int>> m_ranges;
+
+            void normalize() {
+                if (m_ranges.empty())
+                    return;
+                std::sort(m_ranges.begin(), m_ranges.end());
+                auto dst = m_ranges.begin();
+                for (auto src = m_ranges.begin() + 1; src < m_ranges.end(); ++src) {
+                    if (src->first <= dst->second)
+                        dst->second = std::max(dst->second, src->second);
+                    else
+                        *++dst = *src;
+                }
+                m_ranges.erase(dst + 1, m_ranges.end());
+            }
+
+            template <size_t N>
+            void add_slabs(array<int, N> const &dims,
+                size_t n,
+                int base,
+                array<int, N> const &lower,
+                array<int, N> const &upper,
+                array<int, N> const &strides,
+                int slab) {
+                if (n == 0) {
+                    m_ranges.emplace_back(base, base + slab);
+                    return;
+                }
+                auto dim = dims[n - 1];
+                for (int i = lower[dim]; i < upper[dim]; ++i)
+                    add_slabs(dims, n - 1, base + i * strides[dim], lower, upper, strides, slab);
+            }
+
+          public:
+            bool empty() const { return m_ranges.empty(); }
+            void clear() { m_ranges.clear(); }
+            auto begin() const { return m_ranges.begin(); }
+            auto end() const { return m_ranges.end(); }
+
+            /**
+             *  Calls `f(begin, width, count, pitch)` for the batches of the ranges that can be synchronized with a
+             *  single strided copy: `count` ranges of the same `width` that start `pitch` elements apart. The strips of
+             *  a box (like a halo) form such progressions even if they are interleaved with the strips of the others.
+             */
+            template <class F>
+            void for_each_batch(F &&f) const {
+                size_t n = m_ranges.size();
+                std::vector<bool> done(n);
+                auto find = [&](int begin) {
+                    auto it = std::lower_bound(m_ranges.begin(),
+                        m_ranges.end(),
+                        begin,
+                        [](std::pair<int, int> const &range, int begin) { return range.first < begin; });
+                    return it != m_ranges.end() && it->first == begin ? size_t(it - m_ranges.begin()) : n;
+                };
+                auto progression = [&](int begin, int width, int pitch) {
+                    size_t res = 1;
+                    for (size_t i; (i = find(begin + (int)res * pitch)) != n && !done[i] &&
+                                   m_ranges[i].second - m_ranges[i].first == width;)
+                        ++res;
+                    return res;
+                };
+                for (size_t i = 0; i != n; ++i) {
+                    if (done[i])
+                        continue;
+                    int begin = m_ranges[i].first;
+                    int width = m_ranges[i].second - begin;
+                    int pitch = width;
+                    size_t count = 1;
+                    // the candidate pitches are the distances to the next few ranges of the same width
+                    for (size_t j = i + 1, candidates = 0; j != n && candidates != 4; ++j) {
+                        if (done[j] || m_ranges[j].second - m_ranges[j].first != width)
+                            continue;
+                        ++candidates;
+                        int cur_pitch = m_ranges[j].first - begin;
+                        size_t cur_count = progression(begin, width, cur_pitch);
+                        if (cur_count > count) {
+                            count = cur_count;
+                            pitch = cur_pitch;
+                        }
+                    }
+                    for (size_t c = 0; c != count; ++c)
+                        done[find(begin + (int)c * pitch)] = true;
+                    f(begin, width, (int)count, pitch);
+                }
+            }
+
+            void add(int begin, int end) {
+                if (begin >= end)
+                    return;
+                m_ranges.emplace_back(begin, end);
+                normalize();
+            }
+
+            /**
+             *  Adds the elements of the box `[lower, upper)` of the data store with the meta data `info`.
+             */
+            template <class Info, size_t N = Info::ndims>
+            void add(Info const &info, array<int, N> const &lower, array<int, N> const &upper) {
+                array<int, N> lengths, strides, dims;
+                size_t n = 0;
+                for (size_t i = 0; i < N; ++i) {
+                    if (lower[i] >= upper[i])
+                        return;
+                    lengths[i] = info.lengths()[i];
+                    strides[i] = info.strides()[i];
+                    // the masked dimensions don't contribute to the address
+                    if (strides[i])
+                        dims[n++] = i;
+                }
+                // the dimensions from the innermost to the outermost (insertion sort, `n` is tiny)
+                for (size_t i = 1; i < n; ++i) {
+                    int cur = dims[i];
+                    size_t j = i;
+                    for (; j > 0 && strides[dims[j - 1]] > strides[cur]; --j)
+                        dims[j] = dims[j - 1];
+                    dims[j] = cur;
+                }
+                // the inner dimensions that are covered in full
+                size_t inner = 0;
+                while (inner < n && lower[dims[inner]] == 0 && upper[dims[inner]] == lengths[dims[inner]])
+                    ++inner;
+                int length = info.length();
+                if (inner == n) {
+                    add(0, length);
+                    return;
+                }
+                // the first partially covered dimension extends the slab of the full ones (with their padding)
+                auto dim = dims[inner];
+                int base = lower[dim] * strides[dim];
+                int slab = (upper[dim] - lower[dim] - (inner ? 0 : 1)) * strides[dim] + (inner ? 0 : 1);
+                array<int, N> outer;
+                for (size_t i = inner + 1; i < n; ++i)
+                    outer[i - inner - 1] = dims[i];
+                add_slabs(outer, n - inner - 1, base, lower, upper, strides, slab);
+                for (auto &range : m_ranges)
+                    range.second = std::min(range.second, length);
+                normalize();
+            }
+        };
+    } // namespace storage
+} // namespace gridtools
@@ -92,6 +92,18 @@ namespace gridtools {
                     cudaMemcpyHostToDevice));
             }
 
+            template <class T>
+            friend void storage_update_target_strided(
+                gpu, T *dst, T const *src, size_t width, size_t count, size_t pitch) {
+                GT_CUDA_CHECK(cudaMemcpy2D(const_cast<std::remove_volatile_t<T> *>(dst),
+                    pitch * sizeof(T),
+                    const_cast<std::remove_volatile_t<T> *>(src),
+                    pitch * sizeof(T),
+                    width * sizeof(T),
+                    count,
+                    cudaMemcpyHostToDevice));
+            }
+
             template <class T>
             friend void storage_update_host(gpu, T *dst, T const *src, size_t size) {
                 GT_CUDA_CHECK(cudaMemcpy(const_cast<std::remove_volatile_t<T> *>(dst),
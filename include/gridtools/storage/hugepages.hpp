@@ -0,0 +1,52 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+#include "../common/hugepage_alloc.hpp"
+
+namespace gridtools {
+    namespace storage {
+        namespace hugepages_impl_ {
+            struct deleter {
+                template <class T>
+                void operator()(T *p) const {
+                    hugepage_free(const_cast<std::remove_cv_t<T> *>(p));
+                }
+            };
+
+            struct default_policy {
+                static hugepage_policy policy() { return default_hugepage_policy(); }
+            };
+        } // namespace hugepages_impl_
+
+        /**
+         * @brief Storage traits that are the same as `Base`, but allocate with `hugepage_alloc` using the policy
+         * returned by `Policy::policy()`. E.g.:
+         *
+         *   struct gigantic {
+         *       static hugepage_policy policy() {
+         *           return {hugepage_mode::explicit_allocation, hugepage_size_1g, hugepage_prefault::first_touch};
+         *       }
+         *   };
+         *   auto builder = storage::builder<storage::hugepages<storage::cpu_kfirst, gigantic>>;
+         */
+        template <class Base, class Policy = hugepages_impl_::default_policy>
+        struct hugepages : Base {
+            template <class LazyType, class T = typename LazyType::type>
+            friend auto storage_allocate(hugepages, LazyType, size_t size) {
+                return std::unique_ptr<T[], hugepages_impl_::deleter>(
+                    static_cast<T *>(hugepage_alloc(size * sizeof(T), Policy::policy())));
+            }
+        };
+    } // namespace storage
+} // namespace gridtools
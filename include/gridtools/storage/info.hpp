@@ -12,6 +12,8 @@
 
 #include <cassert>
 #include <cstddef>
+#include <limits>
+#include <stdexcept>
 #include <type_traits>
 
 #include "../common/array.hpp"
@@ -78,9 +80,43 @@ namespace gridtools {
                     make_stride_f<Layout, Lengths>{lengths}, typename layout_tuple<Layout>::type());
             }
 
+            /**
+             *  The strides and the indices are `int_t`: the padded size of the data store should fit into it.
+             */
+            template <class PaddedLengths>
+            void check_size(PaddedLengths const &padded_lengths) {
+                long long size = 1;
+                tuple_util::for_each([&](auto length) { size *= length; }, padded_lengths);
+                if (size > std::numeric_limits<int_t>::max())
+                    throw std::length_error("the data store is too large to be indexed by int_t");
+            }
+
             template <class Layout, class Align, class Lengths>
             auto make_strides(Align align, Lengths const &lengths) {
-                return make_strides_helper<Layout>(make_padded_lengths<Layout>(align, lengths));
+                auto padded = make_padded_lengths<Layout>(align, lengths);
+                check_size(padded);
+                return make_strides_helper<Layout>(padded);
+            }
+
+            /**
+             *  The lengths padded to the alignment and then by the `Padding` policy: going from the innermost
+             *  dimension outwards, the length of each dimension is increased by `Padding::pad_length` until the stride
+             *  of the next dimension is acceptable for the policy. The innermost dimension is padded in the steps of
+             *  the alignment, the others row by row (plane by plane).
+             */
+            template <class Layout, class Padding, class Align, class Lengths, size_t... Is>
+            array<int_t, sizeof...(Is)> make_policy_padded_lengths(
+                Align align, Lengths const &lengths, size_t elem_size, std::index_sequence<Is...>) {
+                auto padded = make_padded_lengths<Layout>(align, lengths);
+                array<int_t, sizeof...(Is)> res = {{(int_t)tuple_util::get<Is>(padded)...}};
+                size_t stride = elem_size;
+                for (int n = Layout::max_arg; n > 0; --n) {
+                    auto dim = Layout::find(n);
+                    res[dim] = Padding::pad_length(res[dim], stride, n == Layout::max_arg ? (int_t)align : 1);
+                    stride *= res[dim];
+                }
+                check_size(res);
+                return res;
             }
 
             template <class Lengths, class Strides, class = std::make_index_sequence<tuple_util::size<Lengths>::value>>
@@ -148,6 +184,18 @@ namespace gridtools {
             auto make_info(Align align, Lengths const &lengths) {
                 return make_info_helper(lengths, make_strides<Layout>(align, lengths));
             }
+
+            /**
+             *  Same as above, but the strides are additionally padded by the `Padding` policy (see
+             *  `common/stride_padding.hpp`). All strides of the unmasked dimensions except the innermost are runtime
+             *  values.
+             */
+            template <class Layout, class Align, class Lengths, class Padding>
+            auto make_info(Align align, Lengths const &lengths, Padding, size_t elem_size) {
+                return make_info_helper(lengths,
+                    make_strides_helper<Layout>(make_policy_padded_lengths<Layout, Padding>(
+                        align, lengths, elem_size, std::make_index_sequence<tuple_util::size<Lengths>::value>())));
+            }
         } // namespace info_impl_
         using info_impl_::make_info;
     } // namespace storage
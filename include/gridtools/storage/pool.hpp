@@ -0,0 +1,280 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../common/tuple_util.hpp"
+#include "data_store.hpp"
+#include "traits.hpp"
+
+/**
+ *   The pool of the data stores for the builders that are called repeatedly with the same parameters (see
+ *   `builder.pool(...)`).
+ *
+ *   The data stores are keyed by their type (that includes traits, element type and the type of the meta data), name,
+ *   lengths, strides and halos. When the last `shared_ptr` to a pooled data store dies, the data store goes back to
+ *   the pool instead of being deallocated. The next build with the same key takes it from the pool: the buffer is
+ *   reinitialized only if the initializer or the value is set.
+ *
+ *   In the steady state the pooled build doesn't allocate at all: the lookup is done by the hash of the key computed
+ *   in place and the control block of the returned `shared_ptr` is placed into the memory that the pool keeps with
+ *   the data store. Only if the previous control block of the data store is still held by a `weak_ptr` the new one is
+ *   allocated as usual.
+ *
+ *   The `pool` object is a handle: its copies share the same set of data stores. The data stores that outlive all the
+ *   handles are deallocated as usual.
+ */
+namespace gridtools {
+    namespace storage {
+        namespace pool_impl_ {
+            template <class Info, class Halos, class F>
+            void for_each_extent(Info const &info, Halos const &halos, F &&f) {
+                for (auto length : info.lengths())
+                    f(length);
+                for (auto stride : info.strides())
+                    f(stride);
+                tuple_util::for_each([&](int halo) { f(halo); }, halos);
+            }
+
+            template <class Info, class Halos>
+            size_t make_hash(std::type_index type, std::string const &name, Info const &info, Halos const &halos) {
+                size_t res = type.hash_code();
+                auto combine = [&](size_t value) { res ^= value + 0x9e3779b9 + (res << 6) + (res >> 2); };
+                combine(std::hash<std::string>()(name));
+                for_each_extent(info, halos, [&](int extent) { combine(std::hash<int>()(extent)); });
+                return res;
+            }
+
+            template <class Info, class Halos>
+            std::vector<int> make_shape(Info const &info, Halos const &halos) {
+                std::vector<int> res;
+                for_each_extent(info, halos, [&](int extent) { res.push_back(extent); });
+                return res;
+            }
+
+            template <class Info, class Halos>
+            bool same_shape(std::vector<int> const &shape, Info const &info, Halos const &halos) {
+                size_t i = 0;
+                bool res = true;
+                for_each_extent(info, halos, [&](int extent) {
+                    res = res && i < shape.size() && shape[i] == extent;
+                    ++i;
+                });
+                return res && i == shape.size();
+            }
+
+            /**
+             *  The pooled data store together with its key and the memory for the control block of the `shared_ptr`
+             *  that is handed out. The reference is held by the free list or by the handed out `shared_ptr` and one more
+             *  by the control block that is placed into `m_control_block`.
+             */
+            struct entry {
+                size_t m_hash;
+                std::type_index m_type;
+                std::string m_name;
+                std::vector<int> m_shape;
+                std::shared_ptr<void> m_ds;
+                std::atomic<int> m_refs{1};
+                std::atomic<bool> m_control_block_in_use{false};
+                void *m_control_block = nullptr;
+
+                entry(size_t hash, std::type_index type, std::string name, std::vector<int> shape)
+                    : m_hash(hash), m_type(type), m_name(std::move(name)), m_shape(std::move(shape)) {}
+
+                entry(entry const &) = delete;
+                entry &operator=(entry const &) = delete;
+
+                ~entry() { ::operator delete(m_control_block); }
+
+                void release() {
+                    if (--m_refs == 0)
+                        delete this;
+                }
+            };
+
+            /**
+             *  Places the control block into the memory of the entry if it is not occupied by the previous one.
+             *  The control block type is fixed for the data store type, so the memory is allocated once.
+             */
+            template <class T>
+            struct control_block_allocator {
+                using value_type = T;
+
+                entry *m_entry;
+
+                explicit control_block_allocator(entry *e) : m_entry(e) {}
+
+                template <class U>
+                control_block_allocator(control_block_allocator<U> const &other) : m_entry(other.m_entry) {}
+
+                T *allocate(size_t n) {
+                    if (n != 1 || m_entry->m_control_block_in_use.exchange(true))
+                        return static_cast<T *>(::operator new(n * sizeof(T)));
+                    if (!m_entry->m_control_block) {
+                        try {
+                            m_entry->m_control_block = ::operator new(sizeof(T));
+                        } catch (...) {
+                            m_entry->m_control_block_in_use = false;
+                            throw;
+                        }
+                    }
+                    ++m_entry->m_refs;
+                    return static_cast<T *>(m_entry->m_control_block);
+                }
+
+                void deallocate(T *ptr, size_t) {
+                    if (ptr != m_entry->m_control_block) {
+                        ::operator delete(ptr);
+                        return;
+                    }
+                    m_entry->m_control_block_in_use = false;
+                    m_entry->release();
+                }
+
+                template <class U>
+                bool operator==(control_block_allocator<U> const &other) const {
+                    return m_entry == other.m_entry;
+                }
+
+                template <class U>
+                bool operator!=(control_block_allocator<U> const &other) const {
+                    return m_entry != other.m_entry;
+                }
+            };
+
+            struct impl {
+                std::mutex m_mutex;
+                // the vectors are kept when they get empty, so that putting the entry back doesn't allocate
+                std::unordered_map<size_t, std::vector<entry *>> m_free;
+
+                impl() = default;
+                impl(impl const &) = delete;
+                impl &operator=(impl const &) = delete;
+
+                ~impl() { clear(); }
+
+                template <class Pred>
+                entry *take(size_t hash, Pred const &pred) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto it = m_free.find(hash);
+                    if (it == m_free.end())
+                        return nullptr;
+                    auto &entries = it->second;
+                    for (auto &e : entries) {
+                        if (!pred(*e))
+                            continue;
+                        auto res = e;
+                        e = entries.back();
+                        entries.pop_back();
+                        return res;
+                    }
+                    return nullptr;
+                }
+
+                void put(entry *e) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_free[e->m_hash].push_back(e);
+                }
+
+                size_t size() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    size_t res = 0;
+                    for (auto &&item : m_free)
+                        res += item.second.size();
+                    return res;
+                }
+
+                void clear() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (auto &&item : m_free)
+                        for (auto e : item.second) {
+                            e->m_ds.reset();
+                            e->release();
+                        }
+                    m_free.clear();
+                }
+            };
+
+            template <class Initializer, class DataStore>
+            void reinitialize(Initializer const &initializer, DataStore &ds) {
+                initializer(ds.get_host_ptr(), typename DataStore::layout_t(), ds.info());
+            }
+
+            template <class DataStore>
+            void reinitialize(uninitialized const &, DataStore &) {}
+        } // namespace pool_impl_
+
+        class pool {
+            std::shared_ptr<pool_impl_::impl> m_impl = std::make_shared<pool_impl_::impl>();
+
+          public:
+            /**
+             *  The pooled counterpart of `make_data_store`.
+             */
+            template <class Traits, class T, class Id, class Lengths, class Halos, class Initializer>
+            auto make_data_store(std::string const &name,
+                Lengths const &lengths,
+                Halos const &halos,
+                Initializer const &initializer) const {
+                static_assert(!std::is_const<T>::value, "the read only data stores can not be pooled");
+                auto info = traits::make_info<Traits, T>(lengths);
+                using data_store_t = data_store_impl_::
+                    data_store<Traits, T, decltype(info), traits::strides_kind<Traits, T, Lengths, Id>>;
+                std::type_index type = typeid(data_store_t);
+                auto hash = pool_impl_::make_hash(type, name, info, halos);
+                auto e = m_impl->take(hash, [&](pool_impl_::entry const &e) {
+                    return e.m_type == type && e.m_name == name && pool_impl_::same_shape(e.m_shape, info, halos);
+                });
+                if (e) {
+                    pool_impl_::reinitialize(initializer, *static_cast<data_store_t *>(e->m_ds.get()));
+                } else {
+                    std::unique_ptr<pool_impl_::entry> holder(
+                        new pool_impl_::entry(hash, type, name, pool_impl_::make_shape(info, halos)));
+                    holder->m_ds = std::make_shared<data_store_t>(name, std::move(info), halos, initializer);
+                    e = holder.release();
+                }
+                std::weak_ptr<pool_impl_::impl> owner = m_impl;
+                return std::shared_ptr<data_store_t>(
+                    static_cast<data_store_t *>(e->m_ds.get()),
+                    [owner = std::move(owner), e](data_store_t *) {
+                        if (auto impl = owner.lock()) {
+                            impl->put(e);
+                        } else {
+                            e->m_ds.reset();
+                            e->release();
+                        }
+                    },
+                    pool_impl_::control_block_allocator<data_store_t>(e));
+            }
+
+            /**
+             *  The number of the data stores that are waiting in the pool to be reused.
+             */
+            size_t size() const { return m_impl->size(); }
+
+            /**
+             *  Deallocates the data stores that are waiting in the pool.
+             */
+            void clear() const { m_impl->clear(); }
+        };
+    } // namespace storage
+} // namespace gridtools
@@ -20,6 +20,7 @@
 #include "../common/tuple.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
+#include "../sid/convert.hpp"
 #include "data_store.hpp"
 
 namespace gridtools {
@@ -44,6 +45,16 @@ namespace gridtools {
                 friend GT_FORCE_INLINE constexpr ptr_holder operator+(ptr_holder obj, empty_ptr_diff) { return obj; }
             };
 
+            template <class T>
+            ptr_holder<T> make_origin(T *ptr, meta::lazy::id<T>) {
+                return {ptr};
+            }
+
+            template <class T, class Compute>
+            sid::converting_ptr_holder<ptr_holder<T>, Compute> make_origin(T *ptr, meta::lazy::id<Compute>) {
+                return {{ptr}};
+            }
+
             template <class Dim>
             struct bound_generator_f {
                 template <class Lengths>
@@ -69,10 +80,24 @@ namespace gridtools {
 
         /**
          *   The functions below make `data_store` model the `SID` concept
+         *
+         *   The data stores with the compute type that differs from the element type (see `builder.storage_type`) have
+         *   the converting pointers (see `sid/convert.hpp`).
+         */
+        template <class DataStore, std::enable_if_t<is_data_store<DataStore>::value, int> = 0>
+        auto sid_get_origin(std::shared_ptr<DataStore> const &ds) {
+            using compute_t = typename DataStore::compute_t;
+            return storage_sid_impl_::make_origin(ds->get_target_ptr(), meta::lazy::id<compute_t>());
+        }
+
+        /**
+         *   The origin for the read only access (see `sid/as_const.hpp`): it does not save the snapshots of the data
+         *   store (see `snapshot.hpp`), those are saved only before the buffer can be modified.
          */
         template <class DataStore, std::enable_if_t<is_data_store<DataStore>::value, int> = 0>
-        storage_sid_impl_::ptr_holder<typename DataStore::data_t> sid_get_origin(std::shared_ptr<DataStore> const &ds) {
-            return {ds->get_target_ptr()};
+        auto sid_get_const_origin(std::shared_ptr<DataStore> const &ds) {
+            using compute_t = typename DataStore::compute_t;
+            return storage_sid_impl_::make_origin(ds->get_const_target_ptr(), meta::lazy::id<compute_t>());
         }
 
         template <class DataStore, std::enable_if_t<is_data_store<DataStore>::value, int> = 0>
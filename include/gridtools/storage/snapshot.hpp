@@ -0,0 +1,200 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../common/array.hpp"
+#include "dirty_ranges.hpp"
+
+/**
+ *   Copy-on-write snapshots of the data stores.
+ *
+ *   `storage::snapshot(ds)` returns the read only image of the host buffer of `ds` at the moment of the call. The
+ *   snapshot shares the memory with the live data store: nothing is copied until the data store hands out the
+ *   pointer that allows to modify the host buffer (`get_target_ptr()`/`get_host_ptr()` of the host referenceable data
+ *   stores, `get_host_ptr()` and the host update of the others). At that moment the blocks of the host buffer that
+ *   may be modified are saved into the snapshot first (only the given box for `get_host_ptr(lower, upper)`). The
+ *   stencils read their input fields via `get_const_target_ptr()` (see `sid_get_const_origin` in `sid.hpp`), that
+ *   saves nothing.
+ *
+ *   The snapshot can be read from the other thread while the computation goes on: the saving of the blocks and the
+ *   reading of each block are mutually exclusive. While no snapshot of the data store is alive, handing out the
+ *   pointers costs an atomic load only.
+ *
+ *   The pointers that were handed out before the snapshot was taken are not tracked. A `plan` (see `make_plan`)
+ *   takes the origins of its fields again before every execution, so it saves the snapshots taken after its
+ *   creation. The views that were obtained before the snapshot must not be used to modify the data store after it,
+ *   and the snapshot of a field that is written by an in-flight `run_async` computation should be taken after `wait`.
+ */
+namespace gridtools {
+    namespace storage {
+        namespace snapshot_impl_ {
+            template <class T>
+            class state {
+                static constexpr size_t block_size = std::max<size_t>(4096 / sizeof(T), 1);
+
+                T const *m_live;
+                size_t m_length;
+                std::unique_ptr<T[]> m_saved;
+                std::unique_ptr<std::atomic<bool>[]> m_is_saved;
+                mutable std::shared_timed_mutex m_mutex;
+
+                size_t num_blocks() const { return (m_length + block_size - 1) / block_size; }
+
+              public:
+                state(T const *live, size_t length)
+                    : m_live(live), m_length(length), m_is_saved(new std::atomic<bool>[num_blocks()]) {
+                    for (size_t i = 0; i != num_blocks(); ++i)
+                        m_is_saved[i] = false;
+                }
+
+                size_t length() const { return m_length; }
+
+                // saves the blocks that overlap with `[begin, end)` before they are modified in the live buffer
+                void save(size_t begin, size_t end) {
+                    std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+                    end = std::min(end, m_length);
+                    if (begin >= end)
+                        return;
+                    if (!m_saved)
+                        m_saved.reset(new T[m_length]);
+                    for (size_t block = begin / block_size; block * block_size < end; ++block) {
+                        if (m_is_saved[block])
+                            continue;
+                        size_t first = block * block_size;
+                        size_t last = std::min(first + block_size, m_length);
+                        std::copy(m_live + first, m_live + last, m_saved.get() + first);
+                        m_is_saved[block] = true;
+                    }
+                }
+
+                template <class Fun>
+                void for_each_block(Fun &&fun) const {
+                    for (size_t block = 0; block != num_blocks(); ++block) {
+                        std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+                        size_t first = block * block_size;
+                        T const *src = m_is_saved[block] ? m_saved.get() : m_live;
+                        fun(first, src + first, std::min(block_size, m_length - first));
+                    }
+                }
+
+                T get(size_t index) const {
+                    std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+                    return m_is_saved[index / block_size] ? m_saved[index] : m_live[index];
+                }
+            };
+
+            /**
+             *  The snapshots of a single data store. The data store notifies them before modifying its host buffer.
+             */
+            template <class T>
+            class snapshot_list {
+                std::mutex m_mutex;
+                std::vector<std::weak_ptr<state<T>>> m_states;
+                // lets the writes skip the lock if no snapshot was taken
+                std::atomic<bool> m_has_states{false};
+
+                template <class Fun>
+                void for_each_state(Fun &&fun) {
+                    if (!m_has_states.load(std::memory_order_acquire))
+                        return;
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_states.erase(std::remove_if(m_states.begin(),
+                                       m_states.end(),
+                                       [](auto const &state) { return state.expired(); }),
+                        m_states.end());
+                    if (m_states.empty())
+                        m_has_states.store(false, std::memory_order_relaxed);
+                    for (auto &&weak : m_states)
+                        if (auto state = weak.lock())
+                            fun(*state);
+                }
+
+              public:
+                std::shared_ptr<state<T>> add(T const *live, size_t length) {
+                    auto res = std::make_shared<state<T>>(live, length);
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_states.push_back(res);
+                    m_has_states.store(true, std::memory_order_release);
+                    return res;
+                }
+
+                void before_write() {
+                    for_each_state([](auto &state) { state.save(0, state.length()); });
+                }
+
+                template <class Info, size_t N = Info::ndims>
+                void before_write(Info const &info, array<int, N> const &lower, array<int, N> const &upper) {
+                    for_each_state([&](auto &state) {
+                        dirty_ranges ranges;
+                        ranges.add(info, lower, upper);
+                        for (auto &&range : ranges)
+                            state.save(range.first, range.second);
+                    });
+                }
+            };
+        } // namespace snapshot_impl_
+
+        /**
+         *  The read only view of the snapshot. Keeps the data store alive.
+         */
+        template <class DataStore>
+        class snapshot_view {
+            using data_t = std::remove_const_t<typename DataStore::data_t>;
+
+            std::shared_ptr<DataStore> m_ds;
+            std::shared_ptr<snapshot_impl_::state<data_t>> m_state;
+
+          public:
+            snapshot_view(std::shared_ptr<DataStore> ds) : m_ds(std::move(ds)), m_state(m_ds->add_snapshot()) {}
+
+            auto const &info() const { return m_ds->info(); }
+            decltype(auto) lengths() const { return m_ds->lengths(); }
+            decltype(auto) strides() const { return m_ds->strides(); }
+            decltype(auto) length() const { return m_ds->length(); }
+
+            /**
+             *  Calls `fun(offset, ptr, size)` for the consecutive blocks of the buffer: `ptr` points to the `size`
+             *  elements of the snapshot starting from the buffer index `offset`. The preferred way to stream the
+             *  snapshot.
+             */
+            template <class Fun>
+            void for_each_block(Fun &&fun) const {
+                m_state->for_each_block(std::forward<Fun>(fun));
+            }
+
+            template <class... Is>
+            data_t operator()(Is... indices) const {
+                return m_state->get(m_ds->info().index(indices...));
+            }
+
+            data_t operator()(array<int, DataStore::ndims> const &indices) const {
+                return m_state->get(m_ds->info().index_from_tuple(indices));
+            }
+        };
+
+        /**
+         *  Takes the copy-on-write snapshot of the host buffer of the data store `ds`.
+         */
+        template <class DataStore>
+        snapshot_view<DataStore> snapshot(std::shared_ptr<DataStore> ds) {
+            return {std::move(ds)};
+        }
+    } // namespace storage
+} // namespace gridtools
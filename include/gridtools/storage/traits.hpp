@@ -35,12 +35,57 @@ namespace gridtools {
             using layout_type =
                 decltype(storage_layout(std::declval<Traits>(), std::integral_constant<size_t, Dims>()));
 
-            template <class Traits, class T, class Lengths>
+            template <class Traits, class = void>
+            struct padding_type {
+                using type = void;
+            };
+
+            template <class Traits>
+            struct padding_type<Traits, void_t<decltype(storage_padding(std::declval<Traits>()))>> {
+                using type = decltype(storage_padding(std::declval<Traits>()));
+            };
+
+            /**
+             *  The optional stride padding policy of the traits, `void` if the traits don't define `storage_padding`.
+             */
+            template <class Traits>
+            using padding = typename padding_type<Traits>::type;
+
+            template <class Traits, class T, class = void>
+            struct compute_type_f {
+                using type = T;
+            };
+
+            template <class Traits, class T>
+            struct compute_type_f<Traits, T, void_t<decltype(storage_compute_type(std::declval<Traits>()))>> {
+                using type = typename decltype(storage_compute_type(std::declval<Traits>()))::type;
+            };
+
+            /**
+             *  The type the stencils compute in for the elements of type `T`, `T` itself if the traits don't define
+             *  `storage_compute_type`.
+             */
+            template <class Traits, class T>
+            using compute_type = typename compute_type_f<Traits, T>::type;
+
+            template <class Traits,
+                class T,
+                class Lengths,
+                std::enable_if_t<std::is_void<padding<Traits>>::value, int> = 0>
             auto make_info(Lengths const &lengths) {
                 return storage::make_info<layout_type<Traits, tuple_util::size<Lengths>::value>>(
                     integral_constant<int, elem_alignment<Traits, T>>(), lengths);
             }
 
+            template <class Traits,
+                class T,
+                class Lengths,
+                std::enable_if_t<!std::is_void<padding<Traits>>::value, int> = 0>
+            auto make_info(Lengths const &lengths) {
+                return storage::make_info<layout_type<Traits, tuple_util::size<Lengths>::value>>(
+                    integral_constant<int, elem_alignment<Traits, T>>(), lengths, padding<Traits>(), sizeof(T));
+            }
+
             template <class Traits,
                 class T,
                 class Lengths,
@@ -57,13 +102,14 @@ namespace gridtools {
                         Id,
                         meta::if_c<(Layout::unmasked_length > 1),
                             integral_constant<int, elem_alignment<Traits, T>>,
-                            void>>>>;
+                            void>,
+                        padding<Traits>>>>;
 
             template <class Traits,
                 class T,
                 class Lengths,
                 size_t Alignment = elem_alignment<Traits, T>,
-                std::enable_if_t<Alignment == 1, int> = 0>
+                std::enable_if_t<Alignment == 1 && std::is_void<padding<Traits>>::value, int> = 0>
             std::false_type has_holes(Lengths const &lengths) {
                 return {};
             }
@@ -74,11 +120,24 @@ namespace gridtools {
                 size_t Alignment = elem_alignment<Traits, T>,
                 size_t Dims = tuple_util::size<Lengths>::value,
                 class Layout = layout_type<Traits, Dims>,
-                std::enable_if_t<Alignment != 1, int> = 0>
+                std::enable_if_t<Alignment != 1 && std::is_void<padding<Traits>>::value, int> = 0>
             bool has_holes(Lengths const &lengths) {
                 return tuple_util::get<Layout::find(Dims - 1)>(lengths) % Alignment;
             }
 
+            // the padded storage has holes if any of the lengths was padded
+            template <class Traits,
+                class T,
+                class Lengths,
+                std::enable_if_t<!std::is_void<padding<Traits>>::value, int> = 0>
+            bool has_holes(Lengths const &lengths) {
+                auto info = make_info<Traits, T>(lengths);
+                size_t size = 1;
+                for (auto length : info.lengths())
+                    size *= length;
+                return size != (size_t)info.length();
+            }
+
             template <class Traits, class T>
             auto allocate(size_t size) {
                 return storage_allocate(Traits(), meta::lazy::id<T>(), size);
@@ -92,6 +151,28 @@ namespace gridtools {
                 storage_update_target(Traits(), dst, src, size);
             }
 
+            template <class Traits, class T>
+            auto update_target_strided(T *dst, T const *src, size_t width, size_t count, size_t pitch, int)
+                -> decltype(storage_update_target_strided(Traits(), dst, src, width, count, pitch)) {
+                return storage_update_target_strided(Traits(), dst, src, width, count, pitch);
+            }
+
+            template <class Traits, class T>
+            void update_target_strided(T *dst, T const *src, size_t width, size_t count, size_t pitch, long) {
+                for (size_t i = 0; i != count; ++i)
+                    storage_update_target(Traits(), dst + i * pitch, src + i * pitch, width);
+            }
+
+            /**
+             *  Copies `count` ranges of `width` elements that start `pitch` elements apart to the target. Uses the
+             *  optional `storage_update_target_strided` of the traits, otherwise copies range by range.
+             */
+            template <class Traits, class T>
+            std::enable_if_t<!is_host_referenceable<Traits>> update_target_strided(
+                T *dst, T const *src, size_t width, size_t count, size_t pitch) {
+                update_target_strided<Traits>(dst, src, width, count, pitch, 0);
+            }
+
             template <class Traits, class T>
             std::enable_if_t<!is_host_referenceable<Traits>> update_host(T *dst, T const *src, size_t size) {
                 storage_update_host(Traits(), dst, src, size);
@@ -25,8 +25,23 @@
  *     thread_pool_parallel_for_loop(pool, func, lim0, lim1, lim2);
  *     etc.
  *   They are optional and could be provided for performance reasons.
+ *
+ *   The range based variation of the loop is also available:
+ *     parallel_for_range(pool, func, grain, lim0, lim1, ...);
+ *   Here `func` is invoked as `func(begin0, end0, i1, ...)`: it gets the contiguous subrange `[begin0, end0)` of the
+ *   inner most dimension which length doesn't exceed `grain` and the indices of the rest of the dimensions.
+ *   The thread pool can implement it natively by providing
+ *     thread_pool_parallel_for_range(pool, func, grain, lim0, lim1, ...);
+ *   Otherwise it is expressed via `thread_pool_parallel_for_loop` over the chunks.
+ *
+ *   The named parts of the computation (like the stages of a stencil) are run as:
+ *     scope(pool, name, func);
+ *   where `name` is a `char const *(*)()` that returns a string with static storage duration. By default it is just
+ *   `func()`; the pool can observe the scopes by providing
+ *     thread_pool_scope(pool, name, func);
  */
 
+#include <algorithm>
 #include <tuple>
 
 #include "../common/stride_util.hpp"
@@ -62,10 +77,41 @@ namespace gridtools {
                 -> decltype(thread_pool_parallel_for_loop(obj, f, limits...)) {
                 return thread_pool_parallel_for_loop(obj, f, limits...);
             }
+
+            template <class T, class F, class Grain, class Dim, class... Dims>
+            void thread_pool_parallel_for_range(T const &obj, F const &f, Grain grain, Dim limit, Dims... limits) {
+                Dim chunks = (limit + grain - 1) / grain;
+                parallel_for_loop(
+                    obj,
+                    [&](auto chunk, auto... indices) {
+                        Dim begin = chunk * grain;
+                        f(begin, std::min<Dim>(begin + grain, limit), indices...);
+                    },
+                    chunks,
+                    limits...);
+            }
+
+            template <class T, class F, class Grain, class... Dims>
+            void parallel_for_range(T const &obj, F const &f, Grain grain, Dims... limits) {
+                static_assert(sizeof...(Dims) > 0, "at least one dimension expected");
+                thread_pool_parallel_for_range(obj, f, grain > 0 ? grain : 1, limits...);
+            }
+
+            template <class T, class Name, class F>
+            void thread_pool_scope(T const &, Name, F const &f) {
+                f();
+            }
+
+            template <class T, class F>
+            void scope(T const &obj, char const *(*name)(), F const &f) {
+                thread_pool_scope(obj, name, f);
+            }
         } // namespace concept_impl_
 
         using concept_impl_::get_max_threads;
         using concept_impl_::get_thread_num;
         using concept_impl_::parallel_for_loop;
+        using concept_impl_::parallel_for_range;
+        using concept_impl_::scope;
     } // namespace thread_pool
 } // namespace gridtools
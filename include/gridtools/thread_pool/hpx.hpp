@@ -10,6 +10,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <type_traits>
+
+#include <hpx/include/parallel_executor_parameters.hpp>
 #include <hpx/include/parallel_for_loop.hpp>
 #include <hpx/include/runtime.hpp>
 
@@ -24,6 +28,41 @@ namespace gridtools {
             friend void thread_pool_parallel_for_loop(hpx, F const &f, I lim) {
                 ::hpx::parallel::for_loop(::hpx::parallel::execution::par, 0, lim, f);
             }
+
+            static auto chunked() {
+                return ::hpx::parallel::execution::par.with(::hpx::parallel::execution::static_chunk_size(1));
+            }
+
+            // each iteration of the HPX loop processes a whole chunk, so the HPX chunking is disabled
+            template <class F, class G, class I>
+            friend void thread_pool_parallel_for_range(hpx, F const &f, G grain, I lim) {
+                I chunks = (lim + grain - 1) / grain;
+                ::hpx::parallel::for_loop(
+                    chunked(), I(0), chunks, [&](I c) { f(c * grain, std::min<I>(c * grain + grain, lim)); });
+            }
+
+            // the chunks of the inner most dimension and the outer indices are enumerated by a single HPX loop,
+            // the index is split once per chunk
+            template <class F, class G, class I, class J>
+            friend void thread_pool_parallel_for_range(hpx, F const &f, G grain, I i_lim, J j_lim) {
+                using index_t = std::common_type_t<I, J>;
+                index_t i_chunks = (i_lim + grain - 1) / grain;
+                ::hpx::parallel::for_loop(chunked(), index_t(0), i_chunks * j_lim, [&](index_t c) {
+                    I i = I(c % i_chunks * grain);
+                    f(i, std::min<I>(i + grain, i_lim), J(c / i_chunks));
+                });
+            }
+
+            template <class F, class G, class I, class J, class K>
+            friend void thread_pool_parallel_for_range(hpx, F const &f, G grain, I i_lim, J j_lim, K k_lim) {
+                using index_t = std::common_type_t<I, J, K>;
+                index_t i_chunks = (i_lim + grain - 1) / grain;
+                ::hpx::parallel::for_loop(chunked(), index_t(0), i_chunks * j_lim * k_lim, [&](index_t c) {
+                    I i = I(c % i_chunks * grain);
+                    index_t jk = c / i_chunks;
+                    f(i, std::min<I>(i + grain, i_lim), J(jk % j_lim), K(jk / j_lim));
+                });
+            }
         };
     } // namespace thread_pool
 } // namespace gridtools
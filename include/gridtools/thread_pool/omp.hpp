@@ -10,39 +10,95 @@
 
 #pragma once
 
+#include <algorithm>
+
 #if defined(_OPENMP) || defined(GT_HIP_OPENMP_WORKAROUND)
 #include <omp.h>
 #endif
 
+#include "partition.hpp"
+
 namespace gridtools {
     namespace thread_pool {
         struct omp {
 #if defined(_OPENMP) || defined(GT_HIP_OPENMP_WORKAROUND)
+          private:
+            // the worksharing loop of `body` is orphaned: it binds to the region started here
+            template <class Body>
+            static void parallel_region(Body const &body) {
+                auto cores = partition_impl_::current_cores();
+#pragma omp parallel
+                {
+                    partition_impl_::pin_thread(cores);
+                    body();
+                }
+            }
+
+          public:
             friend auto thread_pool_get_thread_num(omp) { return omp_get_thread_num(); }
             friend auto thread_pool_get_max_threads(omp) { return omp_get_max_threads(); }
 
             template <class F, class I>
             friend void thread_pool_parallel_for_loop(omp, F const &f, I lim) {
-#pragma omp parallel for
-                for (I i = 0; i < lim; ++i)
-                    f(i);
+                parallel_region([&] {
+#pragma omp for
+                    for (I i = 0; i < lim; ++i)
+                        f(i);
+                });
             }
 
             template <class F, class I, class J>
             friend void thread_pool_parallel_for_loop(omp, F const &f, I i_lim, J j_lim) {
-#pragma omp parallel for collapse(2)
-                for (J j = 0; j < j_lim; ++j)
-                    for (I i = 0; i < i_lim; ++i)
-                        f(i, j);
+                parallel_region([&] {
+#pragma omp for collapse(2)
+                    for (J j = 0; j < j_lim; ++j)
+                        for (I i = 0; i < i_lim; ++i)
+                            f(i, j);
+                });
             }
 
             template <class F, class I, class J, class K>
             friend void thread_pool_parallel_for_loop(omp, F const &f, I i_lim, J j_lim, K k_lim) {
-#pragma omp parallel for collapse(3)
-                for (K k = 0; k < k_lim; ++k)
+                parallel_region([&] {
+#pragma omp for collapse(3)
+                    for (K k = 0; k < k_lim; ++k)
+                        for (J j = 0; j < j_lim; ++j)
+                            for (I i = 0; i < i_lim; ++i)
+                                f(i, j, k);
+                });
+            }
+
+            template <class F, class G, class I>
+            friend void thread_pool_parallel_for_range(omp, F const &f, G grain, I i_lim) {
+                I i_chunks = (i_lim + grain - 1) / grain;
+                parallel_region([&] {
+#pragma omp for
+                    for (I c = 0; c < i_chunks; ++c)
+                        f(c * grain, std::min<I>(c * grain + grain, i_lim));
+                });
+            }
+
+            template <class F, class G, class I, class J>
+            friend void thread_pool_parallel_for_range(omp, F const &f, G grain, I i_lim, J j_lim) {
+                I i_chunks = (i_lim + grain - 1) / grain;
+                parallel_region([&] {
+#pragma omp for collapse(2)
                     for (J j = 0; j < j_lim; ++j)
-                        for (I i = 0; i < i_lim; ++i)
-                            f(i, j, k);
+                        for (I c = 0; c < i_chunks; ++c)
+                            f(c * grain, std::min<I>(c * grain + grain, i_lim), j);
+                });
+            }
+
+            template <class F, class G, class I, class J, class K>
+            friend void thread_pool_parallel_for_range(omp, F const &f, G grain, I i_lim, J j_lim, K k_lim) {
+                I i_chunks = (i_lim + grain - 1) / grain;
+                parallel_region([&] {
+#pragma omp for collapse(3)
+                    for (K k = 0; k < k_lim; ++k)
+                        for (J j = 0; j < j_lim; ++j)
+                            for (I c = 0; c < i_chunks; ++c)
+                                f(c * grain, std::min<I>(c * grain + grain, i_lim), j, k);
+                });
             }
 #endif
         };
@@ -0,0 +1,172 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+/*
+ * Partitioning of the thread pool between the host threads.
+ *
+ * By default every host thread that runs a computation gets the full width team. If several host threads run
+ * computations concurrently, the machine gets oversubscribed and the temporaries (that are sized by
+ * `get_max_threads`) are allocated for the full width by each of them.
+ *
+ * `scoped_partition` restricts the computations launched from the calling host thread to the given partition until
+ * the end of the scope:
+ *
+ *   // host thread A                                  // host thread B
+ *   scoped_partition p(partition::cores(0, 8));       scoped_partition p(partition::cores(8, 8));
+ *   run(dynamics, backend, grid, ...);                run(physics, backend, grid, ...);
+ *
+ * Within the scope `thread_pool_get_max_threads` reports the width of the partition, so the temporaries are sized
+ * for it. If the partition lists the cores, the threads of the team are pinned to them (on Linux only), otherwise
+ * only the width is restricted. A `plan` should be executed within the same partition it was created in.
+ *
+ * Partitions are implemented for `thread_pool::omp` only: the width is the `nthreads-var` of the calling thread which
+ * OpenMP keeps per host thread. The pinning is checked at the start of every parallel region of the omp pool against
+ * the core cached per OS thread, so it doesn't rely on OpenMP reusing the same OS threads for the teams, but the
+ * affinity syscall is done only when the thread moves to another core. The threads stay pinned between the regions;
+ * the region started without partition restores the previous affinity of its threads and the host thread is
+ * restored at the end of the `scoped_partition`.
+ * The other thread pools (`thread_pool::hpx`, the user defined ones) ignore the partitions: the computations run on
+ * the full pool within a `scoped_partition`.
+ */
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(_OPENMP) && defined(__linux__)
+#include <sched.h>
+#define GT_THREAD_POOL_AFFINITY
+#endif
+
+namespace gridtools {
+    namespace thread_pool {
+        namespace partition_impl_ {
+            class partition {
+                int m_threads;
+                std::vector<int> m_cores;
+
+              public:
+                /**
+                 *  `threads` wide partition, the threads are not pinned.
+                 */
+                explicit partition(int threads) : m_threads(threads) { assert(threads > 0); }
+
+                /**
+                 *  The partition with one thread per listed core.
+                 */
+                explicit partition(std::vector<int> cores) : m_threads((int)cores.size()), m_cores(std::move(cores)) {
+                    assert(m_threads > 0);
+                }
+
+                /**
+                 *  The partition of the `count` consecutive cores starting from `first`.
+                 */
+                static partition cores(int first, int count) {
+                    std::vector<int> res(count);
+                    for (int i = 0; i != count; ++i)
+                        res[i] = first + i;
+                    return partition(std::move(res));
+                }
+
+                int threads() const { return m_threads; }
+                std::vector<int> const &cores() const { return m_cores; }
+            };
+
+            // the cores of the partition of the calling host thread, `nullptr` if its threads are not pinned
+            inline std::vector<int> const *&current_cores() {
+                static thread_local std::vector<int> const *res = nullptr;
+                return res;
+            }
+
+#ifdef GT_THREAD_POOL_AFFINITY
+            struct thread_affinity {
+                int core = -1;       // the core the thread is pinned to, `-1` if it is not pinned by us
+                cpu_set_t prev_mask; // the affinity of the thread before it was pinned
+            };
+
+            inline thread_affinity &current_affinity() {
+                static thread_local thread_affinity res;
+                return res;
+            }
+#endif
+
+            /**
+             *  Pins the calling thread of the team to its core of the partition. `cores` are the `current_cores()` of
+             *  the host thread that started the team, if they are `nullptr` the affinity of the thread from before the
+             *  pinning is restored. The applied core is cached per OS thread, so the affinity is set only if the
+             *  thread changes the core and the team of the same partition is pinned once.
+             */
+            inline void pin_thread(std::vector<int> const *cores) {
+#ifdef GT_THREAD_POOL_AFFINITY
+                auto &affinity = current_affinity();
+                if (!cores) {
+                    if (affinity.core != -1 && sched_setaffinity(0, sizeof(cpu_set_t), &affinity.prev_mask) == 0)
+                        affinity.core = -1;
+                    return;
+                }
+                int core = (*cores)[omp_get_thread_num() % cores->size()];
+                if (affinity.core == core)
+                    return;
+                if (affinity.core == -1 && sched_getaffinity(0, sizeof(cpu_set_t), &affinity.prev_mask))
+                    return;
+                cpu_set_t mask;
+                CPU_ZERO(&mask);
+                CPU_SET(core, &mask);
+                if (sched_setaffinity(0, sizeof(cpu_set_t), &mask) == 0)
+                    affinity.core = core;
+#else
+                (void)cores;
+#endif
+            }
+
+            /**
+             *  Binds the computations launched from the calling host thread to the partition till the end of the
+             *  scope. Should be created and destroyed outside of the parallel regions.
+             */
+            class scoped_partition {
+                std::vector<int> m_cores;
+                std::vector<int> const *m_prev_cores;
+#if defined(_OPENMP)
+                int m_prev_threads;
+#endif
+
+              public:
+                explicit scoped_partition(partition const &p) : m_cores(p.cores()), m_prev_cores(current_cores()) {
+#if defined(_OPENMP)
+                    m_prev_threads = omp_get_max_threads();
+                    omp_set_num_threads(p.threads());
+#endif
+                    current_cores() = m_cores.empty() ? nullptr : &m_cores;
+                }
+
+                scoped_partition(scoped_partition const &) = delete;
+                scoped_partition &operator=(scoped_partition const &) = delete;
+
+                ~scoped_partition() {
+                    current_cores() = m_prev_cores;
+                    // the host thread takes part in the teams: it should not stay pinned out of the scope
+                    pin_thread(nullptr);
+#if defined(_OPENMP)
+                    omp_set_num_threads(m_prev_threads);
+#endif
+                }
+            };
+        } // namespace partition_impl_
+        using partition_impl_::partition;
+        using partition_impl_::scoped_partition;
+    } // namespace thread_pool
+} // namespace gridtools
+
+#undef GT_THREAD_POOL_AFFINITY
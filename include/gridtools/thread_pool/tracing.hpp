@@ -0,0 +1,240 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+/*
+ * Tracing decorator for the thread pools.
+ *
+ * `tracing<ThreadPool>` models the thread pool concept by forwarding to `ThreadPool` and records the timeline of the
+ * execution:
+ *   - one `parallel_for_loop` event per loop on the calling thread. The gaps between these events are the serial
+ *     parts of the computation;
+ *   - one `block` event per invocation of the loop body on the executing thread. The indices of the invocation are
+ *     recorded as the event arguments;
+ *   - the same for `parallel_for_range`: one `parallel_for_range` event per loop and one `block` event per chunk
+ *     with the `begin` and `end` of the chunk followed by the outer indices as the arguments;
+ *   - one event per `scope` named after the scope. The CPU backends run each stage of a block in the scope named
+ *     after the stage functors, so the `block` events are split into the stages.
+ *
+ * The events of each OS thread go to a separate timeline (`tid` is the registration order of the thread), so the
+ * loops launched concurrently from several host threads don't mix. The thread number within the pool is recorded
+ * as the `worker` argument.
+ *
+ * The events are stored in the thread local ring buffers of `Capacity` events, the oldest events are overwritten.
+ * The timeline is written in Chrome trace event format that can be loaded into `chrome://tracing` or Perfetto:
+ *
+ *   using backend_t = stencil::cpu_ifirst<thread_pool::tracing<thread_pool::omp>>;
+ *   ...
+ *   std::ofstream file("trace.json");
+ *   thread_pool::tracing<thread_pool::omp>::dump(file);
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#include "concept.hpp"
+
+namespace gridtools {
+    namespace thread_pool {
+        namespace tracing_impl_ {
+            struct event {
+                static constexpr size_t max_args = 4;
+
+                char const *name;
+                std::int64_t start;
+                std::int64_t end;
+                int thread;
+                int args_count;
+                std::array<long long, max_args> args;
+            };
+
+            class ring_buffer {
+                std::vector<event> m_events;
+                size_t m_pos = 0;
+                bool m_wrapped = false;
+                int m_id;
+
+              public:
+                ring_buffer(size_t capacity, int id) : m_events(capacity), m_id(id) {}
+
+                // the id of the OS thread that owns the buffer
+                int id() const { return m_id; }
+
+                void push(event const &e) {
+                    if (m_events.empty())
+                        return;
+                    m_events[m_pos] = e;
+                    if (++m_pos == m_events.size()) {
+                        m_pos = 0;
+                        m_wrapped = true;
+                    }
+                }
+
+                void clear() {
+                    m_pos = 0;
+                    m_wrapped = false;
+                }
+
+                // visits the events from the oldest to the newest
+                template <class F>
+                void for_each(F &&f) const {
+                    if (m_wrapped)
+                        for (size_t i = m_pos; i != m_events.size(); ++i)
+                            f(m_events[i]);
+                    for (size_t i = 0; i != m_pos; ++i)
+                        f(m_events[i]);
+                }
+            };
+
+            class registry {
+                using clock_t = std::chrono::steady_clock;
+
+                size_t m_capacity;
+                clock_t::time_point m_epoch = clock_t::now();
+                std::mutex m_mutex;
+                std::vector<std::unique_ptr<ring_buffer>> m_buffers;
+
+              public:
+                explicit registry(size_t capacity) : m_capacity(capacity) {}
+
+                std::int64_t now() const {
+                    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - m_epoch).count();
+                }
+
+                ring_buffer &add_buffer() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_buffers.emplace_back(new ring_buffer(m_capacity, int(m_buffers.size())));
+                    return *m_buffers.back();
+                }
+
+                // should not be called concurrently with the traced loops
+                void clear() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (auto &&buffer : m_buffers)
+                        buffer->clear();
+                }
+
+                // should not be called concurrently with the traced loops
+                void dump(std::ostream &strm) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto flags = strm.flags();
+                    strm << std::fixed;
+                    strm.precision(3);
+                    strm << "{\"traceEvents\":[";
+                    bool first = true;
+                    for (auto &&buffer : m_buffers)
+                        buffer->for_each([&](event const &e) {
+                            if (!first)
+                                strm << ",";
+                            first = false;
+                            strm << "\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->id()
+                                 << ",\"ts\":" << e.start * 1e-3 << ",\"dur\":" << (e.end - e.start) * 1e-3
+                                 << ",\"args\":{";
+                            for (int i = 0; i != e.args_count; ++i)
+                                strm << "\"" << i << "\":" << e.args[i] << ",";
+                            strm << "\"worker\":" << e.thread << "}}";
+                        });
+                    strm << "\n],\"displayTimeUnit\":\"ns\"}\n";
+                    strm.flags(flags);
+                }
+            };
+
+            template <class... Ts, std::enable_if_t<sizeof...(Ts) <= event::max_args, int> = 0>
+            event make_event(char const *name, std::int64_t start, std::int64_t end, int thread, Ts... args) {
+                return {name, start, end, thread, sizeof...(Ts), {{(long long)args...}}};
+            }
+
+            // the arguments are dropped if there are too many of them
+            template <class... Ts, std::enable_if_t<(sizeof...(Ts) > event::max_args), int> = 0>
+            event make_event(char const *name, std::int64_t start, std::int64_t end, int thread, Ts...) {
+                return {name, start, end, thread, 0, {}};
+            }
+
+            template <class ThreadPool, size_t Capacity = 1 << 16>
+            struct tracing {
+                static registry &get_registry() {
+                    static registry res(Capacity);
+                    return res;
+                }
+
+                static ring_buffer &local_buffer() {
+                    static thread_local ring_buffer &res = get_registry().add_buffer();
+                    return res;
+                }
+
+                static void record(event const &e) { local_buffer().push(e); }
+
+                /**
+                 *  Writes the recorded events in Chrome trace event format.
+                 */
+                static void dump(std::ostream &strm) { get_registry().dump(strm); }
+
+                /**
+                 *  Discards the recorded events.
+                 */
+                static void clear() { get_registry().clear(); }
+
+                friend auto thread_pool_get_thread_num(tracing) { return get_thread_num(ThreadPool()); }
+                friend auto thread_pool_get_max_threads(tracing) { return get_max_threads(ThreadPool()); }
+
+                template <class F, class... Dims>
+                friend void thread_pool_parallel_for_loop(tracing, F const &f, Dims... limits) {
+                    auto &reg = get_registry();
+                    auto start = reg.now();
+                    parallel_for_loop(
+                        ThreadPool(),
+                        [&](auto... indices) {
+                            auto block_start = reg.now();
+                            f(indices...);
+                            record(make_event(
+                                "block", block_start, reg.now(), get_thread_num(ThreadPool()), indices...));
+                        },
+                        limits...);
+                    record(make_event("parallel_for_loop", start, reg.now(), get_thread_num(ThreadPool()), limits...));
+                }
+
+                template <class F, class Grain, class Dim, class... Dims>
+                friend void thread_pool_parallel_for_range(
+                    tracing, F const &f, Grain grain, Dim limit, Dims... limits) {
+                    auto &reg = get_registry();
+                    auto start = reg.now();
+                    parallel_for_range(
+                        ThreadPool(),
+                        [&](auto begin, auto end, auto... indices) {
+                            auto block_start = reg.now();
+                            f(begin, end, indices...);
+                            record(make_event(
+                                "block", block_start, reg.now(), get_thread_num(ThreadPool()), begin, end, indices...));
+                        },
+                        grain,
+                        limit,
+                        limits...);
+                    record(make_event(
+                        "parallel_for_range", start, reg.now(), get_thread_num(ThreadPool()), limit, limits...));
+                }
+
+                template <class F>
+                friend void thread_pool_scope(tracing, char const *(*name)(), F const &f) {
+                    auto &reg = get_registry();
+                    auto start = reg.now();
+                    scope(ThreadPool(), name, f);
+                    record(make_event(name(), start, reg.now(), get_thread_num(ThreadPool())));
+                }
+            };
+        } // namespace tracing_impl_
+        using tracing_impl_::tracing;
+    } // namespace thread_pool
+} // namespace gridtools
@@ -105,22 +105,71 @@ if buildinfo:
               default=100,
               type=int,
               help='number of runs to do for each stencil')
+    @args.arg('--warmup',
+              default=1,
+              type=int,
+              help='number of untimed runs before the measurement')
+    @args.arg('--no-flush',
+              action='store_true',
+              help='do not flush caches between the runs')
     @args.arg('--output',
               '-o',
               required=True,
               help='output file path, extension .json is added if not given')
-    def run(domain_size, runs, output):
+    def run(domain_size, runs, warmup, no_flush, output):
 
         import perftest
         if not output.lower().endswith('.json'):
             output += '.json'
 
-        data = perftest.run(domain_size, runs)
+        data = perftest.run(domain_size, runs, warmup, not no_flush)
         with open(output, 'w') as outfile:
             json.dump(data, outfile, indent='  ')
             log.info(f'Successfully saved perftests output to {output}')
 
 
+if buildinfo:
+
+    @perftest.command(description='run performance tests over a range of '
+                      'horizontal domain sizes')
+    @args.arg('--sizes',
+              '-s',
+              type=int,
+              nargs='+',
+              default=[120, 124, 128, 132, 136, 248, 252, 256, 260, 264],
+              help='horizontal domain sizes (excluding halo)')
+    @args.arg('--k-size', default=80, type=int, help='vertical domain size')
+    @args.arg('--runs',
+              default=20,
+              type=int,
+              help='number of runs to do for each stencil and size')
+    @args.arg('--warmup',
+              default=1,
+              type=int,
+              help='number of untimed runs before the measurement')
+    @args.arg('--no-flush',
+              action='store_true',
+              help='do not flush caches between the runs')
+    @args.arg('--no-padding',
+              action='store_true',
+              help='disable the stride padding (GT_STRIDE_PADDING=disable)')
+    @args.arg('--output',
+              '-o',
+              required=True,
+              help='output file path, extension .json is added if not given')
+    def sweep(sizes, k_size, runs, warmup, no_flush, no_padding, output):
+
+        import perftest
+        if not output.lower().endswith('.json'):
+            output += '.json'
+
+        data = perftest.sweep(sizes, k_size, runs, warmup, not no_flush,
+                              not no_padding)
+        with open(output, 'w') as outfile:
+            json.dump(data, outfile, indent='  ')
+            log.info(f'Successfully saved perftests sweep to {output}')
+
+
 @perftest.command(description='plot performance results')
 def plot():
     pass
@@ -131,6 +180,19 @@ def _load_json(filename):
         return json.load(file)
 
 
+@plot.command(description='plot time per grid point over domain sizes')
+@args.arg('--output', '-o', required=True, help='output directory')
+@args.arg('--input',
+          '-i',
+          required=True,
+          nargs='+',
+          help='sweep files (e.g. with and without padding)')
+def sweep(output, input):
+    from perftest import plot
+
+    plot.sweep([_load_json(i) for i in input], output)
+
+
 @plot.command(description='plot performance comparison')
 @args.arg('--output', '-o', required=True, help='output directory')
 @args.arg('--input', '-i', required=True, nargs=2, help='two input files')
@@ -27,25 +27,64 @@ def _now():
     return datetime.now(timezone.utc).astimezone().isoformat()
 
 
-def run(domain, runs):
+def run(domain, runs, warmup=1, flush=True, padding=True):
     from pyutils import buildinfo
 
+    # the test storages are padded only on request, see test_environment.hpp
+    if padding:
+        env.env['GT_TEST_STORAGE_PADDING'] = 'enable'
+        env.env.pop('GT_STRIDE_PADDING', None)
+    else:
+        env.env.pop('GT_TEST_STORAGE_PADDING', None)
+        env.env['GT_STRIDE_PADDING'] = 'disable'
+
     binary = os.path.join(buildinfo.binary_dir, 'tests', 'regression',
                           'perftests')
 
-    output = runtools.srun([binary] + [str(d)
-                                       for d in domain] + [str(runs), '-d'])
+    options = ['-d', f'--warmup={warmup}']
+    if not flush:
+        options.append('--no-flush')
+    output = runtools.srun([binary] + [str(d) for d in domain] + [str(runs)] +
+                           options)
     data = json.loads(output)
 
     data['gridtools'] = {'commit': _git_commit(), 'datetime': _git_datetime()}
+    machine = data.pop('machine', {})
     data['environment'] = {
         'hostname': env.hostname(),
         'clustername': env.clustername(),
         'compiler': buildinfo.compiler,
         'datetime': _now(),
-        'envfile': buildinfo.envfile
+        'envfile': buildinfo.envfile,
+        'threads': machine.get('threads'),
+        'affinity': machine.get('affinity'),
+        'cpu_mhz': machine.get('cpu_mhz'),
+        'warmup': machine.get('warmup'),
+        'flush_cache': machine.get('flush_cache'),
+        'stream_copy_gb_per_s': machine.get('stream_copy_gb_per_s'),
+        'stream_triad_gb_per_s': machine.get('stream_triad_gb_per_s')
     }
     data['domain'] = list(domain)
+    data['padding'] = padding
     log.debug('Perftests data', pprint.pformat(data))
 
     return data
+
+
+def sweep(sizes, k_size, runs, warmup=1, flush=True, padding=True):
+    """Runs the perftests for the square horizontal domains of the given
+    sizes to expose the performance cliffs at the (power-of-two) sizes that
+    cause cache set aliasing."""
+    results = [
+        run([size, size, k_size], runs, warmup, flush, padding)
+        for size in sizes
+    ]
+    data = {
+        k: v
+        for k, v in results[0].items() if k not in ('outputs', 'domain')
+    }
+    data['sweep'] = [{
+        'domain': r['domain'],
+        'outputs': r['outputs']
+    } for r in results]
+    return data
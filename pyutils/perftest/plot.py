@@ -30,8 +30,7 @@ class _OutputKey(typing.NamedTuple):
     @classmethod
     def outputs_by_key(cls, data):
         def split_output(o):
-            return cls(**{k: v
-                          for k, v in o.items() if k != 'series'}), o['series']
+            return cls(**{k: o[k] for k in cls._fields}), o['series']
 
         return dict(split_output(o) for o in data['outputs'])
 
@@ -393,3 +392,46 @@ def compare_backends(data, output):
         _add_backend_comparison_plots(report, data)
         _add_info(report, [f'Configuration {i + 1}' for i in range(len(data))],
                   data)
+
+
+def _sweep_plot(title, series, output):
+    fig, ax = plt.subplots(figsize=(10, 5))
+    for label, (sizes, times) in series.items():
+        ax.plot(sizes, times, 'o-', label=label)
+    ax.set_title(title)
+    ax.set_xlabel('Horizontal Size')
+    ax.set_ylabel('Time per Grid Point [ns]')
+    ax.set_ylim(bottom=0)
+    ax.legend(loc='upper left')
+    fig.tight_layout()
+    fig.savefig(output, dpi=300)
+    log.debug(f'Successfully written sweep plot to {output}')
+    plt.close(fig)
+
+
+def sweep(data, output):
+    def label(d):
+        return 'padded' if d.get('padding', True) else 'unpadded'
+
+    keys = {
+        k
+        for d in data for s in d['sweep']
+        for k in _OutputKey.outputs_by_key(s)
+    }
+    title = 'GridTools Performance over Domain Sizes'
+    with html.Report(output, title) as report:
+        with report.image_grid() as grid:
+            for key in sorted(keys, key=str):
+                series = dict()
+                for d in data:
+                    sizes, times = [], []
+                    for s in d['sweep']:
+                        outputs = _OutputKey.outputs_by_key(s)
+                        if key in outputs:
+                            points = np.prod(s['domain'])
+                            sizes.append(s['domain'][0])
+                            times.append(
+                                np.median(outputs[key]) / points * 1e9)
+                    series[label(d)] = (sizes, times)
+                _sweep_plot(str(key), series, grid.image())
+        _add_info(report, [label(d) for d in data], data)
@@ -135,33 +135,36 @@ namespace gridtools {
         inline char const *backend_name(naive const &) { return "naive"; }
 
         namespace cpu_kfirst_backend {
-            template <class, class, class>
+            template <class, class, class, class>
             struct cpu_kfirst;
 
-            template <class I, class J, class T>
-            storage::cpu_kfirst backend_storage_traits(cpu_kfirst<I, J, T>);
+            template <class I, class J, class T, class P>
+            storage::cpu_kfirst backend_storage_traits(cpu_kfirst<I, J, T, P>);
+
+            template <class I, class J, class T, class P>
+            timer_omp backend_timer_impl(cpu_kfirst<I, J, T, P>);
 
-            template <class I, class J, class T>
-            timer_omp backend_timer_impl(cpu_kfirst<I, J, T>);
+            template <class I, class J, class T, class P>
+            T backend_thread_pool(cpu_kfirst<I, J, T, P>);
 
-            template <class I, class J, class T>
-            char const *backend_name(cpu_kfirst<I, J, T> const &) {
+            template <class I, class J, class T, class P>
+            char const *backend_name(cpu_kfirst<I, J, T, P> const &) {
                 return "cpu_kfirst";
             }
 
 #if defined(GT_STENCIL_CPU_KFIRST_HPX)
-            template <class I, class J>
-            char const *backend_name(cpu_kfirst<I, J, thread_pool::hpx> const &) {
+            template <class I, class J, class P>
+            char const *backend_name(cpu_kfirst<I, J, thread_pool::hpx, P> const &) {
                 return "cpu_kfirst_hpx";
             }
 
-            template <class I, class J>
-            void backend_init(cpu_kfirst<I, J, thread_pool::hpx>, int &argc, char **argv) {
+            template <class I, class J, class P>
+            void backend_init(cpu_kfirst<I, J, thread_pool::hpx, P>, int &argc, char **argv) {
                 hpx_start(argc, argv);
             }
 
-            template <class I, class J>
-            void backend_finalize(cpu_kfirst<I, J, thread_pool::hpx>) {
+            template <class I, class J, class P>
+            void backend_finalize(cpu_kfirst<I, J, thread_pool::hpx, P>) {
                 hpx_stop();
             }
 #endif
@@ -180,6 +183,9 @@ namespace gridtools {
             template <class T>
             timer_omp backend_timer_impl(cpu_ifirst<T>);
 
+            template <class T>
+            T backend_thread_pool(cpu_ifirst<T>);
+
             template <class T>
             char const *backend_name(cpu_ifirst<T> const &) {
                 return "cpu_ifirst";
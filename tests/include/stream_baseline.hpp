@@ -0,0 +1,75 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+#include <gridtools/common/hugepage_alloc.hpp>
+#include <gridtools/thread_pool/concept.hpp>
+
+namespace gridtools {
+    namespace test_environment_impl_ {
+        /**
+         *  STREAM-like copy and triad kernels run by the thread pool of the stencil backend on the buffers from
+         *  `hugepage_alloc`, the same as the stencils use. The buffers are first touched by the same pool.
+         *  Returns the best bandwidth in bytes per second over a few repetitions.
+         */
+        template <class ThreadPool>
+        std::pair<double, double> measure_stream_bandwidth(ThreadPool pool) {
+            using clock_t = std::chrono::steady_clock;
+            const std::ptrdiff_t n = std::ptrdiff_t(1) << 23;
+            const std::ptrdiff_t grain = std::ptrdiff_t(1) << 14;
+            const int repetitions = 5;
+            auto alloc = [&] {
+                return static_cast<double *>(hugepage_alloc(n * sizeof(double), default_hugepage_policy(), pool));
+            };
+            double *a = alloc();
+            double *b = alloc();
+            double *c = alloc();
+            thread_pool::parallel_for_range(
+                pool,
+                [=](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                    for (std::ptrdiff_t i = begin; i < end; ++i) {
+                        a[i] = 1;
+                        b[i] = 2;
+                        c[i] = 0;
+                    }
+                },
+                grain,
+                n);
+            auto best = [&](auto &&kernel) {
+                double res = 0;
+                for (int r = 0; r < repetitions; ++r) {
+                    auto start = clock_t::now();
+                    thread_pool::parallel_for_range(pool, kernel, grain, n);
+                    double time = std::chrono::duration<double>(clock_t::now() - start).count();
+                    res = std::max(res, 1 / time);
+                }
+                return res;
+            };
+            double copy = 2 * n * sizeof(double) * best([=](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                for (std::ptrdiff_t i = begin; i < end; ++i)
+                    c[i] = a[i];
+            });
+            const double scalar = 3;
+            double triad = 3 * n * sizeof(double) * best([=](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                for (std::ptrdiff_t i = begin; i < end; ++i)
+                    a[i] = b[i] + scalar * c[i];
+            });
+            hugepage_free(a);
+            hugepage_free(b);
+            hugepage_free(c);
+            return {copy, triad};
+        }
+    } // namespace test_environment_impl_
+} // namespace gridtools
@@ -9,21 +9,28 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 
 #include <gtest/gtest.h>
 
 #include <gridtools/common/integral_constant.hpp>
+#include <gridtools/common/stride_padding.hpp>
 #include <gridtools/common/timer/timer.hpp>
 #include <gridtools/meta.hpp>
+#include <gridtools/sid/convert.hpp>
 #include <gridtools/stencil/frontend/axis.hpp>
 #include <gridtools/stencil/frontend/make_grid.hpp>
+#include <gridtools/stencil/frontend/run.hpp>
 #include <gridtools/storage/builder.hpp>
 #include <gridtools/storage/sid.hpp>
 
+#include "stream_baseline.hpp"
 #include "timer_select.hpp"
 #include "verifier.hpp"
 
@@ -59,6 +66,25 @@ namespace gridtools {
             static state<Backend> instance(argc, argv);
         }
 
+        /**
+         *  The padding policy of the test storages: `stride_padding` if `GT_TEST_STORAGE_PADDING=enable` is set (the
+         *  perftest sweep does that), no padding otherwise. By default the tests run on the unpadded layout.
+         */
+        struct test_storage_padding {
+            static bool enabled() {
+                static const bool value = [] {
+                    const char *env_value = std::getenv("GT_TEST_STORAGE_PADDING");
+                    return env_value && std::strcmp(env_value, "enable") == 0;
+                }();
+                return value;
+            }
+
+            template <class Int>
+            static Int pad_length(Int length, std::size_t stride_bytes, Int step = 1) {
+                return enabled() ? stride_padding::pad_length(length, stride_bytes, step) : length;
+            }
+        };
+
         template <class T>
         struct regression_test : testing::Test {
             regression_test() {
@@ -79,6 +105,10 @@ namespace gridtools {
             return {};
         }
 
+        // the thread pool of the CPU backends, the STREAM baseline is measured only for them
+        template <class T>
+        void backend_thread_pool(T);
+
         template <int... Is>
         struct inlined_params {
             static int d(size_t i) {
@@ -86,6 +116,8 @@ namespace gridtools {
                 return (loop_t{Is...})[i];
             }
             static size_t steps() { return 0; }
+            static size_t warmup() { return 1; }
+            static bool needs_flush() { return true; }
             static bool needs_verification() { return true; }
             static int &argc() {
                 static int res = 1;
@@ -112,9 +144,32 @@ namespace gridtools {
 
         void add_time(std::string const &name, std::string const &backend, std::string const &float_type, double time);
 
+        void add_bytes(
+            std::string const &name, std::string const &backend, std::string const &float_type, std::size_t bytes);
+
+        void set_stream_bandwidth(double copy, double triad);
+
+        template <class Backend, class ThreadPool = decltype(backend_thread_pool(Backend()))>
+        std::enable_if_t<!std::is_void<ThreadPool>::value> measure_stream_baseline(Backend) {
+            static bool done = [] {
+                auto bandwidth = measure_stream_bandwidth(ThreadPool());
+                set_stream_bandwidth(bandwidth.first, bandwidth.second);
+                return true;
+            }();
+            (void)done;
+        }
+
+        template <class Backend, class ThreadPool = decltype(backend_thread_pool(Backend()))>
+        std::enable_if_t<std::is_void<ThreadPool>::value> measure_stream_baseline(Backend) {}
+
+        template <size_t>
+        struct traffic_plh {};
+
         struct cmdline_params {
             static int d(size_t i);
             static size_t steps();
+            static size_t warmup();
+            static bool needs_flush();
             static bool needs_verification();
             static int &argc();
             static char **argv();
@@ -175,16 +230,19 @@ namespace gridtools {
 
                 template <class T = FloatType>
                 static auto builder() {
-                    return storage::builder<storage_traits_t> //
-                        .dimensions(d(0), d(1), k_size())     //
-                        .halos(Halo, Halo, 0)                 //
+                    return storage::builder<storage_traits_t>     //
+                        .dimensions(d(0), d(1), k_size())         //
+                        .halos(Halo, Halo, 0)                     //
+                        .template padding<test_storage_padding>() //
                         .template type<T>();
                 }
 
                 static Backend backend() { return {}; }
 
-                using storage_type =
-                    decltype(storage::builder<storage_traits_t>.dimensions(0, 0, 0).template type<FloatType>()());
+                using storage_type = decltype(storage::builder<storage_traits_t>
+                                                  .dimensions(0, 0, 0)
+                                                  .template padding<test_storage_padding>()
+                                                  .template type<FloatType>()());
 
                 template <class T = FloatType,
                     class U,
@@ -245,10 +303,12 @@ namespace gridtools {
                     size_t steps = ParamsSource::steps();
                     if (steps == 0 || backend_skip_benchmark(Backend()))
                         return;
-                    comp();
+                    for (size_t i = 0; i != ParamsSource::warmup(); ++i)
+                        comp();
                     timer_impl_t timer;
                     for (size_t i = 0; i != steps; ++i) {
-                        flush_cache(timer);
+                        if (ParamsSource::needs_flush())
+                            flush_cache(timer);
                         timer.start_impl();
                         comp();
                         auto time = timer.pause_impl();
@@ -256,6 +316,50 @@ namespace gridtools {
                     }
                 }
 
+                /**
+                 *  The same as above, but additionally reports the achieved memory bandwidth relative to the STREAM
+                 *  baseline. `comp` should run `spec` on `fields`.
+                 *
+                 *  The traffic per run is derived from the spec: the fields that are only read are loaded once
+                 *  within the extents of their accessors, the written fields are stored once at the computed points.
+                 *  That is the lower bound, the temporaries, the halo reloads and the write allocation are not taken
+                 *  into account.
+                 */
+                template <class Comp, class Spec, class... Fields>
+                static void benchmark(std::string const &name, Comp &&comp, Spec spec, Fields const &... fields) {
+                    if (ParamsSource::steps() == 0 || backend_skip_benchmark(Backend()))
+                        return;
+                    measure_stream_baseline(Backend());
+                    benchmark(name, comp);
+                    add_bytes(name,
+                        backend_name(Backend()),
+                        float_type_name(),
+                        traffic(spec, std::index_sequence_for<Fields...>(), fields...));
+                }
+
+                template <class Spec, class... Fields, size_t... Args>
+                static std::size_t traffic(Spec spec, std::index_sequence<Args...>, Fields const &...) {
+                    auto testee = spec(traffic_plh<Args>()...);
+                    auto grid = make_grid();
+                    std::size_t sizes[] = {
+                        0, field_traffic<sid::storage_element_type<Fields>>(testee, traffic_plh<Args>(), grid)...};
+                    std::size_t res = 0;
+                    for (auto size : sizes)
+                        res += size;
+                    return res;
+                }
+
+                template <class T, class Spec, class Plh, class Grid>
+                static std::size_t field_traffic(Spec spec, Plh plh, Grid const &grid) {
+                    using extent_t = decltype(stencil::get_arg_extent(spec, plh));
+                    std::size_t k = grid.k_size();
+                    if (decltype(stencil::get_arg_intent(spec, plh))::value == stencil::intent::inout)
+                        return sizeof(T) * grid.i_size() * grid.j_size() * k;
+                    std::size_t i = grid.i_size() + extent_t::iplus::value - extent_t::iminus::value;
+                    std::size_t j = grid.j_size() + extent_t::jplus::value - extent_t::jminus::value;
+                    return sizeof(T) * i * j * k;
+                }
+
                 static auto test_name() {
                     return std::string() + backend_name(Backend()) + "_" + float_type_name() + ParamsSource::name();
                 }
@@ -34,12 +34,12 @@ namespace {
 
     GT_REGRESSION_TEST(copy_stencil, test_environment<>, stencil_backend_t) {
         auto in = [](int i, int j, int k) { return i + j + k; };
+        auto spec = [](auto in, auto out) { return execute_parallel().stage(copy_functor(), in, out); };
+        auto in_field = TypeParam::make_const_storage(in);
         auto out = TypeParam::make_storage();
-        auto comp = [&out, grid = TypeParam::make_grid(), in = TypeParam::make_const_storage(in)] {
-            run_single_stage(copy_functor(), stencil_backend_t(), grid, in, out);
-        };
+        auto comp = [&, grid = TypeParam::make_grid()] { run(spec, stencil_backend_t(), grid, in_field, out); };
         comp();
         TypeParam::verify(in, out);
-        TypeParam::benchmark("copy_stencil", comp);
+        TypeParam::benchmark("copy_stencil", comp, spec, in_field, out);
     }
 } // namespace
@@ -90,13 +90,16 @@ namespace {
         }
     };
 
-    template <class Env,
+    // `FluxPolicy` is the `tmp_policy` of the flux temporaries
+    template <class FluxPolicy,
+        class Env,
         std::enable_if_t<
             !meta::is_instantiation_of<gpu_horizontal_backend::gpu_horizontal, typename Env::backend_t>::value,
             int> = 0>
     auto get_spec(Env) {
         return [](auto in, auto coeff, auto out) {
-            GT_DECLARE_TMP(typename Env::float_t, lap, flx, fly);
+            GT_DECLARE_TMP(typename Env::float_t, lap);
+            GT_DECLARE_TMP_WITH_POLICY(typename Env::float_t, FluxPolicy, flx, fly);
             return execute_parallel()
                 .ij_cached(lap, flx, fly)
                 .stage(lap_function(), lap, in)
@@ -106,13 +109,15 @@ namespace {
         };
     }
 
-    template <class Env,
+    template <class FluxPolicy,
+        class Env,
         std::enable_if_t<
             meta::is_instantiation_of<gpu_horizontal_backend::gpu_horizontal, typename Env::backend_t>::value,
             int> = 0>
     auto get_spec(Env) {
         return [](auto in, auto coeff, auto out) {
-            GT_DECLARE_TMP(typename Env::float_t, inc, lap, flx, fly);
+            GT_DECLARE_TMP(typename Env::float_t, inc, lap);
+            GT_DECLARE_TMP_WITH_POLICY(typename Env::float_t, FluxPolicy, flx, fly);
             return execute_parallel()
                 .stage(copy_function(), inc, in)
                 .stage(lap_function(), lap, inc)
@@ -128,9 +133,25 @@ namespace {
         auto comp = [grid = TypeParam::make_grid(),
                         coeff = TypeParam::make_const_storage(repo.coeff),
                         in = TypeParam::make_const_storage(repo.in),
-                        &out] { run(get_spec(TypeParam()), TypeParam::backend(), grid, in, coeff, out); };
+                        &out] {
+            run(get_spec<tmp_policy::materialize>(TypeParam()), TypeParam::backend(), grid, in, coeff, out);
+        };
         comp();
         TypeParam::verify(repo.out, out);
         TypeParam::benchmark("horizontal_diffusion", comp);
     }
+
+    GT_REGRESSION_TEST(horizontal_diffusion_recompute, test_environment<2>, stencil_backend_t) {
+        horizontal_diffusion_repository repo(TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        auto out = TypeParam::make_storage();
+        auto comp = [grid = TypeParam::make_grid(),
+                        coeff = TypeParam::make_const_storage(repo.coeff),
+                        in = TypeParam::make_const_storage(repo.in),
+                        &out] {
+            run(get_spec<tmp_policy::recompute>(TypeParam()), TypeParam::backend(), grid, in, coeff, out);
+        };
+        comp();
+        TypeParam::verify(repo.out, out);
+        TypeParam::benchmark("horizontal_diffusion_recompute", comp);
+    }
 } // namespace
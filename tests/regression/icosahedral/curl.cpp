@@ -60,4 +60,19 @@ namespace {
             out);
         TypeParam ::verify(repo.curl_u, out, eq<TypeParam>);
     }
+
+    GT_REGRESSION_TEST(curl_neighbor_table, icosahedral_test_environment<2>, stencil_backend_t) {
+        operators_repository repo = {TypeParam::d(0), TypeParam::d(1)};
+        auto v2e = [](int, int, int, int c) { return make_structured_row<vertices, edges, 6>(c); };
+        auto out = TypeParam ::icosahedral_make_storage(vertices());
+        run_single_stage(curl_functor_neighbor_table(),
+            stencil_backend_t(),
+            TypeParam ::make_grid(),
+            TypeParam ::template icosahedral_make_storage<neighbor_table_row<6> const>(vertices(), v2e),
+            TypeParam ::icosahedral_make_storage(edges(), repo.u),
+            TypeParam ::icosahedral_make_storage(vertices(), repo.dual_area_reciprocal),
+            TypeParam ::icosahedral_make_storage(edges(), repo.dual_edge_length),
+            out);
+        TypeParam ::verify(repo.curl_u, out, eq<TypeParam>);
+    }
 } // namespace
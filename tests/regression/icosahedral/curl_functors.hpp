@@ -82,4 +82,31 @@ namespace ico_operators {
             eval(out_vertices()) = t * eval(dual_area_reciprocal());
         }
     };
+
+    // the sign of the edge follows its position in the row: the table should have the order of `make_structured_row`
+    struct curl_functor_neighbor_table {
+        using v2e = table_accessor<0, vertices, edges, 6>;
+        using in_edges = in_accessor<1, edges, extent<-1, 0, -1, 0>>;
+        using dual_area_reciprocal = in_accessor<2, vertices>;
+        using dual_edge_length = in_accessor<3, edges, extent<-1, 0, -1, 0>>;
+        using out_vertices = inout_accessor<4, vertices>;
+
+        using param_list = make_param_list<v2e, in_edges, dual_area_reciprocal, dual_edge_length, out_vertices>;
+        using location = vertices;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            std::decay_t<decltype(eval(out_vertices()))> t = 0;
+            int e = 0;
+            eval.for_neighbors(
+                [&](auto in, auto len) {
+                    t += (e % 2 ? 1 : -1) * in * len;
+                    ++e;
+                },
+                v2e(),
+                in_edges(),
+                dual_edge_length());
+            eval(out_vertices()) = t * eval(dual_area_reciprocal());
+        }
+    };
 } // namespace ico_operators
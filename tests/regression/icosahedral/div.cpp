@@ -53,4 +53,19 @@ namespace {
             out);
         TypeParam ::verify(repo.div_u, out);
     }
+
+    GT_REGRESSION_TEST(div_neighbor_table, icosahedral_test_environment<2>, stencil_backend_t) {
+        operators_repository repo = {TypeParam::d(0), TypeParam::d(1)};
+        auto c2e = [](int, int, int, int c) { return make_structured_row<cells, edges, 3>(c); };
+        auto out = TypeParam ::icosahedral_make_storage(cells());
+        run_single_stage(div_functor_neighbor_table(),
+            stencil_backend_t(),
+            TypeParam::make_grid(),
+            TypeParam ::template icosahedral_make_storage<neighbor_table_row<3> const>(cells(), c2e),
+            TypeParam ::icosahedral_make_storage(edges(), repo.u),
+            TypeParam ::icosahedral_make_storage(edges(), repo.edge_length),
+            TypeParam ::icosahedral_make_storage(cells(), repo.cell_area_reciprocal),
+            out);
+        TypeParam ::verify(repo.div_u, out);
+    }
 } // namespace
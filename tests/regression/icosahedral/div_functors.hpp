@@ -70,4 +70,22 @@ namespace ico_operators {
             eval(out_cells()) = (Eval::color == 0 ? 1 : -1) * t * eval(cell_area_reciprocal());
         }
     };
+
+    struct div_functor_neighbor_table {
+        using c2e = table_accessor<0, cells, edges, 3>;
+        using in_edges = in_accessor<1, edges, extent<0, 1, 0, 1>>;
+        using edge_length = in_accessor<2, edges, extent<0, 1, 0, 1>>;
+        using cell_area_reciprocal = in_accessor<3, cells>;
+        using out_cells = inout_accessor<4, cells>;
+
+        using param_list = make_param_list<c2e, in_edges, edge_length, cell_area_reciprocal, out_cells>;
+        using location = cells;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            std::decay_t<decltype(eval(out_cells()))> t = 0;
+            eval.for_neighbors([&](auto in, auto len) { t += in * len; }, c2e(), in_edges(), edge_length());
+            eval(out_cells()) = (Eval::color == 0 ? 1 : -1) * t * eval(cell_area_reciprocal());
+        }
+    };
 } // namespace ico_operators
@@ -48,6 +48,39 @@ namespace {
         }
     };
 
+    struct lap_functor_neighbor_table {
+        using e2c = table_accessor<0, edges, cells, 2>;
+        using e2v = table_accessor<1, edges, vertices, 2>;
+        using in_cells = in_accessor<2, cells, extent<-1, 0, -1, 0>>;
+        using dual_edge_length_reciprocal = in_accessor<3, edges>;
+        using in_vertices = in_accessor<4, vertices, extent<0, 1, 0, 1>>;
+        using edge_length_reciprocal = in_accessor<5, edges>;
+        using out_edges = inout_accessor<6, edges>;
+        using param_list = make_param_list<e2c,
+            e2v,
+            in_cells,
+            dual_edge_length_reciprocal,
+            in_vertices,
+            edge_length_reciprocal,
+            out_edges>;
+        using location = edges;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            std::decay_t<decltype(eval(dual_edge_length_reciprocal()))> grad_n = 0;
+            int e = 0;
+            eval.for_neighbors([&](auto in) { grad_n += (e++ ? 1 : -1) * in; }, e2c(), in_cells());
+            grad_n *= eval(dual_edge_length_reciprocal());
+
+            std::decay_t<decltype(eval(out_edges()))> grad_tau = 0;
+            e = 0;
+            eval.for_neighbors([&](auto in) { grad_tau += (e++ ? 1 : -1) * in; }, e2v(), in_vertices());
+            grad_tau *= eval(edge_length_reciprocal());
+
+            eval(out_edges()) = grad_n - grad_tau;
+        }
+    };
+
     GT_REGRESSION_TEST(lap_weights, icosahedral_test_environment<2>, stencil_backend_t) {
         using float_t = typename TypeParam ::float_t;
         auto spec = [](auto edge_length,
@@ -135,4 +168,62 @@ namespace {
             out);
         TypeParam::verify(TypeParam::icosahedral_make_storage(edges(), repo.lap), out);
     }
+
+    GT_REGRESSION_TEST(lap_neighbor_table, icosahedral_test_environment<2>, stencil_backend_t) {
+        using float_t = typename TypeParam ::float_t;
+        auto spec = [](auto c2e,
+                        auto v2e,
+                        auto e2c,
+                        auto e2v,
+                        auto in_edges,
+                        auto edge_length,
+                        auto cell_area_reciprocal,
+                        auto dual_area_reciprocal,
+                        auto dual_edge_length,
+                        auto dual_edge_length_reciprocal,
+                        auto edge_length_reciprocal,
+                        auto out) {
+            GT_DECLARE_ICO_TMP(float_t, cells, div_on_cells);
+            GT_DECLARE_ICO_TMP(float_t, vertices, curl_on_vertices);
+            return execute_parallel()
+                .ij_cached(div_on_cells, curl_on_vertices)
+                .stage(div_functor_neighbor_table(), c2e, in_edges, edge_length, cell_area_reciprocal, div_on_cells)
+                .stage(curl_functor_neighbor_table(),
+                    v2e,
+                    in_edges,
+                    dual_area_reciprocal,
+                    dual_edge_length,
+                    curl_on_vertices)
+                .stage(lap_functor_neighbor_table(),
+                    e2c,
+                    e2v,
+                    div_on_cells,
+                    dual_edge_length_reciprocal,
+                    curl_on_vertices,
+                    edge_length_reciprocal,
+                    out);
+        };
+        auto c2e = [](int, int, int, int c) { return make_structured_row<cells, edges, 3>(c); };
+        auto v2e = [](int, int, int, int c) { return make_structured_row<vertices, edges, 6>(c); };
+        auto e2c = [](int, int, int, int c) { return make_structured_row<edges, cells, 2>(c); };
+        auto e2v = [](int, int, int, int c) { return make_structured_row<edges, vertices, 2>(c); };
+        operators_repository repo = {TypeParam::d(0), TypeParam::d(1)};
+        auto out = TypeParam::icosahedral_make_storage(edges());
+        run(spec,
+            stencil_backend_t(),
+            TypeParam::make_grid(),
+            TypeParam::template icosahedral_make_storage<neighbor_table_row<3> const>(cells(), c2e),
+            TypeParam::template icosahedral_make_storage<neighbor_table_row<6> const>(vertices(), v2e),
+            TypeParam::template icosahedral_make_storage<neighbor_table_row<2> const>(edges(), e2c),
+            TypeParam::template icosahedral_make_storage<neighbor_table_row<2> const>(edges(), e2v),
+            TypeParam::icosahedral_make_storage(edges(), repo.u),
+            TypeParam::icosahedral_make_storage(edges(), repo.edge_length),
+            TypeParam::icosahedral_make_storage(cells(), repo.cell_area_reciprocal),
+            TypeParam::icosahedral_make_storage(vertices(), repo.dual_area_reciprocal),
+            TypeParam::icosahedral_make_storage(edges(), repo.dual_edge_length),
+            TypeParam::icosahedral_make_storage(edges(), repo.dual_edge_length_reciprocal),
+            TypeParam::icosahedral_make_storage(edges(), repo.edge_length_reciprocal),
+            out);
+        TypeParam::verify(TypeParam::icosahedral_make_storage(edges(), repo.lap), out);
+    }
 } // namespace
@@ -0,0 +1,69 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/icosahedral.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+#include "neighbours_of.hpp"
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace icosahedral;
+
+    using row_t = neighbor_table_row<6>;
+
+    struct test_on_neighbor_table_functor {
+        using v2e = table_accessor<0, vertices, edges, 6>;
+        using in = in_accessor<1, edges, extent<-1, 0, -1, 0>>;
+        using out = inout_accessor<2, vertices>;
+        using param_list = make_param_list<v2e, in, out>;
+        using location = vertices;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            std::decay_t<decltype(eval(out()))> res = 0;
+            eval.for_neighbors([&res](auto in) { res += in; }, v2e(), in());
+            eval(out()) = res;
+        }
+    };
+
+    // every third vertex mimics a pentagon point: the last neighbor is dropped from its row
+    bool is_pentagon(int_t i, int_t j) { return (i + j) % 3 == 0; }
+
+    GT_REGRESSION_TEST(stencil_on_neighbor_table, icosahedral_test_environment<1>, stencil_backend_t) {
+        auto in = [](int_t i, int_t j, int_t k, int_t c) { return i + j + k + c; };
+        auto table = [](int_t i, int_t j, int_t, int_t c) {
+            auto res = make_structured_row<vertices, edges, 6>(c);
+            if (is_pentagon(i, j))
+                --res.size;
+            return res;
+        };
+        auto ref = [&](int_t i, int_t j, int_t k, int_t c) {
+            typename TypeParam::float_t res = {};
+            auto neighbours = neighbours_of<vertices, edges>(i, j, k, c);
+            if (is_pentagon(i, j))
+                neighbours.pop_back();
+            for (auto &&item : neighbours)
+                res += item.call(in);
+            return res;
+        };
+        auto out = TypeParam::icosahedral_make_storage(vertices());
+        run_single_stage(test_on_neighbor_table_functor(),
+            stencil_backend_t(),
+            TypeParam::make_grid(),
+            TypeParam::template icosahedral_make_storage<row_t const>(vertices(), table),
+            TypeParam::icosahedral_make_storage(edges(), in),
+            out);
+        TypeParam::verify(ref, out);
+    }
+} // namespace
@@ -33,8 +33,12 @@ namespace {
         auto ref = [in](int_t i, int_t j, int_t k) {
             return 4 * in(i, j, k) - (in(i + 1, j, k) + in(i, j + 1, k) + in(i - 1, j, k) + in(i, j - 1, k));
         };
+        auto spec = [](auto out, auto in) { return execute_parallel().stage(lap(), out, in); };
+        auto in_field = TypeParam::make_const_storage(in);
         auto out = TypeParam::make_storage();
-        run_single_stage(lap(), stencil_backend_t(), TypeParam::make_grid(), out, TypeParam::make_storage(in));
+        auto comp = [&, grid = TypeParam::make_grid()] { run(spec, stencil_backend_t(), grid, out, in_field); };
+        comp();
         TypeParam::verify(ref, out);
+        TypeParam::benchmark("laplacian", comp, spec, out, in_field);
     }
 } // namespace
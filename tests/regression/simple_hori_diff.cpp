@@ -63,24 +63,23 @@ namespace {
     GT_REGRESSION_TEST(simple_hori_diff, test_environment<2>, stencil_backend_t) {
         const auto j_builder = TypeParam::builder().template selector<0, 1, 0>();
         horizontal_diffusion_repository repo(TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        const auto spec = [](auto coeff, auto in, auto out, auto crlato, auto crlatu) {
+            GT_DECLARE_TMP(typename TypeParam::float_t, lap);
+            return execute_parallel()
+                .ij_cached(lap)
+                .stage(wlap_function(), lap, in, crlato, crlatu)
+                .stage(divflux_function(), out, in, lap, crlato, coeff);
+        };
+        auto coeff = TypeParam::make_storage(repo.coeff);
+        auto in = TypeParam::make_storage(repo.in);
         auto out = TypeParam::make_storage();
-        auto comp = [grid = TypeParam::make_grid(),
-                        coeff = TypeParam::make_storage(repo.coeff),
-                        in = TypeParam::make_storage(repo.in),
-                        &out,
-                        crlato = j_builder.initializer(repo.crlato)(),
-                        crlatu = j_builder.initializer(repo.crlatu)()] {
-            const auto spec = [](auto coeff, auto in, auto out, auto crlato, auto crlatu) {
-                GT_DECLARE_TMP(typename TypeParam::float_t, lap);
-                return execute_parallel()
-                    .ij_cached(lap)
-                    .stage(wlap_function(), lap, in, crlato, crlatu)
-                    .stage(divflux_function(), out, in, lap, crlato, coeff);
-            };
+        auto crlato = j_builder.initializer(repo.crlato)();
+        auto crlatu = j_builder.initializer(repo.crlatu)();
+        auto comp = [&, grid = TypeParam::make_grid()] {
             run(spec, stencil_backend_t(), grid, coeff, in, out, crlato, crlatu);
         };
         comp();
         TypeParam::verify(repo.out_simple, out);
-        TypeParam::benchmark("simple_hori_diff", comp);
+        TypeParam::benchmark("simple_hori_diff", comp, spec, coeff, in, out, crlato, crlatu);
     }
 } // namespace
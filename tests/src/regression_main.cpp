@@ -10,26 +10,71 @@
 #include <test_environment.hpp>
 #include <timer_select.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <gtest/gtest.h>
 
 namespace {
     struct state {
         std::array<int, 3> m_d = {};
         size_t m_steps = 0;
+        size_t m_warmup = 1;
+        bool m_needs_flush = true;
         bool m_needs_verification = true;
+        double m_copy_bandwidth = 0;
+        double m_triad_bandwidth = 0;
         int m_argc;
         char **m_argv;
     } s_state;
 
+    [[noreturn]] void usage(char const *name) {
+        std::cerr << "Usage: " << name << " "
+                  << "dimx dimy dimz tsteps [-d] [--warmup=N] [--no-flush]\n\twhere args are integer sizes of "
+                     "the data fields and tsteps is the number of time steps to run in a benchmark run\n"
+                     "\t-d disables verification\n"
+                     "\t--warmup=N sets the number of untimed runs before the measurement (default 1)\n"
+                     "\t--no-flush disables cache flushing between the timed runs"
+                  << std::endl;
+        exit(1);
+    }
+
+    // non negative decimal integer, std::stoul alone would accept the sign and the trailing garbage
+    bool parse_count(char const *src, size_t &dst) {
+        if (!std::isdigit(static_cast<unsigned char>(*src)))
+            return false;
+        try {
+            size_t pos;
+            unsigned long res = std::stoul(src, &pos);
+            if (src[pos])
+                return false;
+            dst = res;
+            return true;
+        } catch (std::logic_error const &) {
+            return false;
+        }
+    }
+
     bool init(int argc, char **argv) {
         assert(argc > 0);
         s_state.m_argc = 1;
@@ -45,18 +90,27 @@ namespace {
 
         if (argc == 1)
             return false;
-        if (argc < 4) {
-            std::cerr << "Usage: " << argv[0] << " "
-                      << "dimx dimy dimz tsteps\n\twhere args are integer sizes of the data fields and tsteps "
-                         "is the number of time steps to run in a benchmark run"
-                      << std::endl;
-            exit(1);
-        }
+        if (argc < 4)
+            usage(argv[0]);
 
         for (size_t i = 0; i < 3; ++i)
             s_state.m_d[i] = std::atoi(argv[i + 1]);
         s_state.m_steps = argc > 4 ? std::atoi(argv[4]) : 10;
-        s_state.m_needs_verification = argc < 6 || std::strcmp(argv[5], "-d") != 0;
+        for (int i = 5; i < argc; ++i) {
+            if (std::strcmp(argv[i], "-d") == 0)
+                s_state.m_needs_verification = false;
+            else if (std::strncmp(argv[i], "--warmup=", 9) == 0) {
+                if (!parse_count(argv[i] + 9, s_state.m_warmup)) {
+                    std::cerr << "Invalid warmup count: " << argv[i] + 9 << std::endl;
+                    usage(argv[0]);
+                }
+            } else if (std::strcmp(argv[i], "--no-flush") == 0)
+                s_state.m_needs_flush = false;
+            else {
+                std::cerr << "Unknown option: " << argv[i] << std::endl;
+                usage(argv[0]);
+            }
+        }
         return true;
     }
 
@@ -119,12 +173,89 @@ namespace {
         separator(std::string val) : m_val(std::move(val)), m_is_first(true) {}
     };
 
+    // linear interpolation between the closest ranks, the same as numpy.percentile default
+    double percentile(std::vector<double> const &sorted, double p) {
+        assert(!sorted.empty());
+        double pos = p / 100 * (sorted.size() - 1);
+        size_t lo = std::floor(pos);
+        size_t hi = std::ceil(pos);
+        return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+    }
+
+    void print_statistics(std::ostream &strm, std::vector<double> series) {
+        std::sort(series.begin(), series.end());
+        double mean = 0;
+        for (auto val : series)
+            mean += val;
+        mean /= series.size();
+        double variance = 0;
+        for (auto val : series)
+            variance += (val - mean) * (val - mean);
+        variance = series.size() > 1 ? variance / (series.size() - 1) : 0;
+        strm << "{\"min\" : " << series.front() << ", \"p05\" : " << percentile(series, 5)
+             << ", \"p25\" : " << percentile(series, 25) << ", \"median\" : " << percentile(series, 50)
+             << ", \"p75\" : " << percentile(series, 75) << ", \"p95\" : " << percentile(series, 95)
+             << ", \"max\" : " << series.back() << ", \"mean\" : " << mean << ", \"variance\" : " << variance
+             << "}";
+    }
+
+    int threads_count() {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    std::vector<int> affinity() {
+        std::vector<int> res;
+#ifdef __linux__
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET(cpu, &set))
+                    res.push_back(cpu);
+#endif
+        return res;
+    }
+
+    // the average of the current frequencies reported by the kernel, zero if unknown
+    double cpu_mhz() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        double sum = 0;
+        int count = 0;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 7, "cpu MHz") != 0)
+                continue;
+            auto pos = line.find(':');
+            if (pos == std::string::npos)
+                continue;
+            sum += std::atof(line.c_str() + pos + 1);
+            ++count;
+        }
+        return count ? sum / count : 0;
+    }
+
     class perf_times {
         using key_t = std::tuple<std::string, std::string, std::string>;
         using value_t = std::vector<double>;
         using map_t = std::map<key_t, value_t>;
 
         map_t m_map;
+        std::map<key_t, std::size_t> m_bytes;
+
+        // achieved bandwidth at the median time and its ratio to the STREAM baseline
+        static void print_bandwidth(std::ostream &strm, std::vector<double> series, std::size_t bytes) {
+            std::sort(series.begin(), series.end());
+            double bandwidth = bytes / percentile(series, 50);
+            strm << "{\"bytes\" : " << bytes << ", \"gb_per_s\" : " << bandwidth * 1e-9;
+            if (s_state.m_copy_bandwidth > 0)
+                strm << ", \"copy_percent\" : " << 100 * bandwidth / s_state.m_copy_bandwidth;
+            if (s_state.m_triad_bandwidth > 0)
+                strm << ", \"triad_percent\" : " << 100 * bandwidth / s_state.m_triad_bandwidth;
+            strm << "}";
+        }
 
         friend std::ostream &operator<<(std::ostream &strm, perf_times const &obj) {
             strm << "{\n";
@@ -145,13 +276,34 @@ namespace {
                     strm << val;
                     ++series;
                 }
-                strm << "]\n";
+                strm << "],\n";
+                strm << "      \"statistics\" : ";
+                print_statistics(strm, item.second);
+                auto bytes = obj.m_bytes.find(item.first);
+                if (bytes != obj.m_bytes.end()) {
+                    strm << ",\n      \"bandwidth\" : ";
+                    print_bandwidth(strm, item.second, bytes->second);
+                }
+                strm << "\n";
                 strm << "    }";
                 ++outputs;
             }
             if (outputs)
                 strm << "\n  ";
-            strm << "]\n";
+            strm << "],\n";
+            strm << "  \"machine\" : {\n";
+            strm << "    \"threads\" : " << threads_count() << ",\n";
+            strm << "    \"affinity\" : [";
+            separator sep(", ");
+            for (int cpu : affinity())
+                strm << sep << cpu;
+            strm << "],\n";
+            strm << "    \"cpu_mhz\" : " << cpu_mhz() << ",\n";
+            strm << "    \"warmup\" : " << s_state.m_warmup << ",\n";
+            strm << "    \"flush_cache\" : " << (s_state.m_needs_flush ? "true" : "false") << ",\n";
+            strm << "    \"stream_copy_gb_per_s\" : " << s_state.m_copy_bandwidth * 1e-9 << ",\n";
+            strm << "    \"stream_triad_gb_per_s\" : " << s_state.m_triad_bandwidth * 1e-9 << "\n";
+            strm << "  }\n";
             strm << "}\n";
             return strm;
         }
@@ -160,6 +312,11 @@ namespace {
         void add(std::string const &name, std::string const &backend, std::string const &float_type, double time) {
             m_map[key_t(name, backend, float_type)].push_back(time);
         }
+
+        void add_bytes(
+            std::string const &name, std::string const &backend, std::string const &float_type, std::size_t bytes) {
+            m_bytes[key_t(name, backend, float_type)] = bytes;
+        }
     };
 
     auto &times() {
@@ -174,8 +331,20 @@ namespace gridtools {
             times().add(name, backend, float_type, time);
         }
 
+        void add_bytes(
+            std::string const &name, std::string const &backend, std::string const &float_type, std::size_t bytes) {
+            times().add_bytes(name, backend, float_type, bytes);
+        }
+
+        void set_stream_bandwidth(double copy, double triad) {
+            s_state.m_copy_bandwidth = copy;
+            s_state.m_triad_bandwidth = triad;
+        }
+
         int cmdline_params::d(size_t i) { return s_state.m_d[i]; }
         size_t cmdline_params::steps() { return s_state.m_steps; }
+        size_t cmdline_params::warmup() { return s_state.m_warmup; }
+        bool cmdline_params::needs_flush() { return s_state.m_needs_flush; }
         bool cmdline_params::needs_verification() { return s_state.m_needs_verification; }
         int &cmdline_params::argc() { return s_state.m_argc; }
         char **cmdline_params::argv() { return s_state.m_argv; }
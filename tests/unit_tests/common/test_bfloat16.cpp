@@ -0,0 +1,43 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/common/bfloat16.hpp>
+
+#include <cmath>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+namespace gridtools {
+    namespace {
+        static_assert(sizeof(bfloat16) == 2, "");
+
+        TEST(bfloat16, exact_values) {
+            for (float x : {0.f, 1.f, -2.f, 0.5f, 1024.f, 3.f, -0.375f})
+                EXPECT_EQ(float(bfloat16(x)), x);
+            EXPECT_EQ(bfloat16(1.f).bits(), 0x3f80);
+        }
+
+        TEST(bfloat16, rounding) {
+            // 8 bits of mantissa: the spacing at 1 is 2^-7
+            EXPECT_EQ(float(bfloat16(1.f + 1.f / 512)), 1.f);
+            EXPECT_EQ(float(bfloat16(1.f + 3.f / 512)), 1.f + 1.f / 128);
+            // the ties are rounded to even
+            EXPECT_EQ(float(bfloat16(1.f + 1.f / 256)), 1.f);
+            EXPECT_EQ(float(bfloat16(1.f + 3.f / 256)), 1.f + 1.f / 64);
+            EXPECT_NEAR(float(bfloat16(3.14159f)), 3.14159f, 3.14159f / 256);
+        }
+
+        TEST(bfloat16, special_values) {
+            EXPECT_TRUE(std::isnan(float(bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+            EXPECT_TRUE(std::isinf(float(bfloat16(std::numeric_limits<float>::infinity()))));
+            EXPECT_TRUE(std::isinf(float(bfloat16(std::numeric_limits<float>::max()))));
+        }
+    } // namespace
+} // namespace gridtools
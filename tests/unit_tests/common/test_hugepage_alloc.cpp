@@ -9,7 +9,9 @@
  */
 #include <gtest/gtest.h>
 
+#include <cstdio>
 #include <set>
+#include <string>
 
 #include <gridtools/common/hugepage_alloc.hpp>
 
@@ -36,6 +38,13 @@ namespace gridtools {
 
         TEST(hugepage_alloc, page_size) { EXPECT_GT(hugepage_alloc_impl_::page_size(), 0); }
 
+        hugepage_policy policy(std::string const &mode) {
+            hugepage_policy res;
+            if (mode == "disable")
+                res.mode = hugepage_mode::disabled;
+            return res;
+        }
+
         struct hugepage_alloc_fixture : ::testing::TestWithParam<std::string> {
             std::string backup_mode;
             void SetUp() {
@@ -61,10 +70,18 @@ namespace gridtools {
             EXPECT_EQ(value, expected);
         }
 
+        TEST_P(hugepage_alloc_fixture, hugepage_policy_from_env) {
+            auto policy = hugepage_alloc_impl_::hugepage_policy_from_env();
+            EXPECT_EQ(policy.mode, hugepage_alloc_impl_::hugepage_mode_from_env());
+            EXPECT_EQ(policy.page_size, 0);
+            EXPECT_EQ(policy.prefault, hugepage_prefault::none);
+            EXPECT_TRUE(policy.fallback);
+        }
+
         TEST_P(hugepage_alloc_fixture, alloc_free) {
             std::size_t n = 100;
 
-            int *ptr = static_cast<int *>(hugepage_alloc(n * sizeof(int)));
+            int *ptr = static_cast<int *>(hugepage_alloc(n * sizeof(int), policy(GetParam())));
             EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % hugepage_alloc_impl_::cache_line_size(), 0);
 
             for (std::size_t i = 0; i < n; ++i) {
@@ -84,7 +101,7 @@ namespace gridtools {
             std::uintptr_t mask = (1ULL << different_bits) - 1;
             std::set<std::uintptr_t> offsets;
             for (std::size_t i = 0; i < cache_sets; ++i) {
-                double *ptr = static_cast<double *>(hugepage_alloc(sizeof(double)));
+                double *ptr = static_cast<double *>(hugepage_alloc(sizeof(double), policy(GetParam())));
                 offsets.insert(reinterpret_cast<std::uintptr_t>(ptr) & mask);
                 hugepage_free(ptr);
             }
@@ -95,5 +112,101 @@ namespace gridtools {
 
         INSTANTIATE_TEST_SUITE_P(hugepage_alloc, hugepage_alloc_fixture, ::testing::Values("disable", "transparent"));
 
+        TEST(hugepage_alloc, default_policy) {
+            auto &policy = default_hugepage_policy();
+            EXPECT_EQ(&policy, &default_hugepage_policy());
+            void *ptr = hugepage_alloc(100);
+            EXPECT_EQ(hugepage_usage(ptr).mode == hugepage_mode::disabled, policy.mode == hugepage_mode::disabled);
+            hugepage_free(ptr);
+        }
+
+        std::size_t free_hugepages(std::size_t page_size) {
+            std::size_t res = 0;
+            std::string path = "/sys/kernel/mm/hugepages/hugepages-" + std::to_string(page_size / 1024) + "kB/";
+            if (auto *fp = std::fopen((path + "free_hugepages").c_str(), "r")) {
+                if (std::fscanf(fp, "%zu", &res) != 1)
+                    res = 0;
+                std::fclose(fp);
+            }
+            return res;
+        }
+
+        TEST(hugepage_alloc, explicit_fallback) {
+            hugepage_policy policy = {hugepage_mode::explicit_allocation, hugepage_size_1g};
+            void *ptr = hugepage_alloc(1000, policy);
+            auto usage = hugepage_usage(ptr);
+            if (free_hugepages(hugepage_size_1g)) {
+                EXPECT_EQ(usage.mode, hugepage_mode::explicit_allocation);
+                EXPECT_EQ(usage.page_size, hugepage_size_1g);
+            } else {
+                EXPECT_NE(usage.page_size, hugepage_size_1g);
+            }
+            EXPECT_NE(usage.mode, hugepage_mode::disabled);
+            EXPECT_GE(usage.bytes, 1000);
+            static_cast<char *>(ptr)[999] = 1;
+            hugepage_free(ptr);
+        }
+
+#ifdef __linux__
+        TEST(hugepage_alloc, explicit_without_fallback) {
+            hugepage_policy policy = {hugepage_mode::explicit_allocation, hugepage_size_1g};
+            policy.fallback = false;
+            if (free_hugepages(hugepage_size_1g)) {
+                void *ptr = hugepage_alloc(1000, policy);
+                EXPECT_EQ(hugepage_usage(ptr).page_size, hugepage_size_1g);
+                hugepage_free(ptr);
+            } else {
+                EXPECT_THROW(hugepage_alloc(1000, policy), std::bad_alloc);
+            }
+        }
+
+        struct hugepage_prefault_fixture : ::testing::TestWithParam<hugepage_prefault> {};
+
+        TEST_P(hugepage_prefault_fixture, resident) {
+            std::size_t size = 16 * hugepage_alloc_impl_::hugepage_size();
+            hugepage_policy policy = {hugepage_mode::transparent, 0, GetParam()};
+            void *ptr = hugepage_alloc(size, policy);
+            auto usage = hugepage_usage(ptr);
+            EXPECT_EQ(usage.mode, hugepage_mode::transparent);
+            EXPECT_GE(usage.bytes, size);
+            EXPECT_LE(usage.huge_bytes, usage.resident_bytes);
+            EXPECT_LE(usage.resident_bytes, usage.bytes);
+            if (GetParam() == hugepage_prefault::none)
+                EXPECT_LT(usage.resident_bytes, size);
+            else
+                EXPECT_EQ(usage.resident_bytes, usage.bytes);
+            hugepage_free(ptr);
+        }
+
+        INSTANTIATE_TEST_SUITE_P(hugepage_alloc,
+            hugepage_prefault_fixture,
+            ::testing::Values(hugepage_prefault::none, hugepage_prefault::populate, hugepage_prefault::first_touch));
+
+        struct serial {
+            static std::size_t &touched() {
+                static std::size_t res = 0;
+                return res;
+            }
+
+            template <class F, class I>
+            friend void thread_pool_parallel_for_loop(serial, F const &f, I lim) {
+                for (I i = 0; i < lim; ++i)
+                    f(i);
+                touched() += lim;
+            }
+        };
+
+        TEST(hugepage_alloc, first_touch_thread_pool) {
+            std::size_t size = 4 * hugepage_alloc_impl_::hugepage_size();
+            hugepage_policy policy = {hugepage_mode::transparent, 0, hugepage_prefault::first_touch};
+            serial::touched() = 0;
+            void *ptr = hugepage_alloc(size, policy, serial());
+            auto usage = hugepage_usage(ptr);
+            EXPECT_EQ(serial::touched(), usage.bytes / hugepage_alloc_impl_::page_size());
+            EXPECT_EQ(usage.resident_bytes, usage.bytes);
+            hugepage_free(ptr);
+        }
+#endif
+
     } // namespace
 } // namespace gridtools
@@ -0,0 +1,97 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define GT_PROFILING
+#include <gridtools/common/profiling.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace gridtools {
+    namespace profiling {
+        namespace {
+            std::string json_report() {
+                std::ostringstream strm;
+                report_json(strm);
+                return strm.str();
+            }
+
+            size_t count(std::string const &str, std::string const &what) {
+                size_t res = 0;
+                for (auto pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + 1))
+                    ++res;
+                return res;
+            }
+
+            TEST(profiling, nested_regions) {
+                reset();
+                for (int i = 0; i != 3; ++i) {
+                    GT_PROFILING_REGION("outer");
+                    {
+                        GT_PROFILING_REGION("inner");
+                    }
+                    region r(std::string("dynamic"));
+                }
+                auto res = json_report();
+                EXPECT_EQ(count(res, "{\"name\":\"outer\""), 1u) << res;
+                EXPECT_NE(res.find("{\"name\":\"outer\",\"seconds\":"), std::string::npos) << res;
+                EXPECT_NE(res.find("\"calls\":3,\"threads\":1,\"children\":[{\"name\":\"inner\""), std::string::npos)
+                    << res;
+                EXPECT_NE(res.find("{\"name\":\"dynamic\""), std::string::npos) << res;
+            }
+
+            TEST(profiling, threads_are_merged) {
+                reset();
+                auto work = [] {
+                    GT_PROFILING_REGION("work");
+                    GT_PROFILING_REGION("step");
+                };
+                std::thread a(work), b(work);
+                a.join();
+                b.join();
+                auto res = json_report();
+                EXPECT_NE(res.find("{\"name\":\"work\",\"seconds\":"), std::string::npos) << res;
+                EXPECT_NE(res.find("\"calls\":2,\"threads\":2,\"children\":[{\"name\":\"step\""), std::string::npos)
+                    << res;
+            }
+
+            TEST(profiling, nested_on_other_threads) {
+                reset();
+                {
+                    GT_PROFILING_REGION("run");
+                    auto body = nested([] { GT_PROFILING_REGION("stage"); });
+                    std::thread a(body), b(body);
+                    a.join();
+                    b.join();
+                }
+                auto res = json_report();
+                EXPECT_EQ(count(res, "{\"name\":\"run\""), 1u) << res;
+                EXPECT_EQ(count(res, "{\"name\":\"stage\""), 1u) << res;
+                EXPECT_NE(res.find("\"calls\":1,\"threads\":1,\"children\":[{\"name\":\"stage\""), std::string::npos)
+                    << res;
+                EXPECT_NE(res.find("\"calls\":2,\"threads\":2,\"children\":[]"), std::string::npos) << res;
+            }
+
+            TEST(profiling, text_report) {
+                reset();
+                {
+                    GT_PROFILING_REGION("a \"quoted\" region");
+                }
+                std::ostringstream strm;
+                report(strm);
+                EXPECT_NE(strm.str().find("a \"quoted\" region"), std::string::npos);
+                EXPECT_NE(json_report().find("a \\\"quoted\\\" region"), std::string::npos);
+            }
+        } // namespace
+    }     // namespace profiling
+} // namespace gridtools
@@ -0,0 +1,56 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/common/stride_padding.hpp>
+
+#include <gtest/gtest.h>
+
+namespace gridtools {
+    namespace {
+        std::size_t critical() { return stride_padding_impl_::critical_stride(); }
+        std::size_t line() { return hugepage_alloc_impl_::cache_line_size(); }
+
+        TEST(stride_padding, critical_stride) {
+            EXPECT_GE(critical(), hugepage_alloc_impl_::page_size());
+            EXPECT_EQ(critical() % line(), 0);
+        }
+
+        TEST(stride_padding, aliases) {
+            if (!stride_padding::enabled())
+                GTEST_SKIP() << "GT_STRIDE_PADDING=disable";
+            EXPECT_FALSE(stride_padding::aliases(0));
+            EXPECT_FALSE(stride_padding::aliases(critical() / 2));
+            EXPECT_TRUE(stride_padding::aliases(critical()));
+            EXPECT_TRUE(stride_padding::aliases(20 * critical()));
+            EXPECT_TRUE(stride_padding::aliases(3 * critical() + 8));
+            EXPECT_TRUE(stride_padding::aliases(3 * critical() - 8));
+            EXPECT_FALSE(stride_padding::aliases(3 * critical() + line()));
+            EXPECT_FALSE(stride_padding::aliases(3 * critical() + critical() / 2));
+        }
+
+        // the strides of the power-of-two domains are padded away from the multiples of the critical stride
+        TEST(stride_padding, pad_length) {
+            if (!stride_padding::enabled())
+                GTEST_SKIP() << "GT_STRIDE_PADDING=disable";
+            for (std::size_t n : {64, 128, 256, 512, 1024}) {
+                // rows of n doubles, i-first with cache line steps
+                std::size_t row = stride_padding::pad_length(n, sizeof(double), line() / sizeof(double));
+                EXPECT_FALSE(stride_padding::aliases(row * sizeof(double))) << n;
+                EXPECT_LE(row, n + critical() / sizeof(double));
+                // planes of n rows
+                std::size_t rows = stride_padding::pad_length(n, row * sizeof(double));
+                EXPECT_FALSE(stride_padding::aliases(rows * row * sizeof(double))) << n;
+                EXPECT_LE(rows, n + 2);
+            }
+            // nothing to pad
+            EXPECT_EQ(stride_padding::pad_length(100, sizeof(double)), 100);
+            EXPECT_EQ(stride_padding::pad_length(1, critical()), 1);
+        }
+    } // namespace
+} // namespace gridtools
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <gridtools/sid/concept.hpp>
+#include <gridtools/sid/convert.hpp>
 #include <gridtools/sid/simple_ptr_holder.hpp>
 #include <gridtools/sid/synthetic.hpp>
 
@@ -32,5 +33,21 @@ namespace gridtools {
             static_assert(std::is_same<sid::ptr_type<testee_t>, double const *>(), "");
             EXPECT_EQ(sid::get_origin(src)(), sid::get_origin(testee)());
         }
+
+        TEST(as_const, converting) {
+            float data = 42;
+            auto src = sid::convert<double>(sid::synthetic()
+                                                .set<property::origin>(sid::host_device::make_simple_ptr_holder(&data))
+                                                .set<property::strides>(tuple<int>(1))
+                                                .set<property::ptr_diff, int>()
+                                                .set<property::strides_kind, void>());
+            auto testee = sid::as_const(src);
+            using testee_t = decltype(testee);
+
+            static_assert(is_sid<testee_t>(), "");
+            static_assert(std::is_same<sid::ptr_type<testee_t>, sid::converting_ptr<float const, double>>(), "");
+            static_assert(std::is_same<sid::element_type<testee_t>, double>(), "");
+            EXPECT_EQ(*sid::get_origin(testee)(), 42);
+        }
     } // namespace
 } // namespace gridtools
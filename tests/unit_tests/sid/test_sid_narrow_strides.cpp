@@ -0,0 +1,92 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/sid/narrow_strides.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/hymap.hpp>
+#include <gridtools/common/integral_constant.hpp>
+#include <gridtools/common/tuple_util.hpp>
+#include <gridtools/sid/composite.hpp>
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/sid/simple_ptr_holder.hpp>
+#include <gridtools/sid/synthetic.hpp>
+
+namespace gridtools {
+    namespace {
+        using namespace literals;
+        using sid::property;
+        namespace tu = tuple_util;
+
+        struct a;
+        struct b;
+        struct i;
+        struct j;
+        struct my_strides_kind;
+
+        template <class T>
+        auto make_sid(T *ptr, std::ptrdiff_t j_stride) {
+            return sid::synthetic()
+                .template set<property::origin>(sid::host_device::make_simple_ptr_holder(ptr))
+                .template set<property::strides>(tu::make<hymap::keys<i, j>::values>(1_c, j_stride))
+                .template set<property::strides_kind, my_strides_kind>()
+                .template set<property::ptr_diff, std::ptrdiff_t>();
+        }
+
+        TEST(narrow_strides, smoke) {
+            double data[3][5] = {};
+            data[2][3] = 42;
+            auto testee = sid::narrow_strides(make_sid(&data[0][0], 5));
+            using testee_t = decltype(testee);
+
+            static_assert(is_sid<testee_t>(), "");
+            static_assert(std::is_same<sid::ptr_diff_type<testee_t>, int_t>(), "");
+            auto &&strides = sid::get_strides(testee);
+            static_assert(
+                std::is_same<std::decay_t<decltype(sid::get_stride<i>(strides))>, integral_constant<int, 1>>(), "");
+            static_assert(std::is_same<std::decay_t<decltype(sid::get_stride<j>(strides))>, int_t>(), "");
+            EXPECT_EQ(5, sid::get_stride<j>(strides));
+
+            auto ptr = sid::get_origin(testee)();
+            sid::shift(ptr, sid::get_stride<i>(strides), 3);
+            sid::shift(ptr, sid::get_stride<j>(strides), 2);
+            EXPECT_EQ(42, *ptr);
+        }
+
+        TEST(narrow_strides, shared_strides_in_composite) {
+            double x[3][5] = {};
+            float y[3][5] = {};
+            auto testee = sid::composite::make<a, b>(
+                sid::narrow_strides(make_sid(&x[0][0], 5)), sid::narrow_strides(make_sid(&y[0][0], 5)));
+            auto single = sid::composite::make<a>(sid::narrow_strides(make_sid(&x[0][0], 5)));
+            EXPECT_EQ(sizeof(sid::get_strides(single)), sizeof(sid::get_strides(testee)));
+            EXPECT_EQ(sizeof(int_t), sizeof(sid::get_stride<j>(sid::get_strides(testee))));
+        }
+
+        TEST(narrow_strides, range_check) {
+            double data;
+            EXPECT_THROW(sid::narrow_strides(make_sid(&data, std::ptrdiff_t(1) << 33)), std::out_of_range);
+            EXPECT_NO_THROW(sid::narrow_strides(make_sid(&data, 1 << 20)));
+            auto bounded = [&](std::ptrdiff_t j_size) {
+                return make_sid(&data, 1 << 20)
+                    .set<property::lower_bounds>(tu::make<hymap::keys<j>::values>(0_c))
+                    .set<property::upper_bounds>(tu::make<hymap::keys<j>::values>(j_size));
+            };
+            EXPECT_NO_THROW(sid::narrow_strides(bounded(1 << 10)));
+            EXPECT_THROW(sid::narrow_strides(bounded(1 << 12)), std::out_of_range);
+            EXPECT_NO_THROW(sid::narrow_strides<std::ptrdiff_t>(bounded(1 << 12)));
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,57 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/common/streaming_store.hpp>
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/meta.hpp>
+#include <gridtools/stencil/cpu_ifirst/entry_point.hpp>
+
+using namespace gridtools;
+using namespace stencil;
+
+namespace {
+    struct a {};
+    struct b {};
+
+    using deref_t = cpu_ifirst_backend::deref_f<meta::list<a>>;
+
+    template <class Key, class Ptr>
+    using deref_result = decltype(deref_t()(Key(), std::declval<Ptr>()));
+
+    static_assert(std::is_same<deref_result<b, double *>, double &>::value, "");
+    static_assert(std::is_same<deref_result<a, double const *>, double const &>::value, "");
+    static_assert(
+        !is_streamable<double>::value || std::is_same<deref_result<a, double *>, streaming_ref<double>>::value, "");
+
+    // the write only reference: it can't be read
+    static_assert(!std::is_convertible<streaming_ref<double>, double>::value, "");
+
+    template <class T>
+    void test_ref() {
+        T data[2] = {1, 2};
+        streaming_ref<T> testee(data + 1);
+        auto &&res = testee = 3;
+        res = 5;
+        streaming_fence();
+        EXPECT_EQ(data[0], 1);
+        EXPECT_EQ(data[1], 5);
+        streaming_ref<T>(data + 0) = 4;
+        streaming_fence();
+        EXPECT_EQ(data[0], 4);
+    }
+
+    TEST(streaming_ref, float) { test_ref<float>(); }
+    TEST(streaming_ref, double) { test_ref<double>(); }
+    TEST(streaming_ref, int) { test_ref<int>(); }
+} // namespace
@@ -0,0 +1,74 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+#if defined(GT_STENCIL_CPU_KFIRST)
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct sum_functor {
+        using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+        using in = in_accessor<1, extent<0, 1, 0, 0>>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::modify<1, 0>) {
+            eval(out()) = eval(out(0, 0, -1)) + eval(in()) + eval(in(1, 0));
+        }
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::first_level) {
+            eval(out()) = eval(in()) + eval(in(1, 0));
+        }
+    };
+
+    auto in = [](int i, int j, int k) { return i * 1.5 + j * .25 + k * k * .125; };
+
+    template <class Env>
+    void check(typename Env::storage_type const &out) {
+        Env::verify(
+            [](int i, int j, int k) {
+                double res = 0;
+                for (int kk = 0; kk <= k; ++kk)
+                    res += in(i, j, kk) + in(i + 1, j, kk);
+                return res;
+            },
+            out);
+    }
+
+    template <int Distance>
+    using prefetching_backend_t = cpu_kfirst<integral_constant<int_t, 8>,
+        integral_constant<int_t, 8>,
+        thread_pool::omp,
+        integral_constant<int_t, Distance>>;
+
+    TEST(kfirst_prefetch, forward) {
+        using env_t = test_environment<1>::apply<stencil_backend_t, double, inlined_params<13, 9, 20>>;
+        auto out = env_t::make_storage();
+        run_single_stage(sum_functor(), prefetching_backend_t<4>(), env_t::make_grid(), out, env_t::make_storage(in));
+        check<env_t>(out);
+    }
+
+    // the columns are shorter than the prefetch distance: the next columns are prefetched at every level
+    TEST(kfirst_prefetch, short_columns) {
+        using env_t = test_environment<1>::apply<stencil_backend_t, double, inlined_params<13, 9, 3>>;
+        auto out = env_t::make_storage();
+        run_single_stage(sum_functor(), prefetching_backend_t<8>(), env_t::make_grid(), out, env_t::make_storage(in));
+        check<env_t>(out);
+    }
+} // namespace
+#endif
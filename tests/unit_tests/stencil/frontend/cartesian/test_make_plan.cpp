@@ -0,0 +1,93 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct add_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) += eval(in());
+        }
+    };
+
+    struct copy_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using env_t = test_environment<>::apply<stencil_backend_t, double, inlined_params<13, 9, 7>>;
+
+    using make_plan_test = regression_test<env_t>;
+
+    const auto spec = [](auto in, auto out) {
+        GT_DECLARE_TMP(double, tmp);
+        return execute_parallel().stage(copy_functor(), in, tmp).stage(add_functor(), tmp, out);
+    };
+
+    TEST_F(make_plan_test, run_many) {
+        auto in = [](int i, int j, int k) { return i * 100 + j * 10 + k; };
+        auto out = env_t::make_storage(0.);
+        auto plan = make_plan(spec, stencil_backend_t(), env_t::make_grid(), env_t::make_storage(in), out);
+        for (int n = 0; n < 3; ++n)
+            plan();
+        env_t::verify([&](int i, int j, int k) { return 3 * in(i, j, k); }, out);
+    }
+
+    TEST_F(make_plan_test, rebind) {
+        auto in = env_t::make_storage(1.);
+        auto a = env_t::make_storage(0.);
+        auto b = env_t::make_storage(10.);
+        auto plan = make_plan(spec, stencil_backend_t(), env_t::make_grid(), in, a);
+        plan();
+        plan.rebind(in, b);
+        plan();
+        plan();
+        plan.rebind(in, a);
+        plan();
+        env_t::verify(env_t::make_storage(2.), a);
+        env_t::verify(env_t::make_storage(12.), b);
+    }
+
+#if defined(_OPENMP) && (defined(GT_STENCIL_CPU_KFIRST) || defined(GT_STENCIL_CPU_IFIRST))
+    TEST_F(make_plan_test, wider_thread_pool) {
+        int threads = omp_get_max_threads();
+        omp_set_num_threads(1);
+        auto plan =
+            make_plan(spec, stencil_backend_t(), env_t::make_grid(), env_t::make_storage(1.), env_t::make_storage(0.));
+        omp_set_num_threads(2);
+        EXPECT_THROW(plan(), std::runtime_error);
+        omp_set_num_threads(1);
+        EXPECT_NO_THROW(plan());
+        omp_set_num_threads(threads);
+    }
+#endif
+} // namespace
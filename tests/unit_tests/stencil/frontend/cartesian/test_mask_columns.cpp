@@ -0,0 +1,138 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct lap_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = 4 * eval(in()) - (eval(in(1, 0)) + eval(in(0, 1)) + eval(in(-1, 0)) + eval(in(0, -1)));
+        }
+    };
+
+    struct scale_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = 2 * eval(in());
+        }
+    };
+
+    struct sum_functor {
+        using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::modify<1, 0>) {
+            eval(out()) = eval(out(0, 0, -1)) + eval(in());
+        }
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::first_level) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using env_t = test_environment<1>::apply<stencil_backend_t, double, inlined_params<70, 23, 6>>;
+
+    using mask_columns_test = regression_test<env_t>;
+
+    auto in = [](int i, int j, int k) { return i * i * .5 + j * 1.25 - i * j * .125 + k; };
+
+    double lap(int i, int j, int k) {
+        return 4 * in(i, j, k) - (in(i + 1, j, k) + in(i, j + 1, k) + in(i - 1, j, k) + in(i, j - 1, k));
+    }
+
+    // a "coast line": the columns with (i, j) relative to the origin of the grid
+    bool is_sea(int i, int j) { return i + 2 * j < 40; }
+
+    template <class Expected>
+    void verify_sea(Expected &&expected, env_t::storage_type const &out) {
+        auto view = out->const_host_view();
+        for (int i = 0; i < 70; ++i)
+            for (int j = 0; j < 23; ++j)
+                if (is_sea(i, j)) {
+                    for (int k = 0; k < 6; ++k)
+                        EXPECT_DOUBLE_EQ(view(i + 1, j + 1, k), expected(i + 1, j + 1, k)) << i << " " << j;
+                }
+    }
+
+    TEST_F(mask_columns_test, parallel_with_temporary) {
+        auto out = env_t::make_storage(0.);
+        run(
+            [](auto in, auto out) {
+                GT_DECLARE_TMP(double, tmp);
+                return execute_parallel().stage(lap_functor(), tmp, in).stage(scale_functor(), out, tmp);
+            },
+            stencil_backend_t(),
+            mask_columns(env_t::make_grid(), is_sea),
+            env_t::make_storage(in),
+            out);
+        verify_sea([](int i, int j, int k) { return 2 * lap(i, j, k); }, out);
+    }
+
+    TEST_F(mask_columns_test, forward) {
+        auto out = env_t::make_storage(0.);
+        run_single_stage(sum_functor(),
+            stencil_backend_t(),
+            mask_columns(env_t::make_grid(), is_sea),
+            out,
+            env_t::make_storage(in));
+        verify_sea(
+            [](int i, int j, int k) {
+                double res = 0;
+                for (int kk = 0; kk <= k; ++kk)
+                    res += in(i, j, kk);
+                return res;
+            },
+            out);
+    }
+
+    TEST_F(mask_columns_test, batched) {
+        std::vector<env_t::storage_type> ins, outs;
+        for (int m = 0; m < 3; ++m) {
+            ins.push_back(env_t::make_storage([m](int i, int j, int k) { return in(i, j, k) + m; }));
+            outs.push_back(env_t::make_storage(0.));
+        }
+        run_batched([](auto out, auto in) { return execute_parallel().stage(lap_functor(), out, in); },
+            stencil_backend_t(),
+            mask_columns(env_t::make_grid(), is_sea),
+            outs,
+            ins);
+        for (int m = 0; m < 3; ++m)
+            verify_sea([](int i, int j, int k) { return lap(i, j, k); }, outs[m]);
+    }
+
+    TEST(column_mask, active_blocks) {
+        core::column_mask testee(20, 10, [](int i, int j) { return i == 0 || (i == 19 && j == 9); });
+        auto blocks = testee.active_blocks(8, 4);
+        std::vector<std::pair<int_t, int_t>> expected = {{0, 0}, {0, 1}, {0, 2}, {2, 2}};
+        EXPECT_EQ(blocks, expected);
+    }
+} // namespace
@@ -0,0 +1,89 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/bfloat16.hpp>
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    // loses the value if computed in float
+    struct shift_back_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            static_assert(std::is_same<std::decay_t<decltype(eval(in()))>, double>::value, "");
+            auto x = eval(in());
+            auto big = x * 16777216;
+            eval(out()) = x + big - big;
+        }
+    };
+
+    struct sum_functor {
+        using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+        using param_list = make_param_list<out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::modify<1, 0>) {
+            eval(out()) += eval(out(0, 0, -1));
+        }
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&, axis<1>::full_interval::first_level) {}
+    };
+
+    using env_t = test_environment<>::apply<stencil_backend_t, double, inlined_params<13, 9, 7>>;
+
+    using mixed_precision_test = regression_test<env_t>;
+
+    auto in = [](int i, int j, int k) { return i + j * .5 + k * .25; };
+
+    TEST_F(mixed_precision_test, float_storage) {
+        auto src = env_t::builder().storage_type<float>().initializer(in).build();
+        auto dst = env_t::builder().storage_type<float>().value(0).build();
+        run_single_stage(shift_back_functor(), stencil_backend_t(), env_t::make_grid(), src, dst);
+        auto view = dst->const_host_view();
+        for (int i = 0; i < 13; ++i)
+            for (int j = 0; j < 9; ++j)
+                for (int k = 0; k < 7; ++k)
+                    EXPECT_EQ(view(i, j, k), in(i, j, k));
+    }
+
+    TEST_F(mixed_precision_test, mixed_with_plain) {
+        auto src = env_t::make_storage(in);
+        auto dst = env_t::builder().storage_type<bfloat16>().value(0).build();
+        run_single_stage(shift_back_functor(), stencil_backend_t(), env_t::make_grid(), src, dst);
+        run([](auto out) { return execute_forward().stage(sum_functor(), out); },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            dst);
+        auto view = dst->const_host_view();
+        for (int i = 0; i < 13; ++i)
+            for (int j = 0; j < 9; ++j) {
+                // the partial sums are rounded to bfloat16 on every store
+                float sum = 0;
+                for (int k = 0; k < 7; ++k) {
+                    sum = bfloat16(sum + float(bfloat16(in(i, j, k))));
+                    EXPECT_EQ(float(view(i, j, k)), sum);
+                }
+            }
+    }
+} // namespace
@@ -0,0 +1,89 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define GT_PROFILING
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/profiling.hpp>
+#include <gridtools/stencil/cartesian.hpp>
+#include <gridtools/thread_pool/tracing.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using env_t = test_environment<>::apply<stencil_backend_t, double, inlined_params<13, 9, 7>>;
+
+    using profiling_regions_test = regression_test<env_t>;
+
+    TEST_F(profiling_regions_test, run_is_instrumented) {
+        profiling::reset();
+        auto out = env_t::make_storage(0.);
+        {
+            GT_PROFILING_REGION("timestep");
+            run_single_stage(copy_functor(), stencil_backend_t(), env_t::make_grid(), env_t::make_storage(1.), out);
+        }
+        std::ostringstream strm;
+        profiling::report_json(strm);
+        auto res = strm.str();
+        EXPECT_NE(res.find("{\"name\":\"timestep\""), std::string::npos) << res;
+        auto run = res.find("{\"name\":\"run: (anonymous namespace)::copy_functor\"");
+        EXPECT_NE(run, std::string::npos) << res;
+        EXPECT_LT(res.find("{\"name\":\"timestep\""), run) << res;
+#if !defined(GT_STENCIL_GPU) && !defined(GT_STENCIL_GPU_HORIZONTAL)
+        auto stage = res.find("{\"name\":\"stage: (anonymous namespace)::copy_functor\"");
+        EXPECT_NE(stage, std::string::npos) << res;
+        EXPECT_LT(run, stage) << res;
+        EXPECT_EQ(res.find("{\"name\":\"stage: (anonymous namespace)::copy_functor\"", stage + 1), std::string::npos)
+            << res;
+#endif
+        env_t::verify(1., out);
+    }
+
+#if defined(GT_STENCIL_CPU_KFIRST) || defined(GT_STENCIL_CPU_IFIRST)
+    using tracing_t = thread_pool::tracing<thread_pool::omp>;
+#if defined(GT_STENCIL_CPU_KFIRST)
+    using traced_backend_t = cpu_kfirst<integral_constant<int_t, 8>, integral_constant<int_t, 8>, tracing_t>;
+#else
+    using traced_backend_t = cpu_ifirst<tracing_t>;
+#endif
+
+    TEST_F(profiling_regions_test, stages_are_traced) {
+        tracing_t::clear();
+        auto out = env_t::make_storage(0.);
+        run_single_stage(copy_functor(), traced_backend_t(), env_t::make_grid(), env_t::make_storage(1.), out);
+        std::ostringstream strm;
+        tracing_t::dump(strm);
+        auto res = strm.str();
+        EXPECT_NE(res.find("\"name\":\"block\""), std::string::npos) << res;
+        EXPECT_NE(res.find("\"name\":\"stage: (anonymous namespace)::copy_functor\""), std::string::npos) << res;
+        env_t::verify(1., out);
+    }
+#endif
+} // namespace
@@ -0,0 +1,141 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using env_t = test_environment<>::apply<stencil_backend_t, double, inlined_params<13, 9, 7>>;
+
+    using run_async_test = regression_test<env_t>;
+
+    const auto spec = [](auto in, auto out) { return execute_parallel().stage(copy_functor(), in, out); };
+
+    TEST_F(run_async_test, copy) {
+        auto in = [](int i, int j, int k) { return i * 100 + j * 10 + k; };
+        auto out = env_t::make_storage(0.);
+        auto handle = run_async(spec, stencil_backend_t(), env_t::make_grid(), env_t::make_storage(in), out);
+        EXPECT_TRUE(handle.valid());
+        handle.wait();
+        EXPECT_FALSE(handle.valid());
+        EXPECT_TRUE(handle.ready());
+        env_t::verify(in, out);
+    }
+
+    TEST_F(run_async_test, independent_runs) {
+        auto in = env_t::make_storage(1.);
+        auto a = env_t::make_storage(0.);
+        auto b = env_t::make_storage(0.);
+        {
+            auto first = run_async(spec, stencil_backend_t(), env_t::make_grid(), in, a);
+            auto second = run_async(spec, stencil_backend_t(), env_t::make_grid(), in, b);
+        }
+        env_t::verify(in, a);
+        env_t::verify(in, b);
+    }
+
+    TEST_F(run_async_test, partition) {
+        auto in = [](int i, int j, int k) { return i + j + k; };
+        auto out = env_t::make_storage(0.);
+        auto handle = run_async(
+            thread_pool::partition(2), spec, stencil_backend_t(), env_t::make_grid(), env_t::make_storage(in), out);
+        handle.wait();
+        env_t::verify(in, out);
+    }
+
+    TEST_F(run_async_test, self_move_assignment) {
+        auto in = env_t::make_storage(1.);
+        auto out = env_t::make_storage(0.);
+        auto handle = run_async(spec, stencil_backend_t(), env_t::make_grid(), in, out);
+        auto &alias = handle;
+        handle = std::move(alias);
+        EXPECT_TRUE(handle.valid());
+        handle.wait();
+        env_t::verify(in, out);
+    }
+
+    TEST(run_async_workers, threads_are_reused) {
+        auto &workers = frontend_impl_::async_workers::get();
+        std::thread::id id;
+        workers.submit([&] { id = std::this_thread::get_id(); }).wait();
+        EXPECT_NE(id, std::this_thread::get_id());
+        auto threads = workers.threads();
+        for (int i = 0; i != 10; ++i)
+            workers.submit([] {}).wait();
+        EXPECT_EQ(workers.threads(), threads);
+    }
+
+#if !defined(GT_STENCIL_GPU) && !defined(GT_STENCIL_GPU_HORIZONTAL)
+    std::atomic<bool> released(false);
+
+    // keeps the computation in flight until `released` is set
+    struct blocking_copy_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        static void apply(Eval &&eval) {
+            while (!released)
+                ;
+            eval(out()) = eval(in());
+        }
+    };
+
+    TEST_F(run_async_test, hazards) {
+        auto in = env_t::make_storage(1.);
+        auto out = env_t::make_storage(0.);
+        auto other = env_t::make_storage(0.);
+        auto blocking_spec = [](auto in, auto out) {
+            return execute_parallel().stage(blocking_copy_functor(), in, out);
+        };
+        released = false;
+        auto handle = run_async(blocking_spec, stencil_backend_t(), env_t::make_grid(), in, out);
+        // write after write
+        EXPECT_THROW(run_async(spec, stencil_backend_t(), env_t::make_grid(), in, out), std::runtime_error);
+        // read after write
+        EXPECT_THROW(run_async(spec, stencil_backend_t(), env_t::make_grid(), out, other), std::runtime_error);
+        // write after read
+        EXPECT_THROW(run_async(spec, stencil_backend_t(), env_t::make_grid(), other, in), std::runtime_error);
+        // read after read
+        auto reader = run_async(spec, stencil_backend_t(), env_t::make_grid(), in, other);
+        reader.wait();
+        released = true;
+        handle.wait();
+        env_t::verify(in, out);
+        env_t::verify(in, other);
+        // the fields are released with the completion
+        run_async(spec, stencil_backend_t(), env_t::make_grid(), out, in).wait();
+    }
+#endif
+} // namespace
@@ -0,0 +1,116 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    struct scale_functor {
+        using in = in_accessor<0>;
+        using factor = in_accessor<1>;
+        using out = inout_accessor<2>;
+        using param_list = make_param_list<in, factor, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(factor()) * eval(in());
+        }
+    };
+
+    struct sum_functor {
+        using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+        using param_list = make_param_list<out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::modify<1, 0>) {
+            eval(out()) += eval(out(0, 0, -1));
+        }
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&, axis<1>::full_interval::first_level) {}
+    };
+
+    using env_t = test_environment<>::apply<stencil_backend_t, double, inlined_params<13, 9, 7>>;
+
+    using run_batched_test = regression_test<env_t>;
+
+    TEST_F(run_batched_test, parallel_with_temporary) {
+        auto in = [](int m) { return [m](int i, int j, int k) { return m * 1000 + i * 100 + j * 10 + k; }; };
+        std::vector<env_t::storage_type> ins, outs;
+        for (int m = 0; m < 5; ++m) {
+            ins.push_back(env_t::make_storage(in(m)));
+            outs.push_back(env_t::make_storage(0.));
+        }
+        auto factor = env_t::make_storage(3.);
+        run_batched(
+            [](auto in, auto factor, auto out) {
+                GT_DECLARE_TMP(double, tmp);
+                return execute_parallel().stage(copy_functor(), in, tmp).stage(scale_functor(), tmp, factor, out);
+            },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            ins,
+            factor,
+            outs);
+        for (int m = 0; m < 5; ++m)
+            env_t::verify([&](int i, int j, int k) { return 3 * in(m)(i, j, k); }, outs[m]);
+    }
+
+    TEST_F(run_batched_test, forward) {
+        std::vector<env_t::storage_type> fields;
+        for (int m = 0; m < 3; ++m)
+            fields.push_back(env_t::make_storage(m + 1.));
+        run_batched([](auto out) { return execute_forward().stage(sum_functor(), out); },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            fields);
+        for (int m = 0; m < 3; ++m)
+            env_t::verify([&](int, int, int k) { return (m + 1.) * (k + 1); }, fields[m]);
+    }
+
+    TEST_F(run_batched_test, no_members) {
+        std::vector<env_t::storage_type> fields;
+        run_batched([](auto out) { return execute_forward().stage(sum_functor(), out); },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            fields);
+    }
+
+    TEST_F(run_batched_test, mismatched_members) {
+        std::vector<env_t::storage_type> ins(2, env_t::make_storage(1.)), outs(3, env_t::make_storage(0.));
+        EXPECT_THROW(run_batched([](auto in, auto out) { return execute_parallel().stage(copy_functor(), in, out); },
+                         stencil_backend_t(),
+                         env_t::make_grid(),
+                         ins,
+                         outs),
+            std::invalid_argument);
+    }
+} // namespace
@@ -0,0 +1,66 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+#include <gridtools/stencil/global_parameter.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+    using namespace expressions;
+
+    struct lap_plus {
+        using in = in_accessor<0, extent<-1, 1, -1, 1>>;
+        using weight = in_accessor<1>;
+        using out = inout_accessor<2>;
+        using param_list = make_param_list<in, weight, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(weight() * (in(1, 0) + in(-1, 0) + in(0, 1) + in(0, -1) - 4 * in()));
+        }
+    };
+
+    using env_t = test_environment<1>::apply<stencil_backend_t, double, inlined_params<12, 10, 5>>;
+
+    using runtime_expand_test = regression_test<env_t>;
+
+    TEST_F(runtime_expand_test, four_dimensional_fields) {
+        const int n = 6;
+        auto builder = storage::builder<env_t::storage_traits_t>.type<double>().halos(1, 1, 0, 0).dimensions(
+            env_t::d(0), env_t::d(1), env_t::d(2), n);
+        auto in_f = [](int i, int j, int k, int c) { return i * i + 3 * j * j + k + 10 * c; };
+        auto in = builder.initializer(in_f).build();
+        auto out = builder.value(-1.).build();
+        auto weight = env_t::make_storage([](int i, int j, int k) { return i + j + k; });
+        run([](auto in, auto weight, auto out,
+                auto n) { return execute_parallel().stage(runtime_expand<lap_plus, 0, 2>(), in, weight, out, n); },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            in,
+            weight,
+            out,
+            make_global_parameter(n - 1));
+        auto view = out->const_host_view();
+        for (int i = 1; i < env_t::d(0) - 1; ++i)
+            for (int j = 1; j < env_t::d(1) - 1; ++j)
+                for (int k = 0; k < env_t::d(2); ++k) {
+                    for (int c = 0; c < n - 1; ++c)
+                        EXPECT_DOUBLE_EQ(view(i, j, k, c), (i + j + k) * 8.) << i << " " << j << " " << k << " " << c;
+                    EXPECT_DOUBLE_EQ(view(i, j, k, n - 1), -1.);
+                }
+    }
+} // namespace
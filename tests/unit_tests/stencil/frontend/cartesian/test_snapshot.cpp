@@ -0,0 +1,82 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+#include <gridtools/storage/snapshot.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using env_t = test_environment<>::apply<stencil_backend_t, double, inlined_params<12, 13, 5>>;
+
+    using snapshot_test = regression_test<env_t>;
+
+    auto in = [](int i, int j, int k) { return i + 100 * j + 10000 * k; };
+
+    // counts the blocks of the snapshot that are saved, i.e. not taken from the live buffer
+    template <class DataStore, class Snapshot>
+    int saved_blocks(DataStore const &ds, Snapshot const &snapshot) {
+        auto live = ds->get_const_host_ptr();
+        int res = 0;
+        snapshot.for_each_block([&](size_t offset, double const *ptr, size_t) { res += ptr != live + offset; });
+        return res;
+    }
+
+    TEST_F(snapshot_test, read_only_run) {
+        auto src = env_t::make_storage(in);
+        auto dst = env_t::make_storage(-1.);
+        auto src_snapshot = storage::snapshot(src);
+        auto dst_snapshot = storage::snapshot(dst);
+        run([](auto out, auto in) { return execute_parallel().stage(copy_functor(), out, in); },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            dst,
+            src);
+        env_t::verify(in, dst);
+        EXPECT_EQ(saved_blocks(src, src_snapshot), 0);
+        EXPECT_NE(saved_blocks(dst, dst_snapshot), 0);
+        EXPECT_EQ(dst_snapshot(1, 2, 3), -1);
+    }
+
+    TEST_F(snapshot_test, plan_created_before_snapshot) {
+        auto src = env_t::make_storage(in);
+        auto dst = env_t::make_storage(-1.);
+        auto plan = make_plan([](auto out, auto in) { return execute_parallel().stage(copy_functor(), out, in); },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            dst,
+            src);
+        auto src_snapshot = storage::snapshot(src);
+        auto dst_snapshot = storage::snapshot(dst);
+        plan();
+        env_t::verify(in, dst);
+        EXPECT_EQ(saved_blocks(src, src_snapshot), 0);
+        EXPECT_EQ(dst_snapshot(1, 2, 3), -1);
+    }
+} // namespace
@@ -0,0 +1,125 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+        using write_only = meta::list<out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    // reads the output back, so it can't declare it write only
+    struct accumulate_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            auto &&res = eval(out()) = 0;
+            res += eval(in());
+            res *= 2;
+        }
+    };
+
+    struct lap_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = 4 * eval(in()) - (eval(in(1, 0)) + eval(in(0, 1)) + eval(in(-1, 0)) + eval(in(0, -1)));
+        }
+    };
+
+    struct sum_functor {
+        using out = inout_accessor<0, extent<0, 0, 0, 0, -1, 0>>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::modify<1, 0>) {
+            eval(out()) = eval(out(0, 0, -1)) + eval(in());
+        }
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<1>::full_interval::first_level) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using env_t = test_environment<1>::apply<stencil_backend_t, double, inlined_params<67, 13, 5>>;
+
+    using streaming_stores_test = regression_test<env_t>;
+
+    auto in = [](int i, int j, int k) { return i * i * .5 + j * 1.25 - i * j * .125 + k; };
+
+    double lap(int i, int j, int k) {
+        return 4 * in(i, j, k) - (in(i + 1, j, k) + in(i, j + 1, k) + in(i - 1, j, k) + in(i, j - 1, k));
+    }
+
+    TEST_F(streaming_stores_test, write_only_outputs) {
+        auto copy = env_t::make_storage(-1.);
+        auto accumulated = env_t::make_storage(-1.);
+        auto copy_spec = [](auto copy, auto accumulated, auto in) {
+            return execute_parallel().stage(copy_functor(), copy, in).stage(accumulate_functor(), accumulated, in);
+        };
+        for (int i = 0; i < 2; ++i)
+            run(copy_spec, stencil_backend_t(), env_t::make_grid(), copy, accumulated, env_t::make_storage(in));
+        env_t::verify(in, copy);
+        env_t::verify([](int i, int j, int k) { return 2 * in(i, j, k); }, accumulated);
+    }
+
+    // `tmp` is declared write only by the first stage but is read by the second one, `sum` is read by itself with the k
+    // offset: neither is written with the streaming stores
+    TEST_F(streaming_stores_test, read_after_write) {
+        auto tmp = env_t::make_storage(-1.);
+        auto sum = env_t::make_storage(-1.);
+        auto lapl = env_t::make_storage(-1.);
+        run(
+            [](auto in, auto tmp, auto lapl, auto sum) {
+                return multi_pass(execute_parallel().stage(copy_functor(), tmp, in).stage(lap_functor(), lapl, tmp),
+                    execute_forward().stage(sum_functor(), sum, tmp));
+            },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            env_t::make_storage(in),
+            tmp,
+            lapl,
+            sum);
+        env_t::verify(in, tmp);
+        env_t::verify(lap, lapl);
+        env_t::verify(
+            [](int i, int j, int k) {
+                double res = 0;
+                for (int kk = 0; kk <= k; ++kk)
+                    res += in(i, j, kk);
+                return res;
+            },
+            sum);
+    }
+} // namespace
@@ -0,0 +1,215 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct lap_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = 4 * eval(in()) - (eval(in(1, 0)) + eval(in(0, 1)) + eval(in(-1, 0)) + eval(in(0, -1)));
+        }
+    };
+
+    struct flx_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1, extent<0, 1, 0, 0>>;
+        using lap = in_accessor<2, extent<0, 1, 0, 0>>;
+        using param_list = make_param_list<out, in, lap>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = (eval(lap(1, 0)) - eval(lap())) * (eval(in(1, 0)) - eval(in()));
+        }
+    };
+
+    struct out_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using flx = in_accessor<2, extent<-1, 0, 0, 0>>;
+        using param_list = make_param_list<out, in, flx>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in()) - (eval(flx()) - eval(flx(-1, 0)));
+        }
+    };
+
+    using env_t = test_environment<2>::apply<stencil_backend_t, double, inlined_params<12, 11, 5>>;
+
+    using tmp_policy_test = regression_test<env_t>;
+
+    auto in = [](int i, int j, int k) { return i * i * .5 + j * 1.25 - i * j * .125 + k; };
+
+    double lap(int i, int j, int k) {
+        return 4 * in(i, j, k) - (in(i + 1, j, k) + in(i, j + 1, k) + in(i - 1, j, k) + in(i, j - 1, k));
+    }
+
+    double flx(int i, int j, int k) {
+        return (lap(i + 1, j, k) - lap(i, j, k)) * (in(i + 1, j, k) - in(i, j, k));
+    }
+
+    auto expected = [](int i, int j, int k) { return in(i, j, k) - (flx(i, j, k) - flx(i - 1, j, k)); };
+
+    template <class Policy>
+    void run_diffusion() {
+        auto out = env_t::make_storage();
+        run(
+            [](auto in, auto out) {
+                GT_DECLARE_TMP_WITH_POLICY(double, Policy, lap, flx);
+                return execute_parallel()
+                    .ij_cached(lap, flx)
+                    .stage(lap_functor(), lap, in)
+                    .stage(flx_functor(), flx, in, lap)
+                    .stage(out_functor(), out, in, flx);
+            },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            env_t::make_storage(in),
+            out);
+        env_t::verify(expected, out);
+    }
+
+    TEST_F(tmp_policy_test, materialize) { run_diffusion<tmp_policy::materialize>(); }
+
+    TEST_F(tmp_policy_test, store_as) { run_diffusion<tmp_policy::store_as<double>>(); }
+
+    TEST_F(tmp_policy_test, recompute) { run_diffusion<tmp_policy::recompute>(); }
+
+    TEST_F(tmp_policy_test, recompute_one) {
+        auto out = env_t::make_storage();
+        run(
+            [](auto in, auto out) {
+                GT_DECLARE_TMP(double, lap);
+                GT_DECLARE_TMP_WITH_POLICY(double, tmp_policy::recompute, flx);
+                return multi_pass(execute_parallel().stage(lap_functor(), lap, in),
+                    execute_parallel().stage(flx_functor(), flx, in, lap).stage(out_functor(), out, in, flx));
+            },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            env_t::make_storage(in),
+            out);
+        env_t::verify(expected, out);
+    }
+
+    struct third_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in()) / 3;
+        }
+    };
+
+    struct triple_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in()) * 3;
+        }
+    };
+
+    TEST_F(tmp_policy_test, reduced_precision) {
+        auto out = env_t::make_storage();
+        run(
+            [](auto in, auto out) {
+                GT_DECLARE_TMP_WITH_POLICY(double, tmp_policy::store_as<float>, tmp);
+                return execute_parallel().stage(third_functor(), tmp, in).stage(triple_functor(), out, tmp);
+            },
+            stencil_backend_t(),
+            env_t::make_grid(),
+            env_t::make_storage(in),
+            out);
+        env_t::verify([](int i, int j, int k) { return double(float(in(i, j, k) / 3)) * 3; }, out);
+    }
+
+    struct interval_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<2>::get_interval<0>) {
+            eval(out()) = eval(in());
+        }
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<2>::get_interval<1>) {
+            eval(out()) = 2 * eval(in());
+        }
+    };
+
+    struct shift_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1, extent<0, 0, 0, 0, -1, 0>>;
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<2>::full_interval::modify<1, 0>) {
+            eval(out()) = eval(in(0, 0, -1)) + eval(in());
+        }
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, axis<2>::full_interval::first_level) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    using env2_t = test_environment<0, axis<2>>::apply<stencil_backend_t, double, inlined_params<5, 6, 3, 4>>;
+
+    using tmp_policy_intervals_test = regression_test<env2_t>;
+
+    TEST_F(tmp_policy_intervals_test, recompute) {
+        auto in = [](int i, int j, int k) { return i * 100 + j * 10 + k; };
+        auto out = env2_t::make_storage();
+        run(
+            [](auto in, auto out) {
+                GT_DECLARE_TMP_WITH_POLICY(double, tmp_policy::recompute, tmp);
+                return execute_parallel().stage(interval_functor(), tmp, in).stage(interval_functor(), out, tmp);
+            },
+            stencil_backend_t(),
+            env2_t::make_grid(),
+            env2_t::make_storage(in),
+            out);
+        env2_t::verify([&](int i, int j, int k) { return in(i, j, k) * (k < 3 ? 1 : 4); }, out);
+    }
+
+    TEST_F(tmp_policy_intervals_test, recompute_at_vertical_offset) {
+        auto in = [](int i, int j, int k) { return i * 100 + j * 10 + k; };
+        auto out = env2_t::make_storage();
+        run(
+            [](auto in, auto out) {
+                GT_DECLARE_TMP_WITH_POLICY(double, tmp_policy::recompute, tmp);
+                return execute_parallel().stage(third_functor(), tmp, in).stage(shift_functor(), out, tmp);
+            },
+            stencil_backend_t(),
+            env2_t::make_grid(),
+            env2_t::make_storage(in),
+            out);
+        env2_t::verify(
+            [&](int i, int j, int k) { return (k ? in(i, j, k - 1) / 3. : 0.) + in(i, j, k) / 3.; }, out);
+    }
+} // namespace
@@ -0,0 +1,116 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/frontend/icosahedral/neighbor_chain.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/for_each.hpp>
+#include <gridtools/common/tuple_util.hpp>
+
+namespace gridtools {
+    namespace stencil {
+        namespace icosahedral {
+            namespace {
+                const int_t n = 8;
+
+                static_assert(sizeof(neighbor_offset) == 3, "");
+                static_assert(sizeof(neighbor_table_row<6>) == 19, "");
+
+                template <class From, class To, size_t N>
+                neighbor_table structured() {
+                    return {
+                        n, n, From::value, [](int_t, int_t, int_t c) { return make_structured_row<From, To, N>(c); }};
+                }
+
+                connectivity make_connectivity(int_t padding = 1) {
+                    connectivity res(padding);
+                    res.set<topo::vertex::edge>(structured<vertices, edges, 6>());
+                    res.set<topo::edge::vertex>(structured<edges, vertices, 2>());
+                    return res;
+                }
+
+                std::vector<neighbor_offset> row(neighbor_table const &table, int_t i, int_t j, int_t c) {
+                    return {table.begin(i, j, c), table.end(i, j, c)};
+                }
+
+                TEST(neighbor_chain, links) {
+                    auto testee = structured<vertices, edges, 6>();
+                    EXPECT_EQ(testee.width(), 6);
+                    EXPECT_EQ(testee.size(3, 3, 0), 6);
+                    auto r = testee.row<6>(3, 3, 0);
+                    EXPECT_EQ(r.size, 6);
+                    EXPECT_EQ(r.offsets[1].i, -1);
+                    EXPECT_EQ(r.offsets[1].c, 0);
+                }
+
+                TEST(neighbor_chain, vertex_to_vertex) {
+                    auto conn = make_connectivity();
+                    auto const &testee = conn.get<topo::vertex::edge::vertex>();
+                    EXPECT_EQ(testee.width(), 7);
+                    auto actual = row(testee, 3, 3, 0);
+                    std::vector<neighbor_offset> expected = {{0, 0, 0}};
+                    for_each<neighbor_offsets<vertices, vertices, 0>>([&](auto offset) {
+                        expected.push_back(
+                            {tuple_util::get<0>(offset), tuple_util::get<1>(offset), tuple_util::get<3>(offset)});
+                    });
+                    ASSERT_EQ(actual.size(), expected.size());
+                    for (auto &&item : expected)
+                        EXPECT_NE(std::find(actual.begin(), actual.end(), item), actual.end());
+
+                    // the neighbors outside of the domain are dropped
+                    EXPECT_LT(testee.size(0, 0, 0), 7);
+                }
+
+                TEST(neighbor_chain, padding) {
+                    auto conn = make_connectivity(4);
+                    EXPECT_EQ(conn.get<topo::vertex::edge::vertex>().width(), 8);
+                    EXPECT_EQ(conn.get<topo::vertex::edge::vertex>().size(3, 3, 0), 7);
+                }
+
+                TEST(neighbor_chain, prefixes_are_cached) {
+                    auto conn = make_connectivity();
+                    EXPECT_FALSE((conn.contains<topo::vertex::edge::vertex>()));
+                    auto const &testee = conn.get<topo::vertex::edge::vertex::edge::vertex>();
+                    EXPECT_TRUE((conn.contains<topo::vertex::edge::vertex>()));
+                    EXPECT_TRUE((conn.contains<topo::vertex::edge::vertex::edge>()));
+                    // the vertices within two rings
+                    EXPECT_EQ(testee.size(4, 4, 0), 19);
+                    auto actual = row(testee, 4, 4, 0);
+                    for (auto it = actual.begin(); it != actual.end(); ++it)
+                        EXPECT_EQ(std::find(it + 1, actual.end(), *it), actual.end());
+                }
+
+                TEST(neighbor_chain, reset_link) {
+                    auto conn = make_connectivity();
+                    EXPECT_EQ(conn.get<topo::vertex::edge::vertex>().size(3, 3, 0), 7);
+                    // only the first edge of each vertex
+                    conn.set<topo::vertex::edge>({n, n, vertices::value, [](int_t, int_t, int_t c) {
+                                                      auto res = make_structured_row<vertices, edges, 6>(c);
+                                                      res.size = 1;
+                                                      return res;
+                                                  }});
+                    EXPECT_FALSE((conn.contains<topo::vertex::edge::vertex>()));
+                    EXPECT_EQ(conn.get<topo::vertex::edge::vertex>().size(3, 3, 0), 2);
+                    EXPECT_TRUE((conn.contains<topo::edge::vertex>()));
+                }
+
+                TEST(neighbor_chain, missing_link) {
+                    auto conn = make_connectivity();
+                    EXPECT_THROW(conn.get<topo::cell::edge::cell>(), std::runtime_error);
+                }
+            } // namespace
+        }     // namespace icosahedral
+    }         // namespace stencil
+} // namespace gridtools
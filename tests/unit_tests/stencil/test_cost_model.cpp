@@ -0,0 +1,122 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/cost_model.hpp>
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+namespace gridtools {
+    namespace stencil {
+        namespace {
+            using namespace cartesian;
+            using nlohmann::json;
+
+            struct lap {
+                using out = inout_accessor<0>;
+                using in = in_accessor<1, extent<-1, 1, -1, 1>>;
+                using param_list = make_param_list<out, in>;
+
+                static constexpr int flops = 5;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = 4 * eval(in()) - eval(in(1, 0)) - eval(in(-1, 0)) - eval(in(0, 1)) - eval(in(0, -1));
+                }
+            };
+
+            struct copy {
+                using out = inout_accessor<0>;
+                using in = in_accessor<1>;
+                using param_list = make_param_list<out, in>;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = eval(in());
+                }
+            };
+
+            auto const spec = [](auto in, auto out) {
+                GT_DECLARE_TMP(double, tmp);
+                return execute_parallel().ij_cached(tmp).stage(copy(), tmp, in).stage(lap(), out, tmp);
+            };
+
+            json model(int_t block_i = 0, int_t block_j = 0, size_t cache_size = 1 << 20, bool materialize = false) {
+                double fake[12][10][4];
+                halo_descriptor hd_i(1, 1, 1, 10, 12);
+                halo_descriptor hd_j(1, 1, 1, 8, 10);
+                std::ostringstream strm;
+                run(spec,
+                    cost_model{strm, block_i, block_j, cache_size, materialize},
+                    make_grid(hd_i, hd_j, 4),
+                    fake,
+                    fake);
+                return json::parse(strm.str());
+            }
+
+            TEST(cost_model, unblocked) {
+                auto res = model();
+                EXPECT_EQ(res["domain"]["i"], 10);
+                EXPECT_EQ(res["domain"]["j"], 8);
+                EXPECT_EQ(res["domain"]["k"], 4);
+                EXPECT_EQ(res["blocks"], 1);
+                ASSERT_EQ(res["kernels"].size(), 1u);
+                auto const &kernel = res["kernels"][0];
+                ASSERT_EQ(kernel["stages"].size(), 2u);
+                auto const &copy_stage = kernel["stages"][0];
+                auto const &lap_stage = kernel["stages"][1];
+                EXPECT_EQ(copy_stage["points"], 12 * 10 * 4);
+                EXPECT_EQ(copy_stage["redundant_points"], 0);
+                EXPECT_EQ(copy_stage["bytes_read"], 12 * 10 * 4 * sizeof(double));
+                EXPECT_EQ(copy_stage["bytes_written"], 0);
+                EXPECT_FALSE(copy_stage.contains("flops"));
+                EXPECT_EQ(lap_stage["points"], 10 * 8 * 4);
+                // write-allocate of `out`
+                EXPECT_EQ(lap_stage["bytes_read"], 10 * 8 * 4 * sizeof(double));
+                EXPECT_EQ(lap_stage["bytes_written"], 10 * 8 * 4 * sizeof(double));
+                EXPECT_EQ(lap_stage["flops"], 5 * 10 * 8 * 4);
+                EXPECT_TRUE(kernel["temporaries"].empty());
+                EXPECT_EQ(res["total"]["bytes_read"], (12 * 10 + 10 * 8) * 4 * sizeof(double));
+            }
+
+            TEST(cost_model, blocked) {
+                auto res = model(5, 4);
+                EXPECT_EQ(res["blocks"], 4);
+                auto const &copy_stage = res["kernels"][0]["stages"][0];
+                EXPECT_EQ(copy_stage["points"], (10 + 2 * 2) * (8 + 2 * 2) * 4);
+                EXPECT_EQ(copy_stage["redundant_points"], (14 * 12 - 12 * 10) * 4);
+                EXPECT_EQ(res["kernels"][0]["working_set_per_block"], (2 * 7 * 6 + 5 * 4) * sizeof(double));
+                EXPECT_FALSE(res["kernels"][0]["exceeds_cache"]);
+            }
+
+            TEST(cost_model, materialized_caches) {
+                auto res = model(0, 0, 64, true);
+                auto const &kernel = res["kernels"][0];
+                EXPECT_EQ(kernel["stages"][0]["bytes_read"], 2 * 12 * 10 * 4 * sizeof(double));
+                EXPECT_EQ(kernel["stages"][0]["bytes_written"], 12 * 10 * 4 * sizeof(double));
+                EXPECT_EQ(kernel["stages"][1]["bytes_read"], (12 * 10 + 10 * 8) * 4 * sizeof(double));
+                ASSERT_EQ(kernel["temporaries"].size(), 1u);
+                EXPECT_EQ(kernel["temporaries"][0]["bytes"], 12 * 10 * 4 * sizeof(double));
+                EXPECT_TRUE(kernel["exceeds_cache"]);
+            }
+
+            TEST(cost_model, redundant_points_are_written_once) {
+                auto res = model(5, 4, 1 << 20, true);
+                auto const &copy_stage = res["kernels"][0]["stages"][0];
+                EXPECT_EQ(copy_stage["points"], (10 + 2 * 2) * (8 + 2 * 2) * 4);
+                EXPECT_EQ(copy_stage["bytes_written"], 12 * 10 * 4 * sizeof(double));
+            }
+        } // namespace
+    }     // namespace stencil
+} // namespace gridtools
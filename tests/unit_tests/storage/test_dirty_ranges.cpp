@@ -0,0 +1,195 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/integral_constant.hpp>
+#include <gridtools/common/layout_map.hpp>
+#include <gridtools/storage/builder.hpp>
+
+namespace gridtools {
+    namespace {
+        std::vector<std::pair<std::ptrdiff_t, size_t>> copies;
+
+        // the traits of the storage in the separate address space that is emulated on the host
+        struct separate_space {
+            friend std::false_type storage_is_host_referenceable(separate_space) { return {}; }
+
+            friend layout_map<2, 1, 0> storage_layout(separate_space, std::integral_constant<size_t, 3>) { return {}; }
+
+            friend integral_constant<size_t, 32> storage_alignment(separate_space) { return {}; }
+
+            template <class LazyType, class T = typename LazyType::type>
+            friend auto storage_allocate(separate_space, LazyType, size_t size) {
+                return std::make_unique<T[]>(size);
+            }
+
+            template <class T>
+            friend void storage_update_target(separate_space, T *dst, T const *src, size_t size) {
+                copies.emplace_back(-1, size);
+                std::copy(src, src + size, dst);
+            }
+
+            template <class T>
+            friend void storage_update_host(separate_space, T *dst, T const *src, size_t size) {
+                copies.emplace_back(1, size);
+                std::copy(src, src + size, dst);
+            }
+
+            template <class T, class Info>
+            friend auto storage_make_target_view(separate_space, T *ptr, Info const &info) {
+                return storage::make_host_view(ptr, info);
+            }
+        };
+
+        // the traits that synchronize the batches of the ranges with the single strided copy
+        struct strided_space : separate_space {
+            template <class T>
+            friend void storage_update_target_strided(
+                strided_space, T *dst, T const *src, size_t width, size_t count, size_t pitch) {
+                copies.emplace_back(-1, width * count);
+                for (size_t i = 0; i != count; ++i)
+                    std::copy(src + i * pitch, src + i * pitch + width, dst + i * pitch);
+            }
+        };
+
+        size_t copied_to_target() {
+            size_t res = 0;
+            for (auto &&copy : copies)
+                if (copy.first < 0)
+                    res += copy.second;
+            return res;
+        }
+
+        const auto builder = storage::builder<separate_space>.type<double>().dimensions(10, 7, 5).value(0);
+
+        struct dirty_ranges_test : testing::Test {
+            dirty_ranges_test() { copies.clear(); }
+        };
+
+        TEST_F(dirty_ranges_test, full_update) {
+            auto testee = builder();
+            testee->const_target_view();
+            copies.clear();
+            testee->host_view()(1, 2, 3) = 1;
+            auto view = testee->const_target_view();
+            EXPECT_EQ(copied_to_target(), (size_t)testee->info().length());
+            EXPECT_EQ(view(1, 2, 3), 1);
+        }
+
+        TEST_F(dirty_ranges_test, k_level) {
+            auto testee = builder();
+            testee->const_target_view();
+            copies.clear();
+            auto host = testee->host_view({0, 0, 3}, {10, 7, 4});
+            for (int i = 0; i < 10; ++i)
+                for (int j = 0; j < 7; ++j)
+                    host(i, j, 3) = i + j;
+            auto view = testee->const_target_view();
+            // the k level is a single contiguous slab in the k-outermost layout
+            ASSERT_EQ(copies.size(), 1);
+            EXPECT_EQ(copied_to_target(), (size_t)testee->strides()[2]);
+            for (int i = 0; i < 10; ++i)
+                for (int j = 0; j < 7; ++j)
+                    for (int k = 0; k < 5; ++k)
+                        EXPECT_EQ(view(i, j, k), k == 3 ? i + j : 0);
+        }
+
+        TEST_F(dirty_ranges_test, halo) {
+            auto testee = builder();
+            testee->const_target_view();
+            copies.clear();
+            testee->host_view({0, 0, 0}, {1, 7, 5})(0, 6, 4) = 1;
+            testee->host_view({9, 0, 0}, {10, 7, 5})(9, 6, 4) = 2;
+            auto view = testee->const_target_view();
+            // one element per row
+            EXPECT_EQ(copied_to_target(), 2 * 7 * 5);
+            EXPECT_EQ(view(0, 6, 4), 1);
+            EXPECT_EQ(view(9, 6, 4), 2);
+        }
+
+        TEST_F(dirty_ranges_test, strided_halo) {
+            auto testee = storage::builder<strided_space>.type<double>().dimensions(10, 7, 5).value(0)();
+            testee->const_target_view();
+            copies.clear();
+            testee->host_view({0, 0, 0}, {1, 7, 5})(0, 6, 4) = 1;
+            testee->host_view({9, 0, 0}, {10, 7, 5})(9, 6, 4) = 2;
+            auto view = testee->const_target_view();
+            // one strided copy per side
+            EXPECT_EQ(copies.size(), 2);
+            EXPECT_EQ(copied_to_target(), 2 * 7 * 5);
+            EXPECT_EQ(view(0, 6, 4), 1);
+            EXPECT_EQ(view(9, 6, 4), 2);
+        }
+
+        TEST_F(dirty_ranges_test, merged) {
+            auto testee = builder();
+            testee->const_target_view();
+            copies.clear();
+            testee->host_view({0, 0, 1}, {10, 7, 2});
+            testee->host_view({0, 0, 2}, {10, 7, 3});
+            testee->const_target_view();
+            ASSERT_EQ(copies.size(), 1);
+            EXPECT_EQ(copied_to_target(), (size_t)testee->strides()[2] * 2);
+        }
+
+        TEST_F(dirty_ranges_test, full_after_partial) {
+            auto testee = builder();
+            testee->const_target_view();
+            copies.clear();
+            testee->host_view({0, 0, 1}, {10, 7, 2});
+            testee->host_view();
+            testee->const_target_view();
+            EXPECT_EQ(copied_to_target(), (size_t)testee->info().length());
+        }
+
+        TEST_F(dirty_ranges_test, target_write) {
+            auto testee = builder();
+            testee->target_view()(1, 2, 3) = 5;
+            EXPECT_EQ(testee->host_view({0, 0, 0}, {1, 1, 1})(1, 2, 3), 5);
+            copies.clear();
+            testee->const_target_view();
+            EXPECT_EQ(copied_to_target(), 1);
+        }
+
+        TEST(dirty_ranges, box) {
+            auto testee = storage::builder<separate_space>.type<double>().dimensions(10, 7, 5).halos(0, 0, 0)();
+            storage::dirty_ranges ranges;
+            ranges.add(testee->info(), {2, 3, 1}, {5, 5, 3});
+            auto &&strides = testee->strides();
+            std::vector<std::pair<int, int>> expected;
+            for (int k = 1; k < 3; ++k)
+                for (int j = 3; j < 5; ++j)
+                    expected.emplace_back(2 + j * strides[1] + k * strides[2], 5 + j * strides[1] + k * strides[2]);
+            std::vector<std::pair<int, int>> actual(ranges.begin(), ranges.end());
+            EXPECT_EQ(actual, expected);
+        }
+
+        TEST(dirty_ranges, batches) {
+            storage::dirty_ranges ranges;
+            for (int i = 0; i != 4; ++i) {
+                ranges.add(10 * i, 10 * i + 2);
+                ranges.add(10 * i + 7, 10 * i + 8);
+            }
+            ranges.add(100, 105);
+            std::vector<std::array<int, 4>> actual;
+            ranges.for_each_batch(
+                [&](int begin, int width, int count, int pitch) { actual.push_back({begin, width, count, pitch}); });
+            EXPECT_EQ(actual, (std::vector<std::array<int, 4>>{{0, 2, 4, 10}, {7, 1, 4, 10}, {100, 5, 1, 5}}));
+        }
+    } // namespace
+} // namespace gridtools
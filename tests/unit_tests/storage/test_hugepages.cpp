@@ -0,0 +1,53 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/storage/hugepages.hpp>
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_ifirst.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+
+namespace gridtools {
+    namespace {
+        struct prefaulted {
+            static hugepage_policy policy() { return {hugepage_mode::transparent, 0, hugepage_prefault::populate}; }
+        };
+
+        TEST(hugepages, layout) {
+            using traits_t = storage::hugepages<storage::cpu_kfirst, prefaulted>;
+            auto ds = storage::builder<traits_t>.type<double>().dimensions(30, 20, 10)();
+            auto ds_kfirst = storage::builder<storage::cpu_kfirst>.type<double>().dimensions(30, 20, 10)();
+            EXPECT_TRUE(ds->strides() == ds_kfirst->strides());
+            EXPECT_TRUE((std::is_same<decltype(ds->info()), decltype(ds_kfirst->info())>::value));
+        }
+
+        TEST(hugepages, policy) {
+            auto ds = storage::builder<storage::hugepages<storage::cpu_ifirst, prefaulted>>
+                          .type<double>()
+                          .dimensions(300, 200, 10)
+                          .value(1)();
+            auto usage = hugepage_usage(ds->get_target_ptr());
+            EXPECT_EQ(usage.mode, hugepage_mode::transparent);
+#ifdef __linux__
+            EXPECT_EQ(usage.resident_bytes, usage.bytes);
+#endif
+            EXPECT_EQ(ds->const_host_view()(299, 199, 9), 1);
+        }
+
+        TEST(hugepages, default_policy) {
+            auto ds = storage::builder<storage::hugepages<storage::cpu_kfirst>>.type<int>().dimensions(3, 4, 5)();
+            EXPECT_EQ(hugepage_usage(ds->get_target_ptr()).mode == hugepage_mode::disabled,
+                default_hugepage_policy().mode == hugepage_mode::disabled);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,86 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/tuple_util.hpp>
+#include <gridtools/sid/composite.hpp>
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/bundle.hpp>
+
+#include <storage_select.hpp>
+
+namespace gridtools {
+    namespace {
+        struct a;
+        struct b;
+
+        const auto builder = storage::builder<storage_traits_t>.type<double>().dimensions(10, 12, 5);
+
+        TEST(storage_bundle, layout) {
+            auto testee = builder.bundle<3>()();
+            EXPECT_EQ(testee->lengths(), (array<uint_t, 4>{10, 12, 5, 3}));
+            auto &&strides = testee->strides();
+            auto &&plain_strides = builder()->strides();
+            // the members are interleaved by the innermost rows
+            int innermost = 0;
+            for (int i = 1; i < 3; ++i)
+                if (plain_strides[i] < plain_strides[innermost])
+                    innermost = i;
+            EXPECT_EQ(strides[innermost], 1);
+            EXPECT_GE(strides[3], testee->lengths()[innermost]);
+            for (int i = 0; i < 3; ++i) {
+                if (i != innermost) {
+                    EXPECT_EQ(strides[i], plain_strides[i] * 3);
+                }
+            }
+        }
+
+        TEST(storage_bundle, members) {
+            auto testee = builder.bundle<3>().initializer([](int i, int j, int k, int n) {
+                return i + 100 * j + 10000 * k + 1000000 * n;
+            })();
+            auto members = storage::bundle_members(testee);
+            static_assert(tuple_util::size<decltype(members)>::value == 3, "");
+            tuple_util::for_each(
+                [&](auto const &member) {
+                    using member_t = std::decay_t<decltype(member)>;
+                    static_assert(is_sid<member_t>::value, "");
+                    static_assert(std::is_same<sid::strides_kind<member_t>, sid::strides_kind<decltype(testee)>>(), "");
+                },
+                members);
+
+            for (int n = 0; n < 3; ++n) {
+                auto member = storage::bundle_member(testee, n);
+                auto ptr = sid::get_origin(member)();
+                auto strides = sid::get_strides(member);
+                sid::shift(ptr, sid::get_stride<integral_constant<int, 0>>(strides), 7);
+                sid::shift(ptr, sid::get_stride<integral_constant<int, 1>>(strides), 3);
+                sid::shift(ptr, sid::get_stride<integral_constant<int, 2>>(strides), 4);
+                EXPECT_EQ(*ptr, 7 + 300 + 40000 + 1000000 * n);
+                *ptr = -n;
+                EXPECT_EQ(testee->const_host_view()(7, 3, 4, n), -n);
+            }
+        }
+
+        TEST(storage_bundle, composite) {
+            auto testee = builder.bundle<2>().value(1.)();
+            auto members = storage::bundle_members(testee);
+            auto composite = tuple_util::make<sid::composite::keys<a, b>::values>(
+                tuple_util::get<0>(members), tuple_util::get<1>(members));
+            auto single = tuple_util::make<sid::composite::keys<a>::values>(tuple_util::get<0>(members));
+            // one set of strides for both members
+            static_assert(
+                sizeof(sid::strides_type<decltype(composite)>) == sizeof(sid::strides_type<decltype(single)>), "");
+        }
+    } // namespace
+} // namespace gridtools
@@ -9,6 +9,8 @@
  */
 #include <gridtools/storage/info.hpp>
 
+#include <stdexcept>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -60,6 +62,32 @@ namespace gridtools {
                     EXPECT_LE(si.length(), 4 * 32);
                 }
             }
+            // the strides that are multiples of 1024 bytes alias
+            struct padding_1k {
+                static int_t pad_length(int_t length, size_t stride_bytes, int_t step) {
+                    while (length > 1 && length * stride_bytes % 1024 == 0)
+                        length += step;
+                    return length;
+                }
+            };
+
+            TEST(StorageInfo, StridesPadding) {
+                {
+                    auto si = make_info<layout_map<0, 1, 2>>(1_c, tu::make<tuple>(4, 32, 128), padding_1k(), 8);
+                    EXPECT_THAT(si.strides(), ElementsAre(129 * 32, 129, 1));
+                    EXPECT_THAT(si.lengths(), ElementsAre(4, 32, 128));
+                    EXPECT_EQ(si.length(), 3 * 129 * 32 + 31 * 129 + 128);
+                }
+                {
+                    auto si = make_info<layout_map<2, 0, 1>>(4_c, tu::make<tuple>(128, 4, 16), padding_1k(), 8);
+                    EXPECT_THAT(si.strides(), ElementsAre(1, 132 * 16, 132));
+                }
+                {
+                    auto si = make_info<layout_map<-1, 0, 1>>(1_c, tu::make<tuple>(3, 4, 128), padding_1k(), 8);
+                    EXPECT_THAT(si.strides(), ElementsAre(0, 129, 1));
+                }
+            }
+
             TEST(StorageInfo, IndexVariadic) {
                 {
                     auto si = make_info<layout_map<0, 1, 2>>(1_c, tu::make<tuple>(3, 4, 5));
@@ -182,6 +210,12 @@ namespace gridtools {
                     EXPECT_LE(x.length(), 32 * 10);
                 }
             }
+
+            TEST(StorageInfo, TooLarge) {
+                auto lengths = tu::make<tuple>(2048, 2048, 1024);
+                EXPECT_THROW((make_info<layout_map<0, 1, 2>>(1_c, lengths)), std::length_error);
+                EXPECT_NO_THROW((make_info<layout_map<-1, 0, 1>>(1_c, lengths)));
+            }
         } // namespace
     }     // namespace storage
 } // namespace gridtools
@@ -0,0 +1,92 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/bfloat16.hpp>
+#include <gridtools/common/tuple.hpp>
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/sid/convert.hpp>
+#include <gridtools/sid/simple_ptr_holder.hpp>
+#include <gridtools/sid/synthetic.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/sid.hpp>
+
+#include <storage_select.hpp>
+
+namespace gridtools {
+    namespace {
+        const auto sizes = storage::builder<storage_traits_t>.dimensions(4, 5, 6);
+        const auto builder = sizes.type<double>();
+
+        TEST(storage_mixed_precision, types) {
+            auto testee = builder.storage_type<float>()();
+            using testee_t = decltype(testee);
+            using data_store_t = typename testee_t::element_type;
+
+            static_assert(std::is_same<typename data_store_t::data_t, float>(), "");
+            static_assert(std::is_same<typename data_store_t::compute_t, double>(), "");
+            static_assert(is_sid<testee_t>(), "");
+            static_assert(std::is_same<sid::ptr_type<testee_t>, sid::converting_ptr<float, double>>(), "");
+            static_assert(std::is_same<sid::compute_type<testee_t>, double>(), "");
+            static_assert(std::is_same<sid::compute_type<decltype(builder())>, double>(), "");
+            static_assert(std::is_same<sid::storage_element_type<testee_t>, float>(), "");
+
+            EXPECT_EQ(sid::get_origin(testee)().m_ptr, testee->get_target_ptr());
+            EXPECT_TRUE(testee->strides() == sizes.type<float>()()->strides());
+        }
+
+        TEST(storage_mixed_precision, load_and_store) {
+            auto testee = builder.storage_type<float>().initializer([](int i, int j, int k) { return i + j + k; })();
+            auto ptr = sid::get_origin(testee)();
+            auto strides = sid::get_strides(testee);
+            sid::shift(ptr, sid::get_stride<integral_constant<int, 0>>(strides), 1);
+            sid::shift(ptr, sid::get_stride<integral_constant<int, 2>>(strides), 3);
+            double val = *ptr;
+            EXPECT_EQ(val, 4);
+            *ptr = 1. / 3;
+            *ptr += 1;
+            auto view = testee->const_host_view();
+            EXPECT_EQ(view(1, 0, 3), 1.f / 3 + 1);
+            EXPECT_EQ(view(1, 1, 3), 5.f);
+        }
+
+        TEST(storage_mixed_precision, bfloat16) {
+            auto testee = builder.storage_type<bfloat16>().value(1.5)();
+            auto ptr = sid::get_origin(testee)();
+            EXPECT_EQ(double(*ptr), 1.5);
+            *ptr = 1 + 1. / 512;
+            EXPECT_EQ(double(*ptr), 1);
+        }
+
+        TEST(storage_mixed_precision, read_only) {
+            auto testee = sizes.type<double const>().storage_type<float>().value(2)();
+            using testee_t = decltype(testee);
+            static_assert(std::is_same<sid::ptr_type<testee_t>, sid::converting_ptr<float const, double>>(), "");
+            static_assert(std::is_same<sid::reference_type<testee_t>, double>(), "");
+            EXPECT_EQ(*sid::get_origin(testee)(), 2);
+        }
+
+        TEST(storage_mixed_precision, convert) {
+            float data[3] = {1, 2, 3};
+            auto src = sid::synthetic()
+                           .set<sid::property::origin>(sid::host::make_simple_ptr_holder(&data[0]))
+                           .set<sid::property::strides>(tuple<int>(1))
+                           .set<sid::property::strides_kind, void>();
+            auto testee = sid::convert<double>(src);
+            static_assert(std::is_same<sid::ptr_type<decltype(testee)>, sid::converting_ptr<float, double>>(), "");
+            auto ptr = sid::get_origin(testee)();
+            sid::shift(ptr, sid::get_stride<integral_constant<int, 0>>(sid::get_strides(testee)), 2);
+            *ptr = *ptr * 2;
+            EXPECT_EQ(data[2], 6);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,51 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gtest/gtest.h>
+
+#include <gridtools/common/stride_padding.hpp>
+#include <gridtools/storage/builder.hpp>
+
+#include <storage_select.hpp>
+
+namespace gridtools {
+    namespace {
+        const auto builder = storage::builder<storage_traits_t>.type<double>();
+
+        TEST(storage_padding, power_of_two_sizes) {
+            if (!stride_padding::enabled())
+                GTEST_SKIP() << "GT_STRIDE_PADDING=disable";
+            for (int n : {128, 256}) {
+                auto ds = builder.dimensions(n, n, 80).padding()();
+                for (auto stride : ds->strides())
+                    EXPECT_FALSE(stride_padding::aliases(stride * sizeof(double))) << n;
+                auto unpadded = builder.dimensions(n, n, 80)();
+                EXPECT_TRUE(ds->lengths() == unpadded->lengths());
+                EXPECT_GE(ds->info().length(), unpadded->info().length());
+            }
+        }
+
+        TEST(storage_padding, odd_sizes_unchanged) {
+            auto ds = builder.dimensions(7, 9, 11).padding()();
+            auto unpadded = builder.dimensions(7, 9, 11)();
+            EXPECT_TRUE(ds->strides() == unpadded->strides());
+        }
+
+        TEST(storage_padding, values) {
+            auto ds = builder.dimensions(128, 64, 16).padding().initializer([](int i, int j, int k) {
+                return i + 1000 * j + 100000 * k;
+            })();
+            auto view = ds->const_host_view();
+            for (int i = 0; i < 128; ++i)
+                for (int j = 0; j < 64; ++j)
+                    for (int k = 0; k < 16; ++k)
+                        EXPECT_EQ(view(i, j, k), i + 1000 * j + 100000 * k);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,101 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/pool.hpp>
+
+#include <storage_select.hpp>
+
+namespace gridtools {
+    namespace {
+        const auto builder = storage::builder<storage_traits_t>.type<double>().dimensions(10, 11, 12);
+
+        TEST(storage_pool, reuse) {
+            storage::pool pool;
+            auto testee = builder.pool(pool);
+            auto ds = testee();
+            auto ptr = ds->get_target_ptr();
+            ds.reset();
+            EXPECT_EQ(pool.size(), 1);
+            ds = testee();
+            EXPECT_EQ(pool.size(), 0);
+            EXPECT_EQ(ds->get_target_ptr(), ptr);
+            auto other = testee();
+            EXPECT_NE(other->get_target_ptr(), ptr);
+        }
+
+        TEST(storage_pool, weak_ptr_to_released) {
+            storage::pool pool;
+            auto testee = builder.pool(pool);
+            std::weak_ptr<void> weak = testee();
+            EXPECT_TRUE(weak.expired());
+            {
+                // the previous control block is still alive
+                auto ds = testee();
+                EXPECT_EQ(pool.size(), 0);
+                std::weak_ptr<void> other = ds;
+                EXPECT_FALSE(other.expired());
+            }
+            weak.reset();
+            EXPECT_EQ(pool.size(), 1);
+            testee();
+            pool.clear();
+            EXPECT_EQ(pool.size(), 0);
+        }
+
+        TEST(storage_pool, keys) {
+            storage::pool pool;
+            builder.pool(pool)();
+            EXPECT_EQ(pool.size(), 1);
+            builder.pool(pool).name("foo")();
+            builder.pool(pool).halos(1, 1, 0)();
+            storage::builder<storage_traits_t>.type<float>().dimensions(10, 11, 12).pool(pool)();
+            storage::builder<storage_traits_t>.type<double>().dimensions(10, 11, 13).pool(pool)();
+            EXPECT_EQ(pool.size(), 5);
+            builder.pool(pool).name("foo")();
+            EXPECT_EQ(pool.size(), 5);
+        }
+
+        TEST(storage_pool, initialization) {
+            storage::pool pool;
+            auto ptr = builder.pool(pool).value(1)()->get_target_ptr();
+            {
+                auto ds = builder.pool(pool)();
+                ASSERT_EQ(ds->get_target_ptr(), ptr);
+                // uninitialized data store keeps the values
+                EXPECT_EQ(ds->const_host_view()(1, 2, 3), 1);
+                ds->host_view()(1, 2, 3) = 2;
+            }
+            auto ds = builder.pool(pool).initializer([](int i, int j, int k) { return i + j + k; })();
+            ASSERT_EQ(ds->get_target_ptr(), ptr);
+            EXPECT_EQ(ds->const_host_view()(1, 2, 3), 6);
+        }
+
+        TEST(storage_pool, clear) {
+            storage::pool pool;
+            builder.pool(pool)();
+            builder.pool(pool).name("foo")();
+            EXPECT_EQ(pool.size(), 2);
+            pool.clear();
+            EXPECT_EQ(pool.size(), 0);
+        }
+
+        TEST(storage_pool, outlives_pool) {
+            auto ds = [] {
+                storage::pool pool;
+                return builder.pool(pool).value(3)();
+            }();
+            EXPECT_EQ(ds->const_host_view()(0, 0, 0), 3);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,93 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/snapshot.hpp>
+
+#include <storage_select.hpp>
+
+namespace gridtools {
+    namespace {
+        const auto builder = storage::builder<storage_traits_t>.type<double>().dimensions(40, 30, 20);
+
+        double in(int i, int j, int k) { return i + 100 * j + 10000 * k; }
+
+        TEST(storage_snapshot, unchanged) {
+            auto ds = builder.initializer(in)();
+            auto testee = storage::snapshot(ds);
+            for (int i = 0; i < 40; ++i)
+                for (int j = 0; j < 30; ++j)
+                    for (int k = 0; k < 20; ++k)
+                        EXPECT_EQ(testee(i, j, k), in(i, j, k));
+        }
+
+        TEST(storage_snapshot, write_after_snapshot) {
+            auto ds = builder.initializer(in)();
+            auto testee = storage::snapshot(ds);
+            auto view = ds->host_view();
+            view(1, 2, 3) = -1;
+            view(39, 29, 19) = -1;
+            EXPECT_EQ(ds->const_host_view()(1, 2, 3), -1);
+            EXPECT_EQ(testee(1, 2, 3), in(1, 2, 3));
+            EXPECT_EQ(testee(39, 29, 19), in(39, 29, 19));
+            auto next = storage::snapshot(ds);
+            EXPECT_EQ(next(1, 2, 3), -1);
+        }
+
+        TEST(storage_snapshot, box) {
+            auto ds = builder.initializer(in)();
+            auto testee = storage::snapshot(ds);
+            auto view = ds->host_view({0, 0, 5}, {40, 30, 6});
+            for (int i = 0; i < 40; ++i)
+                for (int j = 0; j < 30; ++j)
+                    view(i, j, 5) = -1;
+            for (int i = 0; i < 40; ++i)
+                for (int j = 0; j < 30; ++j)
+                    for (int k = 0; k < 20; ++k)
+                        EXPECT_EQ(testee(i, j, k), in(i, j, k));
+        }
+
+        TEST(storage_snapshot, for_each_block) {
+            auto ds = builder.initializer(in)();
+            auto testee = storage::snapshot(ds);
+            std::vector<double> expected(ds->get_const_host_ptr(), ds->get_const_host_ptr() + ds->length());
+            ds->host_view()(3, 2, 1) = -1;
+            std::vector<double> actual(ds->length());
+            testee.for_each_block([&](size_t offset, double const *ptr, size_t size) {
+                std::copy(ptr, ptr + size, actual.begin() + offset);
+            });
+            EXPECT_EQ(actual, expected);
+        }
+
+        TEST(storage_snapshot, background_reader) {
+            auto ds = builder.initializer(in)();
+            auto testee = storage::snapshot(ds);
+            bool ok = true;
+            std::thread reader([&] {
+                for (int i = 0; i < 40; ++i)
+                    for (int j = 0; j < 30; ++j)
+                        for (int k = 0; k < 20; ++k)
+                            ok = ok && testee(i, j, k) == in(i, j, k);
+            });
+            for (int k = 0; k < 20; ++k) {
+                auto view = ds->host_view({0, 0, k}, {40, 30, k + 1});
+                for (int i = 0; i < 40; ++i)
+                    for (int j = 0; j < 30; ++j)
+                        view(i, j, k) = -1;
+            }
+            reader.join();
+            EXPECT_TRUE(ok);
+        }
+    } // namespace
+} // namespace gridtools
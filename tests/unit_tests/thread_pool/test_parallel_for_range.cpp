@@ -0,0 +1,104 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/thread_pool/concept.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/thread_pool/omp.hpp>
+
+namespace gridtools {
+    namespace thread_pool {
+        namespace {
+            struct serial {
+                friend int thread_pool_get_thread_num(serial) { return 0; }
+                friend int thread_pool_get_max_threads(serial) { return 1; }
+
+                template <class F>
+                friend void thread_pool_parallel_for_loop(serial, F const &f, int lim) {
+                    for (int i = 0; i < lim; ++i)
+                        f(i);
+                }
+            };
+
+            template <class Pool>
+            struct parallel_for_range_test : testing::Test {};
+
+#if defined(_OPENMP)
+            using pools_t = testing::Types<serial, omp>;
+#else
+            using pools_t = testing::Types<serial>;
+#endif
+            TYPED_TEST_SUITE(parallel_for_range_test, pools_t);
+
+            TYPED_TEST(parallel_for_range_test, one_dimensional) {
+                std::vector<std::atomic<int>> hits(10);
+                std::atomic<int> calls(0);
+                parallel_for_range(
+                    TypeParam(),
+                    [&](int begin, int end) {
+                        EXPECT_LE(end - begin, 3);
+                        EXPECT_LT(begin, end);
+                        for (int i = begin; i < end; ++i)
+                            ++hits[i];
+                        ++calls;
+                    },
+                    3,
+                    10);
+                for (auto &&hit : hits)
+                    EXPECT_EQ(hit, 1);
+                EXPECT_EQ(calls, 4);
+            }
+
+            TYPED_TEST(parallel_for_range_test, multi_dimensional) {
+                const int ni = 7, nj = 3, nk = 2, nl = 2;
+                std::vector<std::atomic<int>> hits(ni * nj * nk * nl);
+                parallel_for_range(
+                    TypeParam(),
+                    [&](int begin, int end, int j, int k, int l) {
+                        EXPECT_LE(end - begin, 4);
+                        for (int i = begin; i < end; ++i)
+                            ++hits[((l * nk + k) * nj + j) * ni + i];
+                    },
+                    4,
+                    ni,
+                    nj,
+                    nk,
+                    nl);
+                for (auto &&hit : hits)
+                    EXPECT_EQ(hit, 1);
+
+                std::vector<std::atomic<int>> hits3(ni * nj * nk);
+                parallel_for_range(
+                    TypeParam(),
+                    [&](int begin, int end, int j, int k) {
+                        for (int i = begin; i < end; ++i)
+                            ++hits3[(k * nj + j) * ni + i];
+                    },
+                    4,
+                    ni,
+                    nj,
+                    nk);
+                for (auto &&hit : hits3)
+                    EXPECT_EQ(hit, 1);
+            }
+
+            TYPED_TEST(parallel_for_range_test, zero_grain) {
+                std::atomic<int> calls(0);
+                parallel_for_range(
+                    TypeParam(), [&](int begin, int end, int) { calls += end - begin == 1; }, 0, 5, 2);
+                EXPECT_EQ(calls, 10);
+            }
+        } // namespace
+    }     // namespace thread_pool
+} // namespace gridtools
@@ -0,0 +1,113 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/thread_pool/partition.hpp>
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/thread_pool/concept.hpp>
+#include <gridtools/thread_pool/omp.hpp>
+
+namespace gridtools {
+    namespace thread_pool {
+        namespace {
+            TEST(partition, cores) {
+                auto p = partition::cores(4, 3);
+                EXPECT_EQ(p.threads(), 3);
+                EXPECT_EQ(p.cores(), (std::vector<int>{4, 5, 6}));
+                EXPECT_TRUE(partition(2).cores().empty());
+            }
+
+#if defined(_OPENMP)
+            std::set<int> used_threads(int n) {
+                std::mutex mutex;
+                std::set<int> res;
+                parallel_for_loop(
+                    omp(),
+                    [&](int) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        res.insert(get_thread_num(omp()));
+                    },
+                    n);
+                return res;
+            }
+
+            TEST(partition, max_threads) {
+                int full = get_max_threads(omp());
+                {
+                    scoped_partition scope(partition(1));
+                    EXPECT_EQ(get_max_threads(omp()), 1);
+                    EXPECT_EQ(used_threads(100), std::set<int>{0});
+                }
+                EXPECT_EQ(get_max_threads(omp()), full);
+            }
+
+            TEST(partition, per_host_thread) {
+                int full = get_max_threads(omp());
+                int max_threads[2];
+                std::thread threads[2];
+                for (int i = 0; i != 2; ++i)
+                    threads[i] = std::thread([&max_threads, i] {
+                        scoped_partition scope(partition(i + 1));
+                        max_threads[i] = get_max_threads(omp());
+                        EXPECT_LE(used_threads(100).size(), size_t(i + 1));
+                    });
+                for (auto &&thread : threads)
+                    thread.join();
+                EXPECT_EQ(max_threads[0], 1);
+                EXPECT_EQ(max_threads[1], 2);
+                EXPECT_EQ(get_max_threads(omp()), full);
+            }
+
+#if defined(__linux__)
+            TEST(partition, pinning) {
+                cpu_set_t allowed;
+                ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &allowed), 0);
+                int core = 0;
+                while (!CPU_ISSET(core, &allowed))
+                    ++core;
+                {
+                    scoped_partition scope(partition::cores(core, 1));
+                    parallel_for_loop(
+                        omp(), [&](int) { EXPECT_EQ(sched_getcpu(), core); }, 10);
+                    // the threads stay pinned between the regions of the partition
+                    cpu_set_t between;
+                    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &between), 0);
+                    EXPECT_EQ(CPU_COUNT(&between), 1);
+                    EXPECT_TRUE(CPU_ISSET(core, &between));
+                    parallel_for_range(
+                        omp(), [&](int, int) { EXPECT_EQ(sched_getcpu(), core); }, 1, 10);
+                }
+                cpu_set_t restored;
+                ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &restored), 0);
+                EXPECT_TRUE(CPU_EQUAL(&allowed, &restored));
+                // the region out of the partition restores the affinity of the team
+                std::mutex mutex;
+                bool unpinned = true;
+                parallel_for_loop(
+                    omp(),
+                    [&](int) {
+                        cpu_set_t mask;
+                        ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &mask), 0);
+                        std::lock_guard<std::mutex> lock(mutex);
+                        unpinned = unpinned && CPU_EQUAL(&allowed, &mask);
+                    },
+                    100);
+                EXPECT_TRUE(unpinned);
+            }
+#endif
+#endif
+        } // namespace
+    }     // namespace thread_pool
+} // namespace gridtools
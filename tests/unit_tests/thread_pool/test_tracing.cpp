@@ -0,0 +1,138 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2021, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/thread_pool/tracing.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/thread_pool/omp.hpp>
+
+namespace gridtools {
+    namespace thread_pool {
+        namespace {
+            struct serial {
+                friend int thread_pool_get_thread_num(serial) { return 0; }
+                friend int thread_pool_get_max_threads(serial) { return 1; }
+
+                template <class F>
+                friend void thread_pool_parallel_for_loop(serial, F const &f, int lim) {
+                    for (int i = 0; i < lim; ++i)
+                        f(i);
+                }
+            };
+
+            size_t count(std::string const &src, std::string const &pattern) {
+                size_t res = 0;
+                for (auto pos = src.find(pattern); pos != std::string::npos; pos = src.find(pattern, pos + 1))
+                    ++res;
+                return res;
+            }
+
+            template <class Pool>
+            std::string dump() {
+                std::ostringstream strm;
+                Pool::dump(strm);
+                return strm.str();
+            }
+
+            TEST(tracing, forwards_and_records) {
+                using testee_t = tracing<serial>;
+                testee_t::clear();
+                int sum = 0;
+                parallel_for_loop(testee_t(), [&](int i, int j) { sum += i + 10 * j; }, 3, 2);
+                EXPECT_EQ(sum, 0 + 1 + 2 + 10 + 11 + 12);
+                EXPECT_EQ(get_max_threads(testee_t()), 1);
+                EXPECT_EQ(get_thread_num(testee_t()), 0);
+
+                auto trace = dump<testee_t>();
+                EXPECT_EQ(trace.find("{\"traceEvents\":["), 0);
+                EXPECT_EQ(count(trace, "\"name\":\"block\""), 6);
+                EXPECT_EQ(count(trace, "\"name\":\"parallel_for_loop\""), 1);
+                EXPECT_EQ(count(trace, "\"args\":{\"0\":2,\"1\":1,\"worker\":0}"), 1);
+                EXPECT_EQ(count(trace, "\"args\":{\"0\":3,\"1\":2,\"worker\":0}"), 1);
+
+                testee_t::clear();
+                EXPECT_EQ(count(dump<testee_t>(), "\"ph\":\"X\""), 0);
+            }
+
+            TEST(tracing, ring_buffer_keeps_the_latest_events) {
+                using testee_t = tracing<serial, 4>;
+                testee_t::clear();
+                parallel_for_loop(testee_t(), [](int) {}, 10);
+                auto trace = dump<testee_t>();
+                EXPECT_EQ(count(trace, "\"ph\":\"X\""), 4);
+                EXPECT_EQ(count(trace, "\"name\":\"parallel_for_loop\""), 1);
+                EXPECT_EQ(count(trace, "\"args\":{\"0\":9,\"worker\":0}"), 1);
+                EXPECT_EQ(count(trace, "\"args\":{\"0\":6,\"worker\":0}"), 0);
+            }
+
+            TEST(tracing, range) {
+                using testee_t = tracing<serial>;
+                testee_t::clear();
+                int sum = 0;
+                parallel_for_range(
+                    testee_t(),
+                    [&](int begin, int end, int j) {
+                        for (int i = begin; i < end; ++i)
+                            sum += i + 10 * j;
+                    },
+                    4,
+                    10,
+                    2);
+                EXPECT_EQ(sum, 2 * 45 + 10 * 10);
+
+                auto trace = dump<testee_t>();
+                EXPECT_EQ(count(trace, "\"name\":\"block\""), 6);
+                EXPECT_EQ(count(trace, "\"name\":\"parallel_for_range\""), 1);
+                EXPECT_EQ(count(trace, "\"args\":{\"0\":8,\"1\":10,\"2\":1,\"worker\":0}"), 1);
+                EXPECT_EQ(count(trace, "\"args\":{\"0\":10,\"1\":2,\"worker\":0}"), 1);
+            }
+
+            char const *scope_name() { return "my_scope"; }
+
+            TEST(tracing, scope) {
+                using testee_t = tracing<serial>;
+                testee_t::clear();
+                int calls = 0;
+                parallel_for_loop(testee_t(), [&](int) { scope(testee_t(), &scope_name, [&] { ++calls; }); }, 3);
+                EXPECT_EQ(calls, 3);
+                EXPECT_EQ(count(dump<testee_t>(), "\"name\":\"my_scope\""), 3);
+
+                calls = 0;
+                scope(serial(), &scope_name, [&] { ++calls; });
+                EXPECT_EQ(calls, 1);
+            }
+
+            TEST(tracing, host_threads_get_separate_timelines) {
+                using testee_t = tracing<serial>;
+                testee_t::clear();
+                parallel_for_loop(testee_t(), [](int) {}, 1);
+                std::thread([] { parallel_for_loop(testee_t(), [](int) {}, 1); }).join();
+                auto trace = dump<testee_t>();
+                EXPECT_EQ(count(trace, "\"name\":\"parallel_for_loop\""), 2);
+                EXPECT_EQ(count(trace, "\"tid\":0,"), 2);
+                EXPECT_EQ(count(trace, "\"tid\":1,"), 2);
+            }
+
+#if defined(_OPENMP)
+            TEST(tracing, omp) {
+                using testee_t = tracing<omp>;
+                testee_t::clear();
+                parallel_for_loop(testee_t(), [](int, int, int) {}, 4, 3, 2);
+                EXPECT_EQ(count(dump<testee_t>(), "\"name\":\"block\""), 24);
+            }
+#endif
+        } // namespace
+    }     // namespace thread_pool
+} // namespace gridtools